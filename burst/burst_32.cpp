@@ -6,11 +6,12 @@
  * Use of this software in life-critical applications or systems is strictly prohibited.
  */
 
-extern "C" void burst_32(const int* in, int* out, const int size, const int burst_length) {
-#pragma HLS INTERFACE m_axi port=in offset=slave bundle=gmem0 max_read_burst_length=burst_length
-#pragma HLS INTERFACE m_axi port=out offset=slave bundle=gmem1 max_write_burst_length=burst_length
+#include "burst_length.h"
+
+extern "C" void burst_32(const int* in, int* out, const int size) {
+#pragma HLS INTERFACE m_axi port=in offset=slave bundle=gmem0 max_read_burst_length=BURST_LENGTH
+#pragma HLS INTERFACE m_axi port=out offset=slave bundle=gmem1 max_write_burst_length=BURST_LENGTH
 #pragma HLS INTERFACE s_axilite port=size
-#pragma HLS INTERFACE s_axilite port=burst_length
 #pragma HLS INTERFACE s_axilite port=return
 #pragma HLS DATAFLOW
 
@@ -8,11 +8,12 @@
 
 #include "ap_int.h"
 
-extern "C" void burst_512(const ap_int<512>* in, ap_int<512>* out, const int size, const int burst_length) {
-#pragma HLS INTERFACE m_axi port=in offset=slave bundle=gmem0 max_read_burst_length=burst_length
-#pragma HLS INTERFACE m_axi port=out offset=slave bundle=gmem1 max_write_burst_length=burst_length
+#include "burst_length.h"
+
+extern "C" void burst_512(const ap_int<512>* in, ap_int<512>* out, const int size) {
+#pragma HLS INTERFACE m_axi port=in offset=slave bundle=gmem0 max_read_burst_length=BURST_LENGTH
+#pragma HLS INTERFACE m_axi port=out offset=slave bundle=gmem1 max_write_burst_length=BURST_LENGTH
 #pragma HLS INTERFACE s_axilite port=size
-#pragma HLS INTERFACE s_axilite port=burst_length
 #pragma HLS INTERFACE s_axilite port=return
 #pragma HLS DATAFLOW
 
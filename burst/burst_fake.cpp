@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "ap_int.h"
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装 (ビット幅ごと)
+extern "C" {
+void burst_32(const int* in, int* out, const int size);
+void burst_64(const long long* in, long long* out, const int size);
+void burst_128(const ap_int<128>* in, ap_int<128>* out, const int size);
+void burst_256(const ap_int<256>* in, ap_int<256>* out, const int size);
+void burst_512(const ap_int<512>* in, ap_int<512>* out, const int size);
+void burst_1024(const ap_int<1024>* in, ap_int<1024>* out, const int size);
+}
+
+static xrt_fake::kernel_registrar register_burst_32("burst_32", burst_32);
+static xrt_fake::kernel_registrar register_burst_64("burst_64", burst_64);
+static xrt_fake::kernel_registrar register_burst_128("burst_128", burst_128);
+static xrt_fake::kernel_registrar register_burst_256("burst_256", burst_256);
+static xrt_fake::kernel_registrar register_burst_512("burst_512", burst_512);
+static xrt_fake::kernel_registrar register_burst_1024("burst_1024", burst_1024);
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_kernel.h>
+
+#include "bandwidth_model.h"
+#include "bench_stats.h"
+#include "mapped_bo.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
+
+// burst_<W> カーネル (in[i] + 1 を out[i] へ書く) のビット幅・バースト長の掃引。
+// 最大バースト長は合成時に決まるため、バースト長ごとに全ビット幅のカーネルをまとめたxclbin
+// (<xclbin_prefix>_b<L>.xclbin、burst_length.h) を順に読み込み、その中の全ビット幅を計測する。
+// ホスト側は1ビートをWビットのバイト列として扱うため、ap_int.hに依存しない。
+// ap_int<W> のメモリ上の表現はリトルエンディアンの整数なので、+1は下位バイトからの繰り上がりで検証できる。
+
+template <int W>
+struct BurstBeat {
+    unsigned char bytes[W / 8];
+};
+
+struct BurstConfig {
+    size_t bytes = 16 * 1024 * 1024;  // 1回の実行で読み書きするバイト数 (各方向)
+    int warmup = 3;                   // 計測しない実行回数
+    int iterations = 20;              // 計測する実行回数
+    std::vector<int> burst_lengths = {64, 128, 256};  // Makefileの BURST_LENGTHS と合わせる
+    std::string xclbin_prefix = "burst";
+
+    std::string xclbin_path(int burst_length) const {
+        return xclbin_prefix + "_b" + std::to_string(burst_length) + ".xclbin";
+    }
+};
+
+struct BurstResult {
+    int width = 0;
+    int burst_length = 0;
+    size_t beats = 0;
+    size_t bytes = 0;  // 1回の実行で読んだバイト数 (= 書いたバイト数)
+    BenchStats time_ms;
+    std::vector<double> samples_ms;  // 計測した各実行の時間
+    bool verified = false;
+
+    // 1ビートでWビットを読み、Wビットを書く
+    KernelTraffic traffic() const {
+        KernelTraffic t;
+        t.beats = beats;
+        t.read_bytes_per_beat = width / 8;
+        t.write_bytes_per_beat = width / 8;
+        return t;
+    }
+
+    // 中央値の実行時間での帯域とピークとの比較
+    BandwidthReport report(const BandwidthPeaks& peaks) const {
+        return bandwidth_report(traffic(), time_ms.median / 1000.0, peaks);
+    }
+};
+
+// リトルエンディアンのWビット整数として+1する
+template <int W>
+inline BurstBeat<W> burst_beat_plus_one(const BurstBeat<W>& beat) {
+    BurstBeat<W> result = beat;
+    for (size_t i = 0; i < sizeof(result.bytes); ++i) {
+        if (++result.bytes[i] != 0) {
+            break;
+        }
+    }
+    return result;
+}
+
+// 入力パターン。8ビート目ごとに下位64ビットを全て1にして、ワードをまたぐ繰り上がりも検証する。
+template <int W>
+inline void burst_fill(BurstBeat<W>* beats, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t b = 0; b < sizeof(beats[i].bytes); ++b) {
+            beats[i].bytes[b] = static_cast<unsigned char>(i * 31 + b * 7);
+        }
+        if (i % 8 == 7) {
+            std::memset(beats[i].bytes, 0xff, sizeof(beats[i].bytes) < 8 ? sizeof(beats[i].bytes) : 8);
+        }
+    }
+}
+
+// 1つのビット幅を計測する。burst_lengthはkernelを合成したときのバースト長 (記録用)。
+template <int W>
+BurstResult run_burst(xrt::kernel& kernel, MappedBo<BurstBeat<W>>& in, MappedBo<BurstBeat<W>>& out,
+                      int burst_length, const BurstConfig& config) {
+    BurstResult result;
+    result.width = W;
+    result.burst_length = burst_length;
+    result.beats = in.size();
+    result.bytes = in.bytes();
+
+    std::memset(out.data(), 0, out.bytes());
+    out.to_device();
+
+    ReusableRun launch(kernel);
+    const int beats = static_cast<int>(in.size());
+    for (int i = 0; i < config.warmup; ++i) {
+        launch(in.bo(), out.bo(), beats).wait();
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < config.iterations; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        launch(in.bo(), out.bo(), beats).wait();
+        auto end = std::chrono::high_resolution_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    result.time_ms = bench_summarize(samples);
+    result.samples_ms = samples;
+
+    out.from_device();
+    result.verified = true;
+    for (size_t i = 0; i < in.size(); ++i) {
+        BurstBeat<W> expected = burst_beat_plus_one(in.data()[i]);
+        if (std::memcmp(expected.bytes, out.data()[i].bytes, sizeof(expected.bytes)) != 0) {
+            result.verified = false;
+            break;
+        }
+    }
+    return result;
+}
+
+// contextのxclbin (バースト長burst_length) のビット幅Wを計測し、resultsへ追加する
+template <int W>
+void run_burst_width(XrtContext& context, int burst_length, const BurstConfig& config,
+                     std::vector<BurstResult>& results) {
+    xrt::kernel kernel = context.kernel("burst_" + std::to_string(W));
+    const size_t beats = config.bytes / sizeof(BurstBeat<W>);
+    MappedBo<BurstBeat<W>> in(context.device(), beats, kernel.group_id(0));
+    MappedBo<BurstBeat<W>> out(context.device(), beats, kernel.group_id(1));
+    burst_fill(in.data(), beats);
+    in.to_device();
+
+    results.push_back(run_burst<W>(kernel, in, out, burst_length, config));
+}
+
+// 全バースト長・全ビット幅 (32〜1024) を1プロセスで順に計測する。
+// xclbinの書き込みはバースト長ごとに1回で、各xclbinにはburst_32〜burst_1024の全カーネルが含まれている必要がある。
+inline std::vector<BurstResult> run_burst_sweep(const BurstConfig& config, unsigned int device_index = 0) {
+    std::vector<BurstResult> results;
+    for (int burst_length : config.burst_lengths) {
+        auto context = XrtContext::get(config.xclbin_path(burst_length), device_index);
+        run_burst_width<32>(*context, burst_length, config, results);
+        run_burst_width<64>(*context, burst_length, config, results);
+        run_burst_width<128>(*context, burst_length, config, results);
+        run_burst_width<256>(*context, burst_length, config, results);
+        run_burst_width<512>(*context, burst_length, config, results);
+        run_burst_width<1024>(*context, burst_length, config, results);
+    }
+    return results;
+}
+
+inline void print_burst_results(const std::vector<BurstResult>& results) {
+    printf("%6s %6s %10s %10s %10s %10s %10s %6s\n",
+           "width", "burst", "beats", "min ms", "median ms", "p99 ms", "stddev ms", "check");
+    for (const BurstResult& r : results) {
+        printf("%6d %6d %10zu %10.4f %10.4f %10.4f %10.4f %6s\n",
+               r.width, r.burst_length, r.beats, r.time_ms.min, r.time_ms.median, r.time_ms.p99, r.time_ms.stddev,
+               r.verified ? "ok" : "FAIL");
+    }
+}
+
+// 中央値の実行時間での読み・書き帯域 (10進MB/s) と、ポート上限・DDR・PCIeのピークとの比 (ルーフライン)
+inline void print_burst_roofline(const std::vector<BurstResult>& results, const BandwidthPeaks& peaks) {
+    printf("peaks: DDR %.0f MB/s x %d bank(s), PCIe %.0f MB/s, kernel %.0f MHz\n",
+           peaks.ddr_mb_s, peaks.ddr_banks, peaks.pcie_mb_s, peaks.kernel_mhz);
+    printf("%6s %6s %10s %10s %10s %10s %10s %7s %7s %7s %6s\n",
+           "width", "burst", "read MB/s", "write MB/s", "total MB/s", "port MB/s", "roof MB/s",
+           "%DDR", "%PCIe", "%roof", "bound");
+    for (const BurstResult& r : results) {
+        BandwidthReport b = r.report(peaks);
+        printf("%6d %6d %10.1f %10.1f %10.1f %10.1f %10.1f %7.1f %7.1f %7.1f %6s\n",
+               r.width, r.burst_length, b.read_mb_s, b.write_mb_s, b.total_mb_s, b.port_mb_s, b.roof_mb_s,
+               b.ddr_ratio * 100, b.pcie_ratio * 100, b.roof_ratio * 100, b.port_bound ? "port" : "DDR");
+    }
+}
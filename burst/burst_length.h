@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+// m_axiの最大バースト長 (ビート数)。max_read_burst_length / max_write_burst_length は合成時に決まるため、
+// Makefileはバースト長ごとに -D BURST_LENGTH=<L> で全ビット幅のカーネルを合成し、burst_b<L>.xclbin にまとめる。
+#ifndef BURST_LENGTH
+#define BURST_LENGTH 256
+#endif
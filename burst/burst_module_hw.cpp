@@ -11,40 +11,58 @@
 #include <iostream>
 #include "ap_int.h"
 
+#include "bo_array.h"
+#include "phase_timer_py.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
+
 namespace py = pybind11;
 
 template<typename T>
 class BurstTestRunner {
 public:
-    BurstTestRunner(const std::string& xclbin_path, const std::string& kernel_name) {
-        device_ = xrt::device(0); 
-        auto uuid = device_.load_xclbin(xclbin_path);
-        krnl_ = xrt::kernel(device_, uuid, kernel_name);
-    }
+    BurstTestRunner(const std::string& xclbin_path, const std::string& kernel_name)
+        : context_(XrtContext::get(xclbin_path)), device_(context_->device()), krnl_(context_->kernel(kernel_name)),
+          launch_(krnl_) {}
 
-    std::vector<T> run(const std::vector<T>& input, int size, int burst_length) {
+    std::vector<T> run(const std::vector<T>& input, int size) {
         if (input.size() < size) {
             throw std::runtime_error("Input vector size is smaller than specified size.");
         }
 
+        PhaseTimer::Scope total(phases_, Phase::total);
         auto start_total = std::chrono::high_resolution_clock::now();
 
+        PhaseTimer::Scope alloc(phases_, Phase::alloc);
         auto bo_in = xrt::bo(device_, size * sizeof(T), krnl_.group_id(0));
         auto bo_out = xrt::bo(device_, size * sizeof(T), krnl_.group_id(1));
+        alloc.stop();
 
+        PhaseTimer::Scope write(phases_, Phase::write);
         bo_in.write(input.data());
+        write.stop();
+        PhaseTimer::Scope h2d(phases_, Phase::sync_to_device);
         bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        h2d.stop();
 
         auto start_kernel = std::chrono::high_resolution_clock::now();
-        auto kernel_run = krnl_(bo_in, bo_out, size, burst_length);
+        PhaseTimer::Scope launch(phases_, Phase::launch);
+        auto& kernel_run = launch_(bo_in, bo_out, size);
+        launch.stop();
+        PhaseTimer::Scope wait(phases_, Phase::wait);
         kernel_run.wait();
+        wait.stop();
         auto end_kernel = std::chrono::high_resolution_clock::now();
 
         kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
 
+        PhaseTimer::Scope d2h(phases_, Phase::sync_from_device);
         bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        d2h.stop();
+        PhaseTimer::Scope read(phases_, Phase::read);
         std::vector<T> result(size);
         bo_out.read(result.data());
+        read.stop();
 
         auto end_total = std::chrono::high_resolution_clock::now();
         total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
@@ -52,6 +70,45 @@ public:
         return result;
     }
 
+    void allocate_mapped(int size) {
+        mapped_in_ = std::make_shared<MappedBo<T>>(device_, size, krnl_.group_id(0));
+        mapped_out_ = std::make_shared<MappedBo<T>>(device_, size, krnl_.group_id(1));
+    }
+
+    void run_mapped() {
+        if (!mapped_in_) {
+            throw std::runtime_error("Mapped buffers are not allocated.");
+        }
+
+        PhaseTimer::Scope total(phases_, Phase::total);
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope h2d(phases_, Phase::sync_to_device);
+        mapped_in_->to_device();
+        h2d.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(phases_, Phase::launch);
+        auto& kernel_run = launch_(mapped_in_->bo(), mapped_out_->bo(), static_cast<int>(mapped_in_->size()));
+        launch.stop();
+        PhaseTimer::Scope wait(phases_, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(phases_, Phase::sync_from_device);
+        mapped_out_->from_device();
+        d2h.stop();
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    const std::shared_ptr<MappedBo<T>>& mapped_in() const { return mapped_in_; }
+    const std::shared_ptr<MappedBo<T>>& mapped_out() const { return mapped_out_; }
+
     double get_kernel_execution_time_ms() const {
         return kernel_execution_time_ms_;
     }
@@ -60,9 +117,17 @@ public:
         return total_execution_time_ms_;
     }
 
+    PhaseTimer& phases() { return phases_; }
+    const PhaseTimer& phases() const { return phases_; }
+
 private:
+    std::shared_ptr<XrtContext> context_;
     xrt::device device_;
     xrt::kernel krnl_;
+    ReusableRun launch_; // 同期実行の経路で使い回すrun
+    std::shared_ptr<MappedBo<T>> mapped_in_;
+    std::shared_ptr<MappedBo<T>> mapped_out_;
+    PhaseTimer phases_;
     double kernel_execution_time_ms_ = 0.0;
     double total_execution_time_ms_ = 0.0;
 };
@@ -72,8 +137,7 @@ public:
     PyBurstTestRunner32(const std::string& xclbin_path) 
         : runner_(xclbin_path, "burst_32") {}
 
-    py::array_t<int> run(py::array_t<int, py::array::c_style | py::array::forcecast> input, 
-                          int burst_length) {
+    py::array_t<int> run(py::array_t<int, py::array::c_style | py::array::forcecast> input) {
         if (input.ndim() != 1) {
             throw std::runtime_error("Input must be a 1-dimensional array.");
         }
@@ -81,14 +145,25 @@ public:
         int size = input.size();
         std::vector<int> vec_in(input.data(), input.data() + size);
         
-        std::vector<int> result = runner_.run(vec_in, size, burst_length);
+        std::vector<int> result = runner_.run(vec_in, size);
         
+        PhaseTimer::Scope numpy(runner_.phases(), Phase::to_numpy);
         auto output = py::array_t<int>(size);
         std::memcpy(output.mutable_data(), result.data(), size * sizeof(int));
         
         return output;
     }
 
+    py::array_t<int> alloc_input(int size) {
+        runner_.allocate_mapped(size);
+        return bo_array(runner_.mapped_in(), {size});
+    }
+
+    py::array_t<int> run_mapped() {
+        runner_.run_mapped();
+        return bo_array(runner_.mapped_out(), {static_cast<py::ssize_t>(runner_.mapped_out()->size())});
+    }
+
     double get_kernel_execution_time_ms() const {
         return runner_.get_kernel_execution_time_ms();
     }
@@ -97,6 +172,18 @@ public:
         return runner_.get_total_execution_time_ms();
     }
 
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(runner_.phases());
+    }
+
+    void reset_phase_stats() {
+        runner_.phases().reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        runner_.phases().set_enabled(enabled);
+    }
+
 private:
     BurstTestRunner<int> runner_;
 };
@@ -106,8 +193,7 @@ public:
     PyBurstTestRunner64(const std::string& xclbin_path) 
         : runner_(xclbin_path, "burst_64") {}
 
-    py::array_t<long long> run(py::array_t<long long, py::array::c_style | py::array::forcecast> input, 
-                                int burst_length) {
+    py::array_t<long long> run(py::array_t<long long, py::array::c_style | py::array::forcecast> input) {
         if (input.ndim() != 1) {
             throw std::runtime_error("Input must be a 1-dimensional array.");
         }
@@ -115,14 +201,25 @@ public:
         int size = input.size();
         std::vector<long long> vec_in(input.data(), input.data() + size);
         
-        std::vector<long long> result = runner_.run(vec_in, size, burst_length);
+        std::vector<long long> result = runner_.run(vec_in, size);
         
+        PhaseTimer::Scope numpy(runner_.phases(), Phase::to_numpy);
         auto output = py::array_t<long long>(size);
         std::memcpy(output.mutable_data(), result.data(), size * sizeof(long long));
         
         return output;
     }
 
+    py::array_t<long long> alloc_input(int size) {
+        runner_.allocate_mapped(size);
+        return bo_array(runner_.mapped_in(), {size});
+    }
+
+    py::array_t<long long> run_mapped() {
+        runner_.run_mapped();
+        return bo_array(runner_.mapped_out(), {static_cast<py::ssize_t>(runner_.mapped_out()->size())});
+    }
+
     double get_kernel_execution_time_ms() const {
         return runner_.get_kernel_execution_time_ms();
     }
@@ -131,6 +228,18 @@ public:
         return runner_.get_total_execution_time_ms();
     }
 
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(runner_.phases());
+    }
+
+    void reset_phase_stats() {
+        runner_.phases().reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        runner_.phases().set_enabled(enabled);
+    }
+
 private:
     BurstTestRunner<long long> runner_;
 };
@@ -141,20 +250,44 @@ PYBIND11_MODULE(libbursttest_module_hw, m) {
     py::class_<PyBurstTestRunner32>(m, "BurstTestRunner32")
         .def(py::init<const std::string&>())
         .def("run", &PyBurstTestRunner32::run,
-             py::arg("input").noconvert(), py::arg("burst_length") = 256,
+             py::arg("input").noconvert(),
              "Runs the burst_32 kernel with input array and returns the result.")
+        .def("alloc_input", &PyBurstTestRunner32::alloc_input,
+             py::arg("size"),
+             "Allocates the input array directly in device buffer host memory. Fill it in place and call run_mapped().")
+        .def("run_mapped", &PyBurstTestRunner32::run_mapped,
+             "Runs the burst_32 kernel on the array from alloc_input() and returns the output buffer without copying.")
         .def("get_kernel_execution_time_ms", &PyBurstTestRunner32::get_kernel_execution_time_ms,
             "Returns the kernel execution time in milliseconds.")
         .def("get_total_execution_time_ms", &PyBurstTestRunner32::get_total_execution_time_ms,
-            "Returns the total execution time including data transfers in milliseconds.");
+            "Returns the total execution time including data transfers in milliseconds.")
+        .def("get_phase_stats", &PyBurstTestRunner32::get_phase_stats,
+            "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}}.")
+        .def("reset_phase_stats", &PyBurstTestRunner32::reset_phase_stats,
+            "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyBurstTestRunner32::set_phase_timing,
+            py::arg("enabled"),
+            "Enables or disables per-phase timing (enabled by default).");
             
     py::class_<PyBurstTestRunner64>(m, "BurstTestRunner64")
         .def(py::init<const std::string&>())
         .def("run", &PyBurstTestRunner64::run,
-             py::arg("input").noconvert(), py::arg("burst_length") = 256,
+             py::arg("input").noconvert(),
              "Runs the burst_64 kernel with input array and returns the result.")
+        .def("alloc_input", &PyBurstTestRunner64::alloc_input,
+             py::arg("size"),
+             "Allocates the input array directly in device buffer host memory. Fill it in place and call run_mapped().")
+        .def("run_mapped", &PyBurstTestRunner64::run_mapped,
+             "Runs the burst_64 kernel on the array from alloc_input() and returns the output buffer without copying.")
         .def("get_kernel_execution_time_ms", &PyBurstTestRunner64::get_kernel_execution_time_ms,
             "Returns the kernel execution time in milliseconds.")
         .def("get_total_execution_time_ms", &PyBurstTestRunner64::get_total_execution_time_ms,
-            "Returns the total execution time including data transfers in milliseconds.");
+            "Returns the total execution time including data transfers in milliseconds.")
+        .def("get_phase_stats", &PyBurstTestRunner64::get_phase_stats,
+            "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}}.")
+        .def("reset_phase_stats", &PyBurstTestRunner64::reset_phase_stats,
+            "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyBurstTestRunner64::set_phase_timing,
+            py::arg("enabled"),
+            "Enables or disables per-phase timing (enabled by default).");
 }
@@ -4,6 +4,10 @@ import time
 import argparse
 import pandas as pd
 from pathlib import Path
+import sys
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+from bench_record import BenchRecorder
 
 try: 
     from libbursttest_module_hw import BurstTestRunner32, BurstTestRunner64
@@ -12,16 +16,16 @@ except ImportError:
 
 MEGA = 1024 * 1024
 
-def test_burst_transfer(bit_width, burst_length, data_size=1*MEGA):
+def test_burst_transfer(bit_width, burst_length, data_size=1*MEGA, recorder=None):
     """Run burst transfer test for specified bit width and burst length"""
     print(f"Testing {bit_width}-bit width with burst length {burst_length}")
     
+    # バースト長は合成時に決まるため、バースト長ごとのxclbin (全ビット幅のカーネルを含む) を読み込む
+    xclbin_file = f"burst_b{burst_length}.xclbin"
     if bit_width == 32:
-        xclbin_file = f"burst_{bit_width}.xclbin"
         runner = BurstTestRunner32(xclbin_file)
         input_data = np.arange(data_size, dtype=np.int32)
     elif bit_width == 64:
-        xclbin_file = f"burst_{bit_width}.xclbin"
         runner = BurstTestRunner64(xclbin_file)
         input_data = np.arange(data_size, dtype=np.int64)
     else:
@@ -35,7 +39,7 @@ def test_burst_transfer(bit_width, burst_length, data_size=1*MEGA):
     for i in range(num_iterations):
         print(f"Iteration {i+1}/{num_iterations}")
         
-        result = runner.run(input_data, burst_length)
+        result = runner.run(input_data)
         
         kernel_time = runner.get_kernel_execution_time_ms()
         total_time = runner.get_total_execution_time_ms()
@@ -47,6 +51,11 @@ def test_burst_transfer(bit_width, burst_length, data_size=1*MEGA):
     if not np.array_equal(result[:10], expected[:10]):
         print("Warning: Result verification failed for first 10 elements")
     
+    if recorder is not None:
+        params = {"width": bit_width, "burst_length": burst_length, "elements": data_size}
+        recorder.add(f"burst_{bit_width}", "burst_python_test_hw", dict(params, phase="kernel"), kernel_times)
+        recorder.add(f"burst_{bit_width}", "burst_python_test_hw", dict(params, phase="total"), total_times)
+
     avg_kernel_time_ms = np.mean(kernel_times)
     avg_total_time_ms = np.mean(total_times)
     
@@ -63,6 +72,8 @@ def test_burst_transfer(bit_width, burst_length, data_size=1*MEGA):
     print(f"Throughput (total): {throughput_total_mega_ops_per_sec:.2f} M Ops/sec")
     print(f"Bandwidth (kernel only): {bandwidth_kernel_mb_per_sec:.2f} MB/s")
     print(f"Bandwidth (total): {bandwidth_total_mb_per_sec:.2f} MB/s")
+    phases = runner.get_phase_stats()
+    print(f"Phase latency p50 (us): { {p: round(s['p50_us'], 1) for p, s in phases.items()} }")
     
     return {
         "bit_width": bit_width,
@@ -80,19 +91,23 @@ def main():
     parser.add_argument('--bit-widths', type=int, nargs='+', default=[32, 64, 128, 256, 512, 1024],
                         help='Bit widths to test')
     parser.add_argument('--burst-lengths', type=int, nargs='+', default=[64, 128, 256],
-                        help='Burst lengths to test (max 256)')
+                        help='Burst lengths to test (burst_b<L>.xclbin must be built for each)')
     parser.add_argument('--data-size', type=int, default=1*MEGA,
                         help='Data size in elements')
     args = parser.parse_args()
     
     results = []
+    recorder = BenchRecorder()
     
-    for bit_width in args.bit_widths:
-        for burst_length in args.burst_lengths:
-            result = test_burst_transfer(bit_width, burst_length, args.data_size)
+    # xclbinの書き込みがバースト長ごとに1回で済むよう、バースト長を外側に回す
+    for burst_length in args.burst_lengths:
+        for bit_width in args.bit_widths:
+            result = test_burst_transfer(bit_width, burst_length, args.data_size, recorder)
             if result:
                 results.append(result)
     
+    recorder.write()
+
     if results:
         df = pd.DataFrame(results)
         output_file = "burst_results.csv"
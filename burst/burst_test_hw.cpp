@@ -1,405 +1,82 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
 #include <iostream>
-#include <vector>
 #include <string>
 #include <cstdlib>
-#include <ctime>
-#include <chrono>
-#include <numeric>
-#include <algorithm>
 
-#include "experimental/xrt_bo.h"
-#include "experimental/xrt_device.h"
-#include "experimental/xrt_kernel.h"
-#include "ap_int.h"
+#include "bench_record.h"
+#include "burst_harness.h"
 
-const int DATA_SIZE = 1024 * 1024; // 1M elements
-const int NUM_ITERATIONS = 5;
-const int MEGA = 1024 * 1024;
-
-const char* KERNEL_NAME_32 = "burst_32";
-const char* KERNEL_NAME_64 = "burst_64";
-const char* KERNEL_NAME_128 = "burst_128";
-const char* KERNEL_NAME_256 = "burst_256";
-const char* KERNEL_NAME_512 = "burst_512";
-const char* KERNEL_NAME_1024 = "burst_1024";
-
-void runTest32(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 32-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
-    try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_32);
-        
-        std::vector<int> source(DATA_SIZE);
-        std::vector<int> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, DATA_SIZE * sizeof(int), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, DATA_SIZE * sizeof(int), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            
-            auto run = kernel(bo_in, bo_out, DATA_SIZE, burst_length);
-            run.wait();
-            
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        bool match = true;
-        for (int i = 0; i < std::min(10, DATA_SIZE); ++i) {
-            if (result[i] != source[i] + 1) {
-                std::cerr << "Mismatch at index " << i << ": result=" << result[i] 
-                          << ", expected=" << (source[i] + 1) << std::endl;
-                match = false;
-                break;
-            }
-        }
-        
-        if (match) {
-            std::cout << "Result verification successful (first 10 elements)." << std::endl;
-        }
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(int) / (avg_time / 1000.0)) / (1024 * 1024);
-        
-        std::cout << "\n--- Performance Summary (32-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
-    } catch (const std::exception& ex) {
-        std::cerr << "Exception caught: " << ex.what() << std::endl;
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "-h") {
+        std::cout << "Usage: " << argv[0] << " [xclbin_prefix] [iterations] [megabytes] [ddr_mb_s] [pcie_mb_s]" << std::endl;
+        std::cout << "  xclbin_prefix: loads <prefix>_b64/_b128/_b256.xclbin, each with all burst_NN kernels, default is burst"
+                  << std::endl;
+        std::cout << "  iterations: timed runs per width and burst length, default is 20" << std::endl;
+        std::cout << "  megabytes: bytes read (and written) per run in MiB, default is 16" << std::endl;
+        std::cout << "  ddr_mb_s: DDR peak per bank in MB/s (10^6 B/s), default is 19200 (DDR4-2400)" << std::endl;
+        std::cout << "  pcie_mb_s: PCIe peak per direction in MB/s, default is 15754 (PCIe 3.0 x16)" << std::endl;
+        return EXIT_SUCCESS;
     }
-}
 
-void runTest64(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 64-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
-    try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_64);
-        
-        std::vector<long long> source(DATA_SIZE);
-        std::vector<long long> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, DATA_SIZE * sizeof(long long), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, DATA_SIZE * sizeof(long long), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            
-            auto run = kernel(bo_in, bo_out, DATA_SIZE, burst_length);
-            run.wait();
-            
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        bool match = true;
-        for (int i = 0; i < std::min(10, DATA_SIZE); ++i) {
-            if (result[i] != source[i] + 1) {
-                std::cerr << "Mismatch at index " << i << ": result=" << result[i] 
-                          << ", expected=" << (source[i] + 1) << std::endl;
-                match = false;
-                break;
-            }
-        }
-        
-        if (match) {
-            std::cout << "Result verification successful (first 10 elements)." << std::endl;
-        }
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(long long) / (avg_time / 1000.0)) / (1024 * 1024);
-        
-        std::cout << "\n--- Performance Summary (64-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
-    } catch (const std::exception& ex) {
-        std::cerr << "Exception caught: " << ex.what() << std::endl;
+    BurstConfig config;
+    if (argc > 1) {
+        config.xclbin_prefix = argv[1];
     }
-}
-
-void runTest128(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 128-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
-    try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_128);
-        
-        int elements_per_ap_int = 128 / 32; // Assuming we pack 32-bit ints into 128-bit
-        int ap_int_size = (DATA_SIZE + elements_per_ap_int - 1) / elements_per_ap_int;
-        
-        std::vector<int> source(DATA_SIZE);
-        std::vector<int> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, ap_int_size * sizeof(ap_int<128>), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, ap_int_size * sizeof(ap_int<128>), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            
-            auto run = kernel(bo_in, bo_out, ap_int_size, burst_length);
-            run.wait();
-            
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(int) * 4 / (avg_time / 1000.0)) / (1024 * 1024); // *4 for 128-bit
-        
-        std::cout << "\n--- Performance Summary (128-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
-    } catch (const std::exception& ex) {
-        std::cerr << "Exception caught: " << ex.what() << std::endl;
+    if (argc > 2) {
+        config.iterations = std::stoi(argv[2]);
     }
-}
-
-void runTest256(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 256-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
-    try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_256);
-        
-        int elements_per_ap_int = 256 / 32;
-        int ap_int_size = (DATA_SIZE + elements_per_ap_int - 1) / elements_per_ap_int;
-        
-        std::vector<int> source(DATA_SIZE);
-        std::vector<int> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, ap_int_size * sizeof(ap_int<256>), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, ap_int_size * sizeof(ap_int<256>), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            auto run = kernel(bo_in, bo_out, ap_int_size, burst_length);
-            run.wait();
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(int) * 8 / (avg_time / 1000.0)) / (1024 * 1024); // *8 for 256-bit
-        
-        std::cout << "\n--- Performance Summary (256-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
-    } catch (const std::exception& ex) {
-        std::cerr << "Exception caught: " << ex.what() << std::endl;
+    if (argc > 3) {
+        config.bytes = std::stoul(argv[3]) * 1024 * 1024;
     }
-}
-
-void runTest512(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 512-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
-    try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_512);
-        
-        int elements_per_ap_int = 512 / 32;
-        int ap_int_size = (DATA_SIZE + elements_per_ap_int - 1) / elements_per_ap_int;
-        
-        std::vector<int> source(DATA_SIZE);
-        std::vector<int> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, ap_int_size * sizeof(ap_int<512>), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, ap_int_size * sizeof(ap_int<512>), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            auto run = kernel(bo_in, bo_out, ap_int_size, burst_length);
-            run.wait();
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(int) * 16 / (avg_time / 1000.0)) / (1024 * 1024); // *16 for 512-bit
-        
-        std::cout << "\n--- Performance Summary (512-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
-    } catch (const std::exception& ex) {
-        std::cerr << "Exception caught: " << ex.what() << std::endl;
+    BandwidthPeaks peaks;
+    if (argc > 4) {
+        peaks.ddr_mb_s = std::stod(argv[4]);
     }
-}
+    if (argc > 5) {
+        peaks.pcie_mb_s = std::stod(argv[5]);
+    }
+
+    std::cout << "Burst sweep: " << config.xclbin_path(config.burst_lengths.front()) << " .. "
+              << config.xclbin_path(config.burst_lengths.back()) << ", " << config.bytes / (1024 * 1024) << " MiB per run, "
+              << config.warmup << " warmup + " << config.iterations << " timed runs" << std::endl;
 
-void runTest1024(const std::string& xclbin_file, int burst_length) {
-    std::cout << "Running 1024-bit test with " << DATA_SIZE << " elements and burst length " << burst_length << std::endl;
-    
+    std::vector<BurstResult> results;
     try {
-        auto device = xrt::device(0);
-        auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME_1024);
-        
-        int elements_per_ap_int = 1024 / 32;
-        int ap_int_size = (DATA_SIZE + elements_per_ap_int - 1) / elements_per_ap_int;
-        
-        std::vector<int> source(DATA_SIZE);
-        std::vector<int> result(DATA_SIZE);
-        
-        std::iota(source.begin(), source.end(), 0);
-        
-        auto bo_in = xrt::bo(device, ap_int_size * sizeof(ap_int<1024>), kernel.group_id(0));
-        auto bo_out = xrt::bo(device, ap_int_size * sizeof(ap_int<1024>), kernel.group_id(1));
-        
-        bo_in.write(source.data());
-        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        std::vector<double> execution_times;
-        
-        for (int i = 0; i < NUM_ITERATIONS; ++i) {
-            auto start_time = std::chrono::high_resolution_clock::now();
-            auto run = kernel(bo_in, bo_out, ap_int_size, burst_length);
-            run.wait();
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double, std::milli> duration_ms = end_time - start_time;
-            execution_times.push_back(duration_ms.count());
-            
-            std::cout << "Iteration " << (i+1) << ": " << duration_ms.count() << " ms" << std::endl;
-        }
-        
-        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_out.read(result.data());
-        
-        double avg_time = std::accumulate(execution_times.begin(), execution_times.end(), 0.0) / execution_times.size();
-        double throughput_ops = (DATA_SIZE / (avg_time / 1000.0)) / MEGA;
-        double throughput_bytes = (DATA_SIZE * sizeof(int) * 32 / (avg_time / 1000.0)) / (1024 * 1024); // *32 for 1024-bit
-        
-        std::cout << "\n--- Performance Summary (1024-bit) ---" << std::endl;
-        std::cout << "Average execution time: " << avg_time << " ms" << std::endl;
-        std::cout << "Throughput: " << throughput_ops << " M Ops/sec" << std::endl;
-        std::cout << "Bandwidth: " << throughput_bytes << " MB/s" << std::endl;
-        
+        results = run_burst_sweep(config);
     } catch (const std::exception& ex) {
         std::cerr << "Exception caught: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
     }
-}
 
-int main(int argc, char** argv) {
-    if (argc < 3) {
-        std::cout << "Usage: " << argv[0] << " <xclbin_file> <bit_width> [burst_length]" << std::endl;
-        std::cout << "  bit_width: 32, 64, 128, 256, 512, or 1024" << std::endl;
-        std::cout << "  burst_length: Optional, default is 256" << std::endl;
-        return EXIT_FAILURE;
+    print_burst_results(results);
+    std::cout << std::endl;
+    print_burst_roofline(results, peaks);
+
+    BenchRecorder recorder;
+    recorder.env().set("xclbin", config.xclbin_prefix + "_b*.xclbin");
+    for (const BurstResult& r : results) {
+        recorder.add("burst_" + std::to_string(r.width), "burst_test_hw")
+            .param("width", r.width)
+            .param("burst_length", r.burst_length)
+            .param("bytes", r.bytes)
+            .set_samples(r.samples_ms);
+    }
+    if (!recorder.write()) {
+        std::cerr << "Failed to write benchmark records to " << recorder.path() << std::endl;
     }
-    
-    std::string xclbin_file = argv[1];
-    int bit_width = std::stoi(argv[2]);
-    int burst_length = (argc > 3) ? std::stoi(argv[3]) : 256;
-    
-    std::cout << "Testing with bit width: " << bit_width << ", burst length: " << burst_length << std::endl;
-    
-    switch (bit_width) {
-        case 32:
-            runTest32(xclbin_file, burst_length);
-            break;
-        case 64:
-            runTest64(xclbin_file, burst_length);
-            break;
-        case 128:
-            runTest128(xclbin_file, burst_length);
-            break;
-        case 256:
-            runTest256(xclbin_file, burst_length);
-            break;
-        case 512:
-            runTest512(xclbin_file, burst_length);
-            break;
-        case 1024:
-            runTest1024(xclbin_file, burst_length);
-            break;
-        default:
-            std::cerr << "Unsupported bit width: " << bit_width << std::endl;
+
+    for (const BurstResult& r : results) {
+        if (!r.verified) {
+            std::cout << "Test FAILED!" << std::endl;
             return EXIT_FAILURE;
+        }
     }
-    
+    std::cout << "Test PASSED!" << std::endl;
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "burst_harness.h"
+#include "test_check.h"
+
+// burst_<W> カーネルのホスト実装 (out[i] = in[i] + 1)
+template <int W>
+static void register_burst(bool broken = false) {
+    xrt_fake::register_kernel("burst_" + std::to_string(W), [broken](const std::vector<xrt_fake::kernel_arg>& args) {
+        const BurstBeat<W>* in = args[0].ptr<BurstBeat<W>>();
+        BurstBeat<W>* out = args[1].ptr<BurstBeat<W>>();
+        for (int64_t i = 0; i < args[2].scalar; ++i) {
+            out[i] = broken ? in[i] : burst_beat_plus_one(in[i]);
+        }
+    });
+}
+
+static void register_all() {
+    register_burst<32>();
+    register_burst<64>();
+    register_burst<128>();
+    register_burst<256>();
+    register_burst<512>();
+    register_burst<1024>();
+}
+
+static BurstConfig small_config() {
+    BurstConfig config;
+    config.bytes = 64 * 1024;
+    config.warmup = 2;
+    config.iterations = 10;
+    return config;
+}
+
+// 全ビット幅・バースト長を計測し、結果を検証する。xclbinはバースト長ごとに1回だけ書き込む
+bool test_sweep() {
+    register_all();
+    xrt_fake::reset_counters();
+    xrt_fake::latency().kernel = std::chrono::microseconds(200);
+    BurstConfig config = small_config();
+    std::vector<BurstResult> results = run_burst_sweep(config);
+    xrt_fake::latency().kernel = std::chrono::microseconds(0);
+    print_burst_results(results);
+    print_burst_roofline(results, BandwidthPeaks());
+
+    bool ok = true;
+    ok &= check(results.size() == 6 * config.burst_lengths.size(), "one result per width and burst length");
+    ok &= check(xrt_fake::counters().xclbin_loads == config.burst_lengths.size(), "one xclbin per burst length");
+    for (size_t i = 0; i < results.size(); ++i) {
+        ok &= check(results[i].burst_length == config.burst_lengths[i / 6], "results grouped by burst length");
+    }
+    ok &= check(xrt_fake::counters().kernel_launches == results.size() * (config.warmup + config.iterations),
+                "warmup and timed launches");
+    for (const BurstResult& r : results) {
+        std::string name = std::to_string(r.width) + "/" + std::to_string(r.burst_length);
+        ok &= check(r.verified, name + " verified");
+        ok &= check(r.bytes == config.bytes && r.beats == config.bytes / (r.width / 8), name + " beats and bytes");
+        ok &= check(r.time_ms.count == static_cast<size_t>(config.iterations), name + " only timed runs are counted");
+        ok &= check(r.time_ms.min >= 0.2 && r.time_ms.min <= r.time_ms.median && r.time_ms.median <= r.time_ms.p99,
+                    name + " statistics are ordered");
+        ok &= check(r.traffic().bytes_read() == r.bytes && r.traffic().bytes_written() == r.bytes,
+                    name + " traffic matches the bytes moved");
+        ok &= check(r.report(BandwidthPeaks()).total_mb_s > 0, name + " bandwidth");
+    }
+    return ok;
+}
+
+// カーネルが誤った値を書いた場合は検証に失敗する
+bool test_detects_mismatch() {
+    register_all();
+    register_burst<128>(true);
+    BurstConfig config = small_config();
+    config.burst_lengths = {64};
+    std::vector<BurstResult> results = run_burst_sweep(config);
+
+    bool ok = true;
+    for (const BurstResult& r : results) {
+        ok &= check(r.verified == (r.width != 128), "only the broken width fails");
+    }
+    register_burst<128>();
+    return ok;
+}
+
+// 繰り上がりがワードをまたぐ場合の+1
+bool test_carry() {
+    BurstBeat<128> beat;
+    std::memset(beat.bytes, 0xff, 8);
+    std::memset(beat.bytes + 8, 0, 8);
+    BurstBeat<128> next = burst_beat_plus_one(beat);
+
+    bool ok = true;
+    ok &= check(next.bytes[0] == 0 && next.bytes[7] == 0 && next.bytes[8] == 1, "carry into the upper 64 bits");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running burst harness software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_carry();
+    ok &= test_sweep();
+    ok &= test_detects_mismatch();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -4,80 +4,31 @@
 source /opt/xilinx/xrt/setup.sh
 
 RESULTS_FILE="test_results.txt"
-RESULTS_MD="results_table.md"
-
-BIT_WIDTHS=(32 64 128 256 512 1024)
-BURST_LENGTHS=(64 128 256)
-NUM_ITERATIONS=5
+# 機械可読な記録 (JSON Lines)。common/bench_compare.py で以前の結果と比較できる
+export BENCH_RECORDS="${BENCH_RECORDS:-burst_results.jsonl}"
+# バースト長ごとに burst_b<L>.xclbin を読み込む (Makefile の BURST_LENGTHS)
+XCLBIN_PREFIX="burst"
+BURST_LENGTHS="64 128 256"
+NUM_ITERATIONS=20
 
 echo "# バースト転送最適化テスト結果" > $RESULTS_FILE
 echo "実行日時: $(date)" >> $RESULTS_FILE
 echo "" >> $RESULTS_FILE
 
-echo "## バースト転送最適化テスト結果" > $RESULTS_MD
-echo "" >> $RESULTS_MD
-echo "| ビット幅 | バースト長 | スループット (M Ops/sec) | 帯域幅 (MB/s) | 理論値比 (%) |" >> $RESULTS_MD
-echo "|---------|-----------|------------------------|--------------|------------|" >> $RESULTS_MD
-
-for bit_width in 32 64; do
-    for burst_length in "${BURST_LENGTHS[@]}"; do
-        xclbin_file="burst_${bit_width}.xclbin"
-        
-        if [ -f "$xclbin_file" ]; then
-            echo "=== テスト実行: ${bit_width}ビット, バースト長 ${burst_length} ===" >> $RESULTS_FILE
-            echo "簡易テストハーネスを使用" >> $RESULTS_FILE
-            
-            ./burst_simple_hw $xclbin_file $bit_width $burst_length | tee -a $RESULTS_FILE
-            
-            throughput=$(grep "Throughput:" $RESULTS_FILE | tail -1 | awk '{print $2}')
-            bandwidth=$(grep "Bandwidth:" $RESULTS_FILE | tail -1 | awk '{print $2}')
-            
-            if [ ! -z "$bandwidth" ]; then
-                ratio=$(echo "scale=2; $bandwidth / 16384 * 100" | bc)
-                echo "PCIe 3.0 x16理論値比: ${ratio}%" >> $RESULTS_FILE
-            else
-                ratio="N/A"
-            fi
-            
-            echo "| $bit_width | $burst_length | $throughput | $bandwidth | $ratio |" >> $RESULTS_MD
-        else
-            echo "警告: ${xclbin_file}が見つかりません。${bit_width}ビットのテストをスキップします。" >> $RESULTS_FILE
-        fi
-    done
-done
-
-for bit_width in "${BIT_WIDTHS[@]}"; do
-    if [ "$bit_width" -eq 32 ] || [ "$bit_width" -eq 64 ]; then
-        continue
+for length in $BURST_LENGTHS; do
+    XCLBIN_FILE="${XCLBIN_PREFIX}_b${length}.xclbin"
+    if [ ! -f "$XCLBIN_FILE" ]; then
+        echo "エラー: ${XCLBIN_FILE}が見つかりません。make ${XCLBIN_FILE} でビルドしてください。" | tee -a $RESULTS_FILE
+        exit 1
     fi
-    
-    for burst_length in "${BURST_LENGTHS[@]}"; do
-        xclbin_file="burst_${bit_width}.xclbin"
-        
-        if [ -f "$xclbin_file" ]; then
-            echo "=== テスト実行: ${bit_width}ビット, バースト長 ${burst_length} ===" >> $RESULTS_FILE
-            echo "標準テストハーネスを使用" >> $RESULTS_FILE
-            
-            ./burst_test_hw $xclbin_file $bit_width $burst_length | tee -a $RESULTS_FILE
-            
-            throughput=$(grep "Throughput:" $RESULTS_FILE | tail -1 | awk '{print $2}')
-            bandwidth=$(grep "Bandwidth:" $RESULTS_FILE | tail -1 | awk '{print $2}')
-            
-            if [ ! -z "$bandwidth" ]; then
-                ratio=$(echo "scale=2; $bandwidth / 16384 * 100" | bc)
-                echo "PCIe 3.0 x16理論値比: ${ratio}%" >> $RESULTS_FILE
-            else
-                ratio="N/A"
-            fi
-            
-            echo "| $bit_width | $burst_length | $throughput | $bandwidth | $ratio |" >> $RESULTS_MD
-        else
-            echo "警告: ${xclbin_file}が見つかりません。${bit_width}ビットのテストをスキップします。" >> $RESULTS_FILE
-        fi
-    done
 done
 
+# 全ビット幅・バースト長を1プロセスで計測する (xclbinの書き込みはバースト長ごとに1回)
+./burst_test_hw $XCLBIN_PREFIX $NUM_ITERATIONS | tee -a $RESULTS_FILE
+status=${PIPESTATUS[0]}
+
 echo "" >> $RESULTS_FILE
 echo "テスト完了: $(date)" >> $RESULTS_FILE
 
-echo "テスト結果は ${RESULTS_FILE} と ${RESULTS_MD} に保存されました。"
+echo "テスト結果は ${RESULTS_FILE} と ${BENCH_RECORDS} に保存されました。"
+exit $status
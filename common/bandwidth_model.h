@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// カーネルが実際に動かしたバイト数と帯域のピークの比較 (ルーフライン)。
+// 帯域は10進のMB/s (1 MB = 10^6 B) で扱う。DDR・PCIeの公称値が10進のため。
+
+// 1回の実行でのメモリトラフィック。ビート数とビートあたりの読み書きバイト数から求める。
+struct KernelTraffic {
+    size_t beats = 0;
+    size_t read_bytes_per_beat = 0;
+    size_t write_bytes_per_beat = 0;
+    double ops_per_beat = 1;  // ビートあたりの演算数 (演算強度の計算用)
+
+    size_t bytes_read() const { return beats * read_bytes_per_beat; }
+    size_t bytes_written() const { return beats * write_bytes_per_beat; }
+    size_t bytes_total() const { return bytes_read() + bytes_written(); }
+
+    // 演算強度 (ops/B)
+    double ops_per_byte() const {
+        size_t bytes = read_bytes_per_beat + write_bytes_per_beat;
+        return bytes > 0 ? ops_per_beat / bytes : 0.0;
+    }
+};
+
+// 比較に使うピーク帯域。既定値はU250 (DDR4-2400 x 64bit、1バンク) とPCIe 3.0 x16。
+struct BandwidthPeaks {
+    double ddr_mb_s = 19200.0;   // 1バンクあたり (2400 MT/s x 8 B)
+    int ddr_banks = 1;           // カーネルが使うバンク数 (既定では全ポートがバンク0)
+    double pcie_mb_s = 15754.0;  // 片方向 (8 GT/s x 16 lanes x 128b/130b)
+    double kernel_mhz = 300.0;   // カーネルクロック
+
+    double ddr_total_mb_s() const { return ddr_mb_s * ddr_banks; }
+};
+
+// 1回の実行の実測帯域とピークとの比較
+struct BandwidthReport {
+    double read_mb_s = 0;
+    double write_mb_s = 0;
+    double total_mb_s = 0;
+    double port_mb_s = 0;     // II=1で毎サイクル1ビートを読み書きした場合の上限 (AXIの読みと書きは独立)
+    double roof_mb_s = 0;     // min(port_mb_s, DDRのピーク)
+    double ddr_ratio = 0;     // total / DDRのピーク
+    double pcie_ratio = 0;    // total / PCIeのピーク (ホスト転送と同量を動かした場合の比較用)
+    double roof_ratio = 0;    // total / roof
+    double gops = 0;          // 実測の演算性能
+    bool port_bound = false;  // ポートの上限がDDRより低い (ビット幅が律速)
+};
+
+inline BandwidthReport bandwidth_report(const KernelTraffic& traffic, double seconds, const BandwidthPeaks& peaks) {
+    BandwidthReport report;
+    if (seconds <= 0) {
+        return report;
+    }
+    report.read_mb_s = traffic.bytes_read() / seconds / 1e6;
+    report.write_mb_s = traffic.bytes_written() / seconds / 1e6;
+    report.total_mb_s = report.read_mb_s + report.write_mb_s;
+    report.port_mb_s = (traffic.read_bytes_per_beat + traffic.write_bytes_per_beat) * peaks.kernel_mhz;
+    report.roof_mb_s = std::min(report.port_mb_s, peaks.ddr_total_mb_s());
+    report.port_bound = report.port_mb_s < peaks.ddr_total_mb_s();
+    report.ddr_ratio = peaks.ddr_total_mb_s() > 0 ? report.total_mb_s / peaks.ddr_total_mb_s() : 0.0;
+    report.pcie_ratio = peaks.pcie_mb_s > 0 ? report.total_mb_s / peaks.pcie_mb_s : 0.0;
+    report.roof_ratio = report.roof_mb_s > 0 ? report.total_mb_s / report.roof_mb_s : 0.0;
+    report.gops = traffic.beats * traffic.ops_per_beat / seconds / 1e9;
+    return report;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cmath>
+#include <iostream>
+
+#include "bandwidth_model.h"
+#include "test_check.h"
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9 * (1.0 + std::fabs(b));
+}
+
+// burst_NN: ビートごとにWビットを読み、Wビットを書く
+static KernelTraffic burst_traffic(int width, size_t bytes) {
+    KernelTraffic traffic;
+    traffic.read_bytes_per_beat = width / 8;
+    traffic.write_bytes_per_beat = width / 8;
+    traffic.beats = bytes / traffic.read_bytes_per_beat;
+    return traffic;
+}
+
+// 読み書きのバイト数はビート数 x ビート幅で、要素数や幅の倍率には依存しない
+bool test_bytes_per_beat() {
+    const size_t MiB = 1024 * 1024;
+    bool ok = true;
+    for (int width : {32, 64, 128, 256, 512, 1024}) {
+        KernelTraffic t = burst_traffic(width, 16 * MiB);
+        ok &= check(t.beats == 16 * MiB / (width / 8), "beats");
+        ok &= check(t.bytes_read() == 16 * MiB, "bytes read");
+        ok &= check(t.bytes_written() == 16 * MiB, "bytes written");
+        ok &= check(t.bytes_total() == 32 * MiB, "read and write counted separately");
+    }
+    KernelTraffic vdot;  // int8 x 2を読み、書き込みなし
+    vdot.beats = 1000;
+    vdot.read_bytes_per_beat = 2;
+    vdot.ops_per_beat = 2;
+    ok &= check(vdot.bytes_written() == 0 && vdot.bytes_total() == 2000, "read-only kernel");
+    ok &= check(near(vdot.ops_per_byte(), 1.0), "arithmetic intensity");
+    return ok;
+}
+
+// 512ビット・16MiBを2msで実行した場合の各値
+bool test_report_ddr_bound() {
+    BandwidthPeaks peaks;
+    BandwidthReport r = bandwidth_report(burst_traffic(512, 16 * 1024 * 1024), 0.002, peaks);
+
+    bool ok = true;
+    ok &= check(near(r.read_mb_s, 8388.608) && near(r.write_mb_s, 8388.608), "read/write MB/s");
+    ok &= check(near(r.total_mb_s, 16777.216), "total MB/s");
+    ok &= check(near(r.port_mb_s, 128 * 300.0), "port limit is (read + write bytes per beat) x clock");
+    ok &= check(!r.port_bound && near(r.roof_mb_s, 19200.0), "DDR is the roof for wide beats");
+    ok &= check(near(r.ddr_ratio, 16777.216 / 19200.0), "ratio to DDR");
+    ok &= check(near(r.pcie_ratio, 16777.216 / 15754.0), "ratio to PCIe");
+    ok &= check(near(r.roof_ratio, r.ddr_ratio), "roof ratio equals DDR ratio when DDR bound");
+    ok &= check(near(r.gops, 262144 / 0.002 / 1e9), "ops per second");
+    return ok;
+}
+
+// 32ビットではビット幅 x クロックが上限になる
+bool test_report_port_bound() {
+    BandwidthPeaks peaks;
+    BandwidthReport r = bandwidth_report(burst_traffic(32, 1024 * 1024), 0.001, peaks);
+
+    bool ok = true;
+    ok &= check(r.port_bound, "narrow beats are port bound");
+    ok &= check(near(r.roof_mb_s, 8 * 300.0), "roof is the port limit");
+    ok &= check(near(r.roof_ratio, r.total_mb_s / 2400.0), "roof ratio");
+    return ok;
+}
+
+// ピークは設定できる
+bool test_configurable_peaks() {
+    BandwidthPeaks peaks;
+    peaks.ddr_banks = 4;
+    peaks.kernel_mhz = 250;
+    peaks.pcie_mb_s = 31508;  // PCIe 4.0 x16
+    BandwidthReport r = bandwidth_report(burst_traffic(1024, 1024 * 1024), 0.001, peaks);
+
+    bool ok = true;
+    ok &= check(near(peaks.ddr_total_mb_s(), 76800.0), "DDR peak scales with banks");
+    ok &= check(near(r.port_mb_s, 256 * 250.0) && r.port_bound, "clock changes the port limit");
+    ok &= check(near(r.pcie_ratio, r.total_mb_s / 31508.0), "PCIe peak");
+
+    BandwidthReport zero = bandwidth_report(burst_traffic(1024, 1024), 0.0, peaks);
+    ok &= check(zero.total_mb_s == 0 && zero.roof_ratio == 0, "zero time gives an empty report");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running bandwidth model software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_bytes_per_beat();
+    ok &= test_report_ddr_bound();
+    ok &= test_report_port_bound();
+    ok &= test_configurable_peaks();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""2つのベンチマーク記録ファイル (JSON LinesまたはCSV) を比較し、統計的に有意な性能低下を検出する。
+
+(kernel, params) ごとに反復時間を比べ、片側のMann-Whitney U検定 (正規近似、同順位補正あり) で
+新しい側が遅いと判定され (p < alpha)、かつ中央値の増加率がthreshold以上の場合を性能低下とする。
+性能低下が1件でもあれば終了コード1を返す。ローカルのファイルだけを使い、標準ライブラリのみで動く。
+
+使い方: python3 bench_compare.py baseline.jsonl candidate.jsonl [--alpha 0.01] [--threshold 0.05]
+"""
+import argparse
+import math
+import sys
+
+from bench_record import load_records, percentile
+
+
+def mann_whitney_greater(base, new):
+    """newがbaseより大きい (遅い) という対立仮説での片側p値"""
+    n1, n2 = len(base), len(new)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    values = sorted([(v, 0) for v in base] + [(v, 1) for v in new])
+    ranks = [0.0] * len(values)
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        t = j - i + 1
+        tie_term += t ** 3 - t
+        i = j + 1
+    rank_sum_new = sum(r for r, (_, group) in zip(ranks, values) if group == 1)
+    u = rank_sum_new - n2 * (n2 + 1) / 2.0
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if var <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(var)  # 連続性補正
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def compare(base_groups, new_groups, alpha=0.01, threshold=0.05):
+    """比較結果の行のリストを返す。statusは regression / improved / ok / missing / new。"""
+    rows = []
+    for key in sorted(set(base_groups) | set(new_groups)):
+        base = sorted(base_groups.get(key, []))
+        new = sorted(new_groups.get(key, []))
+        row = {"kernel": key[0], "params": key[1], "base_median": None, "new_median": None,
+               "change": None, "p_slower": None, "p_faster": None}
+        if not base or not new:
+            row["status"] = "missing" if base else "new"
+            rows.append(row)
+            continue
+        row["base_median"] = percentile(base, 50.0)
+        row["new_median"] = percentile(new, 50.0)
+        row["change"] = row["new_median"] / row["base_median"] - 1.0 if row["base_median"] > 0 else 0.0
+        row["p_slower"] = mann_whitney_greater(base, new)
+        row["p_faster"] = mann_whitney_greater(new, base)
+        if row["p_slower"] < alpha and row["change"] >= threshold:
+            row["status"] = "regression"
+        elif row["p_faster"] < alpha and row["change"] <= -threshold:
+            row["status"] = "improved"
+        else:
+            row["status"] = "ok"
+        rows.append(row)
+    return rows
+
+
+def print_rows(rows):
+    print(f"{'kernel':<20} {'params':<40} {'base ms':>10} {'new ms':>10} {'change':>8} {'p':>8}  status")
+    for r in rows:
+        if r["base_median"] is None:
+            print(f"{r['kernel']:<20} {r['params']:<40} {'-':>10} {'-':>10} {'-':>8} {'-':>8}  {r['status']}")
+            continue
+        p = r["p_slower"] if r["change"] >= 0 else r["p_faster"]
+        print(f"{r['kernel']:<20} {r['params']:<40} {r['base_median']:>10.4f} {r['new_median']:>10.4f} "
+              f"{r['change'] * 100:>+7.1f}% {p:>8.2g}  {r['status']}")
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Compare two benchmark record files")
+    parser.add_argument("baseline", help="baseline records (.jsonl or .csv)")
+    parser.add_argument("candidate", help="candidate records (.jsonl or .csv)")
+    parser.add_argument("--alpha", type=float, default=0.01, help="significance level (one-sided)")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="minimum relative increase of the median to report a regression")
+    args = parser.parse_args(argv)
+
+    rows = compare(load_records(args.baseline), load_records(args.candidate), args.alpha, args.threshold)
+    print_rows(rows)
+    regressions = [r for r in rows if r["status"] == "regression"]
+    if regressions:
+        print(f"{len(regressions)} regression(s) found.")
+        return 1
+    print("No regressions found.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,87 @@
+import os
+import random
+import tempfile
+
+from bench_record import BenchRecorder, load_records, summarize
+import bench_compare
+
+
+def write_records(path, records):
+    recorder = BenchRecorder(path)
+    for kernel, params, samples in records:
+        recorder.add(kernel, "bench_compare_test_sw", params, samples)
+    recorder.write()
+
+
+def samples(rng, center, n=30, spread=0.02):
+    return [rng.gauss(center, center * spread) for _ in range(n)]
+
+
+def test_summary():
+    s = summarize(range(100, 0, -1))
+    assert s["median"] == 50.5
+    assert abs(s["p99"] - 99.01) < 1e-9
+    assert abs(s["stddev"] - 29.011491975882016) < 1e-9
+    print("summary: matches common/bench_stats.h")
+
+
+def test_compare():
+    rng = random.Random(1)
+    base = [
+        ("vadd", {"size": 256}, samples(rng, 1.0)),
+        ("mm", {"size": 16}, samples(rng, 2.0)),
+        ("mv", {"size": 4096}, samples(rng, 5.0)),
+        ("vdot", {"size": 256}, samples(rng, 1.0)),
+        ("burst_64", {"burst_length": 64}, samples(rng, 3.0)),
+    ]
+    new = [
+        ("vadd", {"size": 256}, samples(rng, 1.10)),  # 10%遅い
+        ("mm", {"size": 16}, samples(rng, 2.0)),      # 変化なし
+        ("mv", {"size": 4096}, samples(rng, 4.0)),    # 20%速い
+        ("vdot", {"size": 256}, samples(rng, 1.02)),  # 閾値 (5%) 未満
+        ("mm", {"size": 32}, samples(rng, 8.0)),      # 新しい計測
+    ]
+    with tempfile.TemporaryDirectory() as tmp:
+        for ext in [".jsonl", ".csv"]:
+            base_path = os.path.join(tmp, "base" + ext)
+            new_path = os.path.join(tmp, "new" + ext)
+            write_records(base_path, base)
+            write_records(new_path, new)
+            rows = bench_compare.compare(load_records(base_path), load_records(new_path))
+            status = {(r["kernel"], r["params"]): r["status"] for r in rows}
+            assert status[("vadd", "size=256")] == "regression", status
+            assert status[("mm", "size=16")] == "ok", status
+            assert status[("mv", "size=4096")] == "improved", status
+            assert status[("vdot", "size=256")] == "ok", status
+            assert status[("mm", "size=32")] == "new", status
+            assert status[("burst_64", "burst_length=64")] == "missing", status
+
+            assert bench_compare.main([base_path, new_path]) == 1
+            assert bench_compare.main([base_path, base_path]) == 0
+    print("compare: regression, improvement and threshold detected (JSON Lines and CSV)")
+
+
+def test_appended_runs_and_key_order():
+    # 追記された複数回の実行はまとめ、パラメータの順序は比較に影響しない
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "runs.jsonl")
+        write_records(path, [("mv", {"rows": 32, "cols": 32}, [1.0, 2.0])])
+        write_records(path, [("mv", {"cols": 32, "rows": 32}, [3.0])])
+        groups = load_records(path)
+        assert groups == {("mv", "cols=32;rows=32"): [1.0, 2.0, 3.0]}, groups
+    print("load: appended runs merged")
+
+
+def test_small_samples():
+    # 反復が少なすぎる場合は有意にならない
+    p = bench_compare.mann_whitney_greater([1.0], [2.0])
+    assert p > 0.1, p
+    print("mann-whitney: single samples are not significant")
+
+
+if __name__ == "__main__":
+    test_summary()
+    test_compare()
+    test_appended_runs_and_key_order()
+    test_small_samples()
+    print("Python SW test successful!")
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include "bench_stats.h"
+
+// ベンチマーク結果の機械可読な記録。環境変数 BENCH_RECORDS にファイル名を指定すると、
+// 各計測 (カーネル名、パラメータ、反復ごとの時間、実行環境) をそのファイルへ追記する。
+// 拡張子が .csv ならCSV (1反復1行)、それ以外はJSON Lines (1計測1行)。
+// 形式は common/bench_record.py と同じで、common/bench_compare.py で2つのファイルを比較できる。
+
+// JSONの文字列リテラル (引用符を含む)
+inline std::string bench_json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+inline std::string bench_json_number(double v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+// CSVのフィールド (必要な場合だけ引用符で囲む)
+inline std::string bench_csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+    std::string out = "\"";
+    for (char c : s) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    return out + "\"";
+}
+
+// 実行環境 (ホスト名、OS、CPU、コンパイラ、時刻)。値はすべて文字列。
+class BenchEnv {
+public:
+    static BenchEnv collect() {
+        BenchEnv env;
+        char host[256] = {0};
+        if (gethostname(host, sizeof(host) - 1) == 0) {
+            env.set("host", host);
+        }
+        struct utsname u;
+        if (uname(&u) == 0) {
+            env.set("os", std::string(u.sysname) + " " + u.release + " " + u.machine);
+        }
+        env.set("cpu", cpu_model());
+#if defined(__GNUC__) && !defined(__clang__)
+        env.set("compiler", "gcc " __VERSION__);
+#else
+        env.set("compiler", __VERSION__);
+#endif
+        env.set("language", "c++");
+
+        char stamp[32];
+        std::time_t now = std::time(nullptr);
+        struct tm utc;
+        gmtime_r(&now, &utc);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        env.set("timestamp", stamp);
+        return env;
+    }
+
+    void set(const std::string& key, const std::string& value) {
+        for (auto& f : fields_) {
+            if (f.first == key) {
+                f.second = value;
+                return;
+            }
+        }
+        fields_.emplace_back(key, value);
+    }
+
+    std::string get(const std::string& key) const {
+        for (const auto& f : fields_) {
+            if (f.first == key) {
+                return f.second;
+            }
+        }
+        return "";
+    }
+
+    const std::vector<std::pair<std::string, std::string>>& fields() const { return fields_; }
+
+private:
+    static std::string cpu_model() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                size_t colon = line.find(':');
+                return colon == std::string::npos ? "" : line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+        }
+        return "";
+    }
+
+    std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+// 1つの計測 (カーネルとパラメータの組) の記録
+class BenchRecord {
+public:
+    BenchRecord(const std::string& kernel, const std::string& source) : kernel_(kernel), source_(source) {}
+
+    BenchRecord& param(const std::string& key, const std::string& value) {
+        params_.push_back({key, bench_json_string(value), value});
+        return *this;
+    }
+
+    BenchRecord& param(const std::string& key, const char* value) { return param(key, std::string(value)); }
+
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    BenchRecord& param(const std::string& key, T value) {
+        std::string text = std::is_integral<T>::value ? std::to_string(value) : bench_json_number(value);
+        params_.push_back({key, text, text});
+        return *this;
+    }
+
+    void add_sample(double ms) { samples_.push_back(ms); }
+    void set_samples(const std::vector<double>& samples) { samples_ = samples; }
+
+    const std::string& kernel() const { return kernel_; }
+    const std::vector<double>& samples() const { return samples_; }
+
+    // パラメータを "key=value;..." の形にしたもの (CSVの列、比較時のキー)
+    std::string params_text() const {
+        std::string out;
+        for (const Param& p : params_) {
+            out += (out.empty() ? "" : ";") + p.key + "=" + p.text;
+        }
+        return out;
+    }
+
+    std::string to_json(const BenchEnv& env) const {
+        std::string out = "{\"kernel\": " + bench_json_string(kernel_) + ", \"source\": " + bench_json_string(source_);
+        out += ", \"params\": {";
+        for (size_t i = 0; i < params_.size(); ++i) {
+            out += (i ? ", " : "") + bench_json_string(params_[i].key) + ": " + params_[i].json;
+        }
+        out += "}, \"unit\": \"ms\", \"samples\": [";
+        for (size_t i = 0; i < samples_.size(); ++i) {
+            out += (i ? ", " : "") + bench_json_number(samples_[i]);
+        }
+        BenchStats s = bench_summarize(samples_);
+        out += "], \"summary\": {\"count\": " + std::to_string(s.count) + ", \"min\": " + bench_json_number(s.min) +
+               ", \"median\": " + bench_json_number(s.median) + ", \"p99\": " + bench_json_number(s.p99) +
+               ", \"mean\": " + bench_json_number(s.mean) + ", \"stddev\": " + bench_json_number(s.stddev) + "}";
+        out += ", \"env\": {";
+        for (size_t i = 0; i < env.fields().size(); ++i) {
+            out += (i ? ", " : "") + bench_json_string(env.fields()[i].first) + ": " +
+                   bench_json_string(env.fields()[i].second);
+        }
+        return out + "}}";
+    }
+
+    // 1反復1行
+    std::string to_csv(const BenchEnv& env) const {
+        std::string prefix = bench_csv_field(kernel_) + "," + bench_csv_field(source_) + "," +
+                             bench_csv_field(params_text()) + ",";
+        std::string suffix = "," + bench_csv_field(env.get("host")) + "," + bench_csv_field(env.get("timestamp")) + "\n";
+        std::string out;
+        for (size_t i = 0; i < samples_.size(); ++i) {
+            out += prefix + std::to_string(i) + "," + bench_json_number(samples_[i]) + suffix;
+        }
+        return out;
+    }
+
+    static const char* csv_header() { return "kernel,source,params,iteration,time_ms,host,timestamp\n"; }
+
+private:
+    struct Param {
+        std::string key;
+        std::string json;  // JSONでの表現 (文字列は引用符付き)
+        std::string text;  // CSV・比較キーでの表現
+    };
+
+    std::string kernel_;
+    std::string source_;
+    std::vector<Param> params_;
+    std::vector<double> samples_;
+};
+
+// プロセス内の記録をまとめて書き出す。pathが空なら何も書かない。
+class BenchRecorder {
+public:
+    explicit BenchRecorder(const std::string& path = default_path()) : path_(path), env_(BenchEnv::collect()) {}
+
+    static std::string default_path() {
+        const char* path = std::getenv("BENCH_RECORDS");
+        return path ? path : "";
+    }
+
+    bool enabled() const { return !path_.empty(); }
+    const std::string& path() const { return path_; }
+    BenchEnv& env() { return env_; }
+
+    BenchRecord& add(const std::string& kernel, const std::string& source) {
+        records_.emplace_back(kernel, source);
+        return records_.back();
+    }
+
+    const std::deque<BenchRecord>& records() const { return records_; }
+
+    // ファイルへ追記する。書き込みに失敗した場合はfalse。
+    bool write() const {
+        if (!enabled()) {
+            return true;
+        }
+        bool csv = path_.size() >= 4 && path_.compare(path_.size() - 4, 4, ".csv") == 0;
+        bool fresh = !std::ifstream(path_).good();
+        std::ofstream out(path_, std::ios::app);
+        if (!out) {
+            return false;
+        }
+        if (csv && fresh) {
+            out << BenchRecord::csv_header();
+        }
+        for (const BenchRecord& r : records_) {
+            out << (csv ? r.to_csv(env_) : r.to_json(env_) + "\n");
+        }
+        return out.good();
+    }
+
+private:
+    std::string path_;
+    BenchEnv env_;
+    std::deque<BenchRecord> records_;  // add() が返す参照を保つためdeque
+};
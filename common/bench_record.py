@@ -0,0 +1,136 @@
+"""ベンチマーク結果の機械可読な記録 (common/bench_record.h と同じ形式)。
+
+環境変数 BENCH_RECORDS にファイル名を指定すると、write() で各計測をそのファイルへ追記する。
+拡張子が .csv ならCSV (1反復1行)、それ以外はJSON Lines (1計測1行)。
+"""
+import csv
+import datetime
+import json
+import os
+import platform
+import socket
+import statistics
+import sys
+
+CSV_HEADER = ["kernel", "source", "params", "iteration", "time_ms", "host", "timestamp"]
+
+
+def percentile(sorted_values, p):
+    """昇順の値のpパーセンタイル (numpyの既定と同じ線形補間)"""
+    if not sorted_values:
+        return 0.0
+    rank = p / 100.0 * (len(sorted_values) - 1)
+    lower = int(rank)
+    upper = min(lower + 1, len(sorted_values) - 1)
+    return sorted_values[lower] + (sorted_values[upper] - sorted_values[lower]) * (rank - lower)
+
+
+def summarize(samples):
+    values = sorted(float(v) for v in samples)
+    if not values:
+        return {"count": 0, "min": 0.0, "median": 0.0, "p99": 0.0, "mean": 0.0, "stddev": 0.0}
+    return {
+        "count": len(values),
+        "min": values[0],
+        "median": percentile(values, 50.0),
+        "p99": percentile(values, 99.0),
+        "mean": statistics.fmean(values),
+        "stddev": statistics.stdev(values) if len(values) > 1 else 0.0,
+    }
+
+
+def params_text(params):
+    """パラメータを "key=value;..." の形にしたもの (CSVの列、比較時のキー)"""
+    return ";".join(f"{k}={v}" for k, v in params.items())
+
+
+def collect_env():
+    env = {
+        "host": socket.gethostname(),
+        "os": f"{platform.system()} {platform.release()} {platform.machine()}",
+        "cpu": _cpu_model(),
+        "python": platform.python_version(),
+        "language": "python",
+        "timestamp": datetime.datetime.now(datetime.timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ"),
+    }
+    numpy = sys.modules.get("numpy")
+    if numpy is not None:
+        env["numpy"] = numpy.__version__
+    return env
+
+
+def _cpu_model():
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor()
+
+
+class BenchRecorder:
+    def __init__(self, path=None):
+        self.path = os.environ.get("BENCH_RECORDS", "") if path is None else path
+        self.env = collect_env()
+        self.records = []
+
+    @property
+    def enabled(self):
+        return bool(self.path)
+
+    def add(self, kernel, source, params, samples_ms):
+        """1つの計測 (カーネルとパラメータの組) を追加する。paramsは順序付きのdict。"""
+        record = {
+            "kernel": kernel,
+            "source": source,
+            "params": dict(params),
+            "unit": "ms",
+            "samples": [float(v) for v in samples_ms],
+        }
+        record["summary"] = summarize(record["samples"])
+        self.records.append(record)
+        return record
+
+    def write(self):
+        if not self.enabled:
+            return
+        fresh = not os.path.exists(self.path)
+        with open(self.path, "a", newline="") as f:
+            if self.path.endswith(".csv"):
+                writer = csv.writer(f, lineterminator="\n")
+                if fresh:
+                    writer.writerow(CSV_HEADER)
+                for r in self.records:
+                    for i, v in enumerate(r["samples"]):
+                        writer.writerow([r["kernel"], r["source"], params_text(r["params"]), i, repr(v),
+                                         self.env["host"], self.env["timestamp"]])
+            else:
+                for r in self.records:
+                    f.write(json.dumps(dict(r, env=self.env)) + "\n")
+
+
+def load_records(path):
+    """JSON LinesまたはCSVのファイルを読み、{(kernel, params_text): [samples]} を返す。
+    同じキーが複数回現れた場合 (複数回の実行を追記したファイル) は反復時間をまとめる。"""
+    groups = {}
+    if path.endswith(".csv"):
+        with open(path, newline="") as f:
+            for row in csv.DictReader(f):
+                key = (row["kernel"], _normalize(row["params"]))
+                groups.setdefault(key, []).append(float(row["time_ms"]))
+    else:
+        with open(path) as f:
+            for line in f:
+                if not line.strip():
+                    continue
+                r = json.loads(line)
+                key = (r["kernel"], _normalize(params_text(r["params"])))
+                groups.setdefault(key, []).extend(float(v) for v in r["samples"])
+    return groups
+
+
+def _normalize(text):
+    # キーの順序に依存しないように並べ替える
+    return ";".join(sorted(p for p in text.split(";") if p))
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_record.h"
+#include "test_check.h"
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void fill(BenchRecorder& recorder) {
+    recorder.env().set("xclbin", "vadd.xclbin");
+    BenchRecord& a = recorder.add("vadd", "vadd_test_hw").param("size", 256).param("path", "mapped");
+    a.set_samples({1.5, 1.25, 2.0});
+    BenchRecord& b = recorder.add("burst_64", "burst_test_hw").param("burst_length", 128).param("mhz", 300.5);
+    b.add_sample(0.5);
+    b.add_sample(0.75);
+}
+
+// JSON Linesは1計測1行で、パラメータの型と反復時間、環境を含む
+bool test_json() {
+    const std::string path = "bench_record_test.jsonl";
+    std::remove(path.c_str());
+    BenchRecorder recorder(path);
+    fill(recorder);
+
+    bool ok = true;
+    ok &= check(recorder.write(), "write succeeds");
+    ok &= check(recorder.write(), "second write appends");
+    std::vector<std::string> lines = read_lines(path);
+    ok &= check(lines.size() == 4, "one line per record, appended");
+    const std::string& line = lines[0];
+    ok &= check(line.find("\"kernel\": \"vadd\"") != std::string::npos, "kernel");
+    ok &= check(line.find("\"params\": {\"size\": 256, \"path\": \"mapped\"}") != std::string::npos,
+                "numbers unquoted, strings quoted, order kept");
+    ok &= check(line.find("\"samples\": [1.5, 1.25, 2]") != std::string::npos, "per-iteration samples");
+    ok &= check(line.find("\"median\": 1.5") != std::string::npos, "summary");
+    ok &= check(line.find("\"xclbin\": \"vadd.xclbin\"") != std::string::npos, "caller env fields");
+    ok &= check(line.find("\"timestamp\": \"") != std::string::npos && line.find("\"host\": \"") != std::string::npos,
+                "collected env fields");
+    ok &= check(lines[1].find("\"mhz\": 300.5") != std::string::npos, "floating point parameter");
+    std::remove(path.c_str());
+    return ok;
+}
+
+// CSVは1反復1行で、ヘッダーは新しいファイルにだけ書く
+bool test_csv() {
+    const std::string path = "bench_record_test.csv";
+    std::remove(path.c_str());
+    BenchRecorder recorder(path);
+    fill(recorder);
+
+    bool ok = true;
+    ok &= check(recorder.write() && recorder.write(), "write succeeds");
+    std::vector<std::string> lines = read_lines(path);
+    ok &= check(lines.size() == 1 + 2 * 5, "header once, one row per iteration");
+    ok &= check(lines[0] + "\n" == BenchRecord::csv_header(), "header");
+    ok &= check(lines[1].compare(0, 38, "vadd,vadd_test_hw,size=256;path=mapped") == 0, "params column");
+    ok &= check(lines[1].find(",0,1.5,") != std::string::npos && lines[3].find(",2,2,") != std::string::npos,
+                "iteration and time columns");
+    std::remove(path.c_str());
+    return ok;
+}
+
+bool test_escape_and_disabled() {
+    bool ok = true;
+    ok &= check(bench_json_string("a\"b\\c\n") == "\"a\\\"b\\\\c\\n\"", "JSON escape");
+    ok &= check(bench_csv_field("a,b") == "\"a,b\"" && bench_csv_field("x\"y") == "\"x\"\"y\"", "CSV quoting");
+
+    BenchRecorder disabled("");
+    disabled.add("mm", "mm_test_hw").add_sample(1.0);
+    ok &= check(!disabled.enabled() && disabled.write(), "empty path writes nothing");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running BenchRecord software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_json();
+    ok &= test_csv();
+    ok &= test_escape_and_disabled();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
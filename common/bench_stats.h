@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// ベンチマークの計測値 (ms など) の要約統計
+struct BenchStats {
+    size_t count = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;  // 標本標準偏差 (n - 1で割る)
+};
+
+// 昇順に並んだ値のpパーセンタイル (0 <= p <= 100)。隣り合う順位の間は線形補間する (numpyの既定と同じ)。
+inline double bench_percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    double rank = p / 100.0 * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double frac = rank - lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * frac;
+}
+
+inline BenchStats bench_summarize(std::vector<double> samples) {
+    BenchStats s;
+    s.count = samples.size();
+    if (samples.empty()) {
+        return s;
+    }
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.front();
+    s.max = samples.back();
+    s.median = bench_percentile(samples, 50.0);
+    s.p99 = bench_percentile(samples, 99.0);
+
+    double sum = 0.0;
+    for (double v : samples) {
+        sum += v;
+    }
+    s.mean = sum / samples.size();
+
+    if (samples.size() > 1) {
+        double sq = 0.0;
+        for (double v : samples) {
+            sq += (v - s.mean) * (v - s.mean);
+        }
+        s.stddev = std::sqrt(sq / (samples.size() - 1));
+    }
+    return s;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "bench_stats.h"
+#include "test_check.h"
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9 * (1.0 + std::fabs(b));
+}
+
+// 1..100 (順不同) の統計値をnumpyで求めた値と比べる
+bool test_known_values() {
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; --i) {
+        samples.push_back(i);
+    }
+    BenchStats s = bench_summarize(samples);
+
+    bool ok = true;
+    ok &= check(s.count == 100, "count");
+    ok &= check(s.min == 1.0 && s.max == 100.0, "min/max");
+    ok &= check(near(s.median, 50.5), "median interpolates between the middle values");
+    ok &= check(near(s.p99, 99.01), "p99 interpolates like numpy.percentile");
+    ok &= check(near(s.mean, 50.5), "mean");
+    ok &= check(near(s.stddev, 29.011491975882016), "sample standard deviation");
+    return ok;
+}
+
+// 要素数が0・1・奇数の場合
+bool test_small_inputs() {
+    bool ok = true;
+    BenchStats empty = bench_summarize({});
+    ok &= check(empty.count == 0 && empty.median == 0.0, "empty input");
+
+    BenchStats one = bench_summarize({3.5});
+    ok &= check(one.min == 3.5 && one.median == 3.5 && one.p99 == 3.5 && one.stddev == 0.0, "single sample");
+
+    BenchStats odd = bench_summarize({5.0, 1.0, 3.0});
+    ok &= check(odd.median == 3.0, "odd count median is the middle value");
+    ok &= check(near(odd.p99, 4.96), "odd count p99");
+    ok &= check(near(odd.stddev, 2.0), "odd count stddev");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running BenchStats software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_known_values();
+    ok &= test_small_inputs();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
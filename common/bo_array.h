@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "mapped_bo.h"
+
+// MappedBoのホストメモリをそのまま参照するnumpy配列を作る (コピーなし)。
+// 配列はMappedBoへの参照を保持するため、ランナーが別のバッファに切り替えた後も安全に使える。
+template <typename T>
+pybind11::array_t<T> bo_array(const std::shared_ptr<MappedBo<T>>& buffer, std::vector<pybind11::ssize_t> shape) {
+    auto* holder = new std::shared_ptr<MappedBo<T>>(buffer);
+    pybind11::capsule owner(holder, [](void* p) { delete static_cast<std::shared_ptr<MappedBo<T>>*>(p); });
+    return pybind11::array_t<T>(shape, buffer->data(), owner);
+}
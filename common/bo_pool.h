@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_device.h>
+
+// サイズ別バケットでxrt::boを再利用するプール。
+// 要求サイズを2のべき乗 (最小4KiB) に切り上げ、同じメモリグループ・同じバケットの空きBOがあれば再利用する。
+// byte_budgetが0以外の場合は確保済みの総バイト数をその範囲に収め、足りなければ空きBOを解放する。
+class BOPool {
+public:
+    struct Stats {
+        size_t allocations = 0;
+        size_t reuses = 0;
+        size_t evictions = 0;
+        size_t bytes_allocated = 0;
+        size_t bytes_in_use = 0;
+    };
+
+    // acquire()で貸し出したBO。破棄時にプールへ返却する。プールより長く保持しないこと。
+    class Buffer {
+    public:
+        Buffer() = default;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        Buffer(Buffer&& other) noexcept { *this = std::move(other); }
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                release();
+                pool_ = other.pool_;
+                bo_ = std::move(other.bo_);
+                group_ = other.group_;
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+        ~Buffer() { release(); }
+
+        xrt::bo& bo() { return bo_; }
+        size_t capacity() const { return bo_.size(); }
+
+    private:
+        friend class BOPool;
+        Buffer(BOPool* pool, xrt::bo bo, xrt::memory_group group) : pool_(pool), bo_(std::move(bo)), group_(group) {}
+
+        void release() {
+            if (pool_) {
+                pool_->give_back(std::move(bo_), group_);
+                pool_ = nullptr;
+            }
+        }
+
+        BOPool* pool_ = nullptr;
+        xrt::bo bo_;
+        xrt::memory_group group_ = 0;
+    };
+
+    explicit BOPool(const xrt::device& device, size_t byte_budget = 0) : device_(device), byte_budget_(byte_budget) {}
+
+    static size_t bucket_size(size_t bytes) {
+        size_t bucket = 4096;
+        while (bucket < bytes) {
+            bucket <<= 1;
+        }
+        return bucket;
+    }
+
+    Buffer acquire(size_t bytes, xrt::memory_group group) {
+        const size_t bucket = bucket_size(bytes);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = idle_.find(Key(group, bucket));
+        if (it != idle_.end() && !it->second.empty()) {
+            xrt::bo bo = std::move(it->second.back());
+            it->second.pop_back();
+            stats_.reuses++;
+            stats_.bytes_in_use += bucket;
+            return Buffer(this, std::move(bo), group);
+        }
+
+        if (byte_budget_ != 0) {
+            if (bucket > byte_budget_) {
+                throw std::runtime_error("Requested buffer exceeds the BO pool byte budget.");
+            }
+            while (stats_.bytes_allocated + bucket > byte_budget_) {
+                if (!evict_largest_idle()) {
+                    throw std::runtime_error("BO pool byte budget exhausted by buffers in use.");
+                }
+            }
+        }
+
+        xrt::bo bo(device_, bucket, group);
+        stats_.allocations++;
+        stats_.bytes_allocated += bucket;
+        stats_.bytes_in_use += bucket;
+        return Buffer(this, std::move(bo), group);
+    }
+
+    // 空きBOをすべて解放する
+    void trim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (evict_largest_idle()) {
+        }
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    using Key = std::pair<xrt::memory_group, size_t>;
+
+    void give_back(xrt::bo bo, xrt::memory_group group) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t bucket = bo.size();
+        stats_.bytes_in_use -= bucket;
+        idle_[Key(group, bucket)].push_back(std::move(bo));
+    }
+
+    bool evict_largest_idle() {
+        auto victim = idle_.end();
+        for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+            if (!it->second.empty() && (victim == idle_.end() || it->first.second > victim->first.second)) {
+                victim = it;
+            }
+        }
+        if (victim == idle_.end()) {
+            return false;
+        }
+        victim->second.pop_back();
+        stats_.evictions++;
+        stats_.bytes_allocated -= victim->first.second;
+        return true;
+    }
+
+    xrt::device device_;
+    size_t byte_budget_;
+    mutable std::mutex mutex_;
+    std::map<Key, std::vector<xrt::bo>> idle_;
+    Stats stats_;
+};
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <iostream>
+#include <stdexcept>
+
+#include "xrt_fake.h"
+#include "bo_pool.h"
+#include "test_check.h"
+
+// 同じサイズを繰り返し要求しても、BOの確保は最初の1回だけ
+bool test_reuse() {
+    xrt_fake::reset_counters();
+    xrt::device device(0);
+    BOPool pool(device);
+
+    for (int i = 0; i < 100; ++i) {
+        auto a = pool.acquire(1000 * sizeof(int), 0);
+        auto b = pool.acquire(1000 * sizeof(int), 1);
+        auto c = pool.acquire(1000 * sizeof(int), 2);
+    }
+
+    bool ok = true;
+    ok &= check(xrt_fake::counters().bo_allocs == 3, "three allocations for 100 iterations");
+    ok &= check(pool.stats().reuses == 297, "remaining requests are reuses");
+    ok &= check(pool.stats().bytes_in_use == 0, "all buffers returned");
+    return ok;
+}
+
+// バケット内の異なるサイズは同じBOを共有し、大きなサイズでは新しいバケットを確保する
+bool test_buckets_grow() {
+    xrt_fake::reset_counters();
+    xrt::device device(0);
+    BOPool pool(device);
+
+    bool ok = true;
+    ok &= check(BOPool::bucket_size(0) == 4096, "minimum bucket");
+    ok &= check(BOPool::bucket_size(4097) == 8192, "round up to power of two");
+
+    { auto a = pool.acquire(5000, 0); ok &= check(a.capacity() == 8192, "capacity is bucket size"); }
+    { auto a = pool.acquire(7000, 0); }
+    ok &= check(xrt_fake::counters().bo_allocs == 1, "same bucket reused");
+
+    { auto a = pool.acquire(100000, 0); }
+    ok &= check(xrt_fake::counters().bo_allocs == 2, "larger request grows the pool");
+
+    { auto a = pool.acquire(5000, 1); }
+    ok &= check(xrt_fake::counters().bo_allocs == 3, "memory groups are not shared");
+
+    {
+        auto a = pool.acquire(5000, 0);
+        auto b = pool.acquire(5000, 0);
+    }
+    ok &= check(xrt_fake::counters().bo_allocs == 4, "concurrent use allocates a second buffer");
+    return ok;
+}
+
+// 上限を超える場合は空きBOを解放し、使用中のBOだけで超える場合は例外
+bool test_budget() {
+    xrt_fake::reset_counters();
+    xrt::device device(0);
+    BOPool pool(device, 64 * 1024);
+
+    bool ok = true;
+    { auto a = pool.acquire(32 * 1024, 0); }
+    { auto b = pool.acquire(16 * 1024, 0); }
+    ok &= check(pool.stats().bytes_allocated == 48 * 1024, "idle buffers kept within budget");
+
+    { auto c = pool.acquire(32 * 1024, 1); }
+    ok &= check(pool.stats().evictions == 1, "largest idle buffer evicted");
+    ok &= check(pool.stats().bytes_allocated <= 64 * 1024, "budget respected");
+
+    auto d = pool.acquire(64 * 1024, 0);
+    bool thrown = false;
+    try {
+        auto e = pool.acquire(4096, 0);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ok &= check(thrown, "exhausted budget throws");
+
+    thrown = false;
+    try {
+        auto f = pool.acquire(128 * 1024, 0);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ok &= check(thrown, "request larger than budget throws");
+
+    pool.trim();
+    ok &= check(pool.stats().bytes_allocated == 64 * 1024, "trim keeps buffers in use");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running BOPool software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_reuse();
+    ok &= test_buckets_grow();
+    ok &= test_budget();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
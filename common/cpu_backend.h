@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parallel_data.h"
+
+// FPGAを使わないときのCPUバックエンド。vadd、int8のvdot、行列積 (GEMM)、行列ベクトル積 (GEMV) を
+// SIMDと複数スレッドで計算する。結果はHLSカーネル (intの積和は32ビットで折り返す) と一致する。
+//
+// SIMDはGCCのベクトル拡張 (512ビット = intが16個) で書き、target_clonesでAVX-512・AVX2・既定の版を
+// 生成して実行時にCPUに合ったものを選ぶ。-march などのビルドフラグは要らない。
+// 各ランナーは select_backend() で生成時にFPGAとCPUのどちらを使うか決める。
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define CPU_BACKEND_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define CPU_BACKEND_CLONES
+#endif
+
+typedef int cpu_v16i __attribute__((vector_size(64)));
+
+const int CPU_LANES = 16;                    // 1ベクトルあたりのint数
+const size_t CPU_MIN_PARALLEL = 1 << 16;     // これより小さい処理は1スレッドで行う
+
+// ベクトルは値渡しにしない (呼び出し規約がAVX-512の有無で変わるため)。いずれもクローンの中へインライン展開される。
+inline void cpu_load(cpu_v16i& v, const int* p) {
+    std::memcpy(&v, p, sizeof(v));
+}
+
+inline void cpu_store(int* p, const cpu_v16i& v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline int cpu_reduce(const cpu_v16i& v) {
+    unsigned int sum = 0;
+    for (int l = 0; l < CPU_LANES; ++l) {
+        sum += static_cast<unsigned int>(v[l]);
+    }
+    return static_cast<int>(sum);
+}
+
+// 仕事量がwork (おおよその要素数) の処理に使うスレッド数
+inline int cpu_threads_for(size_t work) {
+    return work < CPU_MIN_PARALLEL ? 1 : parallel_data_threads();
+}
+
+// c = a + b
+CPU_BACKEND_CLONES
+inline void cpu_vadd_range(const int* a, const int* b, int* c, size_t begin, size_t end) {
+    size_t i = begin;
+    for (; i + CPU_LANES <= end; i += CPU_LANES) {
+        cpu_v16i va, vb;
+        cpu_load(va, a + i);
+        cpu_load(vb, b + i);
+        cpu_store(c + i, va + vb);
+    }
+    for (; i < end; ++i) {
+        c[i] = static_cast<int>(static_cast<unsigned int>(a[i]) + static_cast<unsigned int>(b[i]));
+    }
+}
+
+inline void cpu_vadd(const int* a, const int* b, int* c, size_t size) {
+    parallel_for_range(size, [=](size_t begin, size_t end) { cpu_vadd_range(a, b, c, begin, end); },
+                       cpu_threads_for(size));
+}
+
+// int8の内積。16本の32ビットのレーンに積和し、溢れる前 (2^16要素ごと) に64ビットへ足し込む。
+// 8ビットの要素はベクトル拡張では効率よく広げられないため、レーンの配列で書いてコンパイラにSIMD化させる。
+CPU_BACKEND_CLONES
+inline long long cpu_vdot_range(const signed char* a, const signed char* b, size_t begin, size_t end) {
+    const size_t BLOCK = 1 << 16;  // 1レーンあたり 128*128*2^12 = 2^26 で32ビットに収まる
+    long long total = 0;
+    size_t i = begin;
+    while (i + CPU_LANES <= end) {
+        size_t block_end = std::min(end, i + BLOCK);
+        int lanes[CPU_LANES] = {0};
+        for (; i + CPU_LANES <= block_end; i += CPU_LANES) {
+            for (int l = 0; l < CPU_LANES; ++l) {
+                lanes[l] += a[i + l] * b[i + l];
+            }
+        }
+        for (int l = 0; l < CPU_LANES; ++l) {
+            total += lanes[l];
+        }
+    }
+    for (; i < end; ++i) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+inline long long cpu_vdot(const char* a, const char* b, size_t size) {
+    const signed char* sa = reinterpret_cast<const signed char*>(a);
+    const signed char* sb = reinterpret_cast<const signed char*>(b);
+    int threads = cpu_threads_for(size);
+    std::vector<long long> partial(threads, 0);
+    size_t step = (size + threads - 1) / threads;
+    parallel_for_range(size, [&](size_t begin, size_t end) {
+        partial[begin / std::max<size_t>(step, 1)] = cpu_vdot_range(sa, sb, begin, end);
+    }, threads);
+    long long total = 0;
+    for (long long p : partial) {
+        total += p;
+    }
+    return total;
+}
+
+// GEMMのブロック: Bの GEMM_KB x GEMM_NB (256 x 512 int = 512KiB) をL2に載せたまま使い回す
+const int CPU_GEMM_KB = 256;
+const int CPU_GEMM_NB = 512;
+
+// c[row_begin:row_end] = a * b  (a: m x k, b: k x n, c: m x n、すべて行優先)
+CPU_BACKEND_CLONES
+inline void cpu_gemm_rows(const int* a, const int* b, int* c, int k, int n, size_t row_begin, size_t row_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+        std::fill(c + i * n, c + (i + 1) * n, 0);
+    }
+    for (int jb = 0; jb < n; jb += CPU_GEMM_NB) {
+        const int j_end = std::min(n, jb + CPU_GEMM_NB);
+        for (int kb = 0; kb < k; kb += CPU_GEMM_KB) {
+            const int k_end = std::min(k, kb + CPU_GEMM_KB);
+            for (size_t i = row_begin; i < row_end; ++i) {
+                int* c_row = c + i * n;
+                const int* a_row = a + i * k;
+                for (int kk = kb; kk < k_end; ++kk) {
+                    const cpu_v16i aik = cpu_v16i{} + a_row[kk];
+                    const int* b_row = b + static_cast<size_t>(kk) * n;
+                    int j = jb;
+                    for (; j + CPU_LANES <= j_end; j += CPU_LANES) {
+                        cpu_v16i vb, vc;
+                        cpu_load(vb, b_row + j);
+                        cpu_load(vc, c_row + j);
+                        cpu_store(c_row + j, vc + aik * vb);
+                    }
+                    for (; j < j_end; ++j) {
+                        c_row[j] = static_cast<int>(static_cast<unsigned int>(c_row[j]) +
+                                                    static_cast<unsigned int>(a_row[kk]) * static_cast<unsigned int>(b_row[j]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline void cpu_gemm(const int* a, const int* b, int* c, int m, int k, int n) {
+    size_t work = static_cast<size_t>(m) * k * n / CPU_LANES;
+    parallel_for_range(m, [=](size_t begin, size_t end) { cpu_gemm_rows(a, b, c, k, n, begin, end); },
+                       std::min<int>(cpu_threads_for(work), std::max(1, m / 4)));
+}
+
+// batch個の独立した行列積。n番目は a + n*m*k、b + n*k*n、c + n*m*n。小さな行列を想定し、行列単位でスレッドに分ける。
+inline void cpu_gemm_batch(const int* a, const int* b, int* c, int batch, int m, int k, int n) {
+    const size_t a_size = static_cast<size_t>(m) * k, b_size = static_cast<size_t>(k) * n, c_size = static_cast<size_t>(m) * n;
+    size_t work = static_cast<size_t>(batch) * m * k * n / CPU_LANES;
+    parallel_for_range(batch, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            cpu_gemm_rows(a + i * a_size, b + i * b_size, c + i * c_size, k, n, 0, m);
+        }
+    }, cpu_threads_for(work));
+}
+
+// y[row_begin:row_end] = a * x  (a: rows x cols、行優先)
+CPU_BACKEND_CLONES
+inline void cpu_gemv_rows(const int* a, const int* x, int* y, int cols, size_t row_begin, size_t row_end) {
+    for (size_t i = row_begin; i < row_end; ++i) {
+        const int* row = a + i * cols;
+        cpu_v16i acc = {0};
+        int j = 0;
+        for (; j + CPU_LANES <= cols; j += CPU_LANES) {
+            cpu_v16i va, vx;
+            cpu_load(va, row + j);
+            cpu_load(vx, x + j);
+            acc += va * vx;
+        }
+        unsigned int sum = static_cast<unsigned int>(cpu_reduce(acc));
+        for (; j < cols; ++j) {
+            sum += static_cast<unsigned int>(row[j]) * static_cast<unsigned int>(x[j]);
+        }
+        y[i] = static_cast<int>(sum);
+    }
+}
+
+inline void cpu_gemv(const int* a, const int* x, int* y, int rows, int cols) {
+    size_t work = static_cast<size_t>(rows) * cols;
+    parallel_for_range(rows, [=](size_t begin, size_t end) { cpu_gemv_rows(a, x, y, cols, begin, end); },
+                       cpu_threads_for(work));
+}
+
+// 実行に使うバックエンド
+enum class Backend { fpga, cpu };
+
+inline const char* backend_name(Backend backend) {
+    return backend == Backend::fpga ? "fpga" : "cpu";
+}
+
+// requested: "fpga" (FPGAのみ、開けなければ例外)、"cpu"、"auto" (FPGAを開けなければCPU)。
+// open_fpga() はデバイスとxclbinを開き、使えない場合は例外を投げる関数。
+template <typename OpenFpga>
+Backend select_backend(const std::string& requested, OpenFpga open_fpga) {
+    if (requested == "cpu") {
+        return Backend::cpu;
+    }
+    if (requested == "fpga") {
+        open_fpga();
+        return Backend::fpga;
+    }
+    if (requested != "auto") {
+        throw std::invalid_argument("backend must be \"auto\", \"fpga\" or \"cpu\": " + requested);
+    }
+    try {
+        open_fpga();
+        return Backend::fpga;
+    } catch (const std::exception&) {
+        return Backend::cpu;
+    }
+}
+
+// CPUバックエンドの submit/wait。計算はsubmit()の時点で終わるので、結果をチケットで預かるだけ。
+// InflightQueue と同じ呼び出し方ができる。
+template <typename Result>
+class CpuTickets {
+public:
+    uint64_t submit(Result result) {
+        uint64_t ticket = next_++;
+        results_.emplace(ticket, std::move(result));
+        return ticket;
+    }
+
+    Result wait(uint64_t ticket) {
+        auto it = results_.find(ticket);
+        if (it == results_.end()) {
+            throw std::runtime_error("CpuTickets: unknown ticket " + std::to_string(ticket));
+        }
+        Result result = std::move(it->second);
+        results_.erase(it);
+        return result;
+    }
+
+    // 最も古い結果を返す
+    std::pair<uint64_t, Result> wait_any() {
+        if (results_.empty()) {
+            throw std::runtime_error("CpuTickets: nothing in flight");
+        }
+        uint64_t ticket = results_.begin()->first;
+        return {ticket, wait(ticket)};
+    }
+
+    size_t pending() const { return results_.size(); }
+
+private:
+    uint64_t next_ = 0;
+    std::map<uint64_t, Result> results_;
+};
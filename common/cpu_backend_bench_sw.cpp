@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "bench_record.h"
+#include "ap_int.h"
+#include "cpu_backend.h"
+#include "mm_tiling.h"
+#include "mv_pack.h"
+
+// スカラーのシミュレーション経路 (各サンプルの *_module_sw と同じくHLSカーネルのソースを直接呼ぶ)
+extern "C" void vadd(const int* a, const int* b, int* c, const int size);
+extern "C" void vdot(const char* a, const char* b, long long* result, int size);
+extern "C" void mm(const int* a, const int* b, int* c, int size, int batch, int a_step);
+extern "C" void mv(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch);
+
+const int NUM_ITERATIONS = 5;
+
+// MMSim::matmul と同じく16x16タイルに分けてmm()を呼ぶ
+static void scalar_matmul(const int* a, const int* b, int* c, int m, int k, int n) {
+    MMTilePlan plan(m, k, n);
+    std::vector<int> a_panels(plan.a_panels_size());
+    std::vector<int> b_panels(plan.b_panels_size());
+    std::vector<int> c_tiles(plan.c_tiles_size());
+    mm_tiled(plan, a, b, c, a_panels.data(), b_panels.data(), c_tiles.data(), [&] {
+        for (int rt = 0; rt < plan.row_tiles; rt++) {
+            mm(a_panels.data() + rt * plan.a_stride, b_panels.data(), c_tiles.data() + plan.c_offset(rt, 0),
+               plan.depth, plan.col_tiles, 0);
+        }
+    });
+}
+
+static BenchRecord& measure(BenchRecorder& recorder, const char* kernel, const char* backend, const char* shape,
+                            const std::function<void()>& fn) {
+    BenchRecord& record = recorder.add(kernel, "cpu_backend_bench_sw").param("backend", backend).param("shape", shape);
+    fn();  // ウォームアップ
+    for (int i = 0; i < NUM_ITERATIONS; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        record.add_sample(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return record;
+}
+
+static void print_row(const char* kernel, const char* shape, const BenchRecord& scalar, const BenchRecord& cpu, bool match) {
+    double scalar_ms = bench_summarize(scalar.samples()).median;
+    double cpu_ms = bench_summarize(cpu.samples()).median;
+    printf("%6s %16s %12.3f %12.3f %9.1fx %6s\n", kernel, shape, scalar_ms, cpu_ms, scalar_ms / cpu_ms,
+           match ? "ok" : "DIFF");
+}
+
+// 各演算について、スカラーのシミュレーション経路とCPUバックエンドの時間 (中央値) と結果の一致を表示する
+int main() {
+    const int VADD_SIZE = 16 << 20;
+    const int VDOT_SIZE = 64 << 20;
+    const int GEMM_SIZE = 512;
+    const int GEMV_ROWS = 4096, GEMV_COLS = 4096;
+
+    std::vector<int> a(VADD_SIZE), b(VADD_SIZE), c_scalar(VADD_SIZE), c_cpu(VADD_SIZE);
+    for (int i = 0; i < VADD_SIZE; ++i) {
+        a[i] = rand() % 201 - 100;
+        b[i] = rand() % 201 - 100;
+    }
+    std::vector<char> a8(VDOT_SIZE), b8(VDOT_SIZE);
+    for (int i = 0; i < VDOT_SIZE; ++i) {
+        a8[i] = static_cast<char>(rand() % 256 - 128);
+        b8[i] = static_cast<char>(rand() % 256 - 128);
+    }
+
+    BenchRecorder recorder;
+    bool all_match = true;
+    printf("CPU backend: %d threads\n", parallel_data_threads());
+    printf("%6s %16s %12s %12s %10s %6s\n", "kernel", "shape", "scalar ms", "cpu ms", "speedup", "check");
+
+    {
+        BenchRecord& s = measure(recorder, "vadd", "scalar", "16M", [&] { vadd(a.data(), b.data(), c_scalar.data(), VADD_SIZE); });
+        BenchRecord& v = measure(recorder, "vadd", "cpu", "16M", [&] { cpu_vadd(a.data(), b.data(), c_cpu.data(), VADD_SIZE); });
+        bool match = c_scalar == c_cpu;
+        print_row("vadd", "16M", s, v, match);
+        all_match &= match;
+    }
+    {
+        long long r_scalar = 0, r_cpu = 0;
+        BenchRecord& s = measure(recorder, "vdot", "scalar", "64M", [&] { vdot(a8.data(), b8.data(), &r_scalar, VDOT_SIZE); });
+        BenchRecord& v = measure(recorder, "vdot", "cpu", "64M", [&] { r_cpu = cpu_vdot(a8.data(), b8.data(), VDOT_SIZE); });
+        print_row("vdot", "64M", s, v, r_scalar == r_cpu);
+        all_match &= r_scalar == r_cpu;
+    }
+    {
+        const size_t count = static_cast<size_t>(GEMM_SIZE) * GEMM_SIZE;
+        std::vector<int> m_scalar(count), m_cpu(count);
+        BenchRecord& s = measure(recorder, "mm", "scalar", "512x512x512", [&] {
+            scalar_matmul(a.data(), b.data(), m_scalar.data(), GEMM_SIZE, GEMM_SIZE, GEMM_SIZE);
+        });
+        BenchRecord& v = measure(recorder, "mm", "cpu", "512x512x512", [&] {
+            cpu_gemm(a.data(), b.data(), m_cpu.data(), GEMM_SIZE, GEMM_SIZE, GEMM_SIZE);
+        });
+        print_row("mm", "512x512x512", s, v, m_scalar == m_cpu);
+        all_match &= m_scalar == m_cpu;
+    }
+    {
+        std::vector<int> y_scalar(GEMV_ROWS), y_cpu(GEMV_ROWS);
+        BenchRecord& s = measure(recorder, "mv", "scalar", "4096x4096", [&] {
+            // aはVADD_SIZE要素で、4096x4096はワードの倍数なのでそのままワード列として渡せる
+            mv(reinterpret_cast<const ap_uint<512>*>(a.data()), b.data(), y_scalar.data(), GEMV_ROWS, GEMV_COLS, 1);
+        });
+        BenchRecord& v = measure(recorder, "mv", "cpu", "4096x4096", [&] {
+            cpu_gemv(a.data(), b.data(), y_cpu.data(), GEMV_ROWS, GEMV_COLS);
+        });
+        print_row("mv", "4096x4096", s, v, y_scalar == y_cpu);
+        all_match &= y_scalar == y_cpu;
+    }
+
+    if (!recorder.write()) {
+        fprintf(stderr, "Failed to write benchmark records to %s\n", recorder.path().c_str());
+    }
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "ap_int.h"
+#include "cpu_backend.h"
+#include "mm_tiling.h"
+#include "mv_pack.h"
+#include "test_check.h"
+
+// スカラーのシミュレーション経路 (各サンプルのHLSカーネルのソース)
+extern "C" void vadd(const int* a, const int* b, int* c, const int size);
+extern "C" void vdot(const char* a, const char* b, long long* result, int size);
+extern "C" void mv(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch);
+
+static std::vector<int> random_ints(size_t count, int lo, int hi) {
+    std::vector<int> v(count);
+    for (auto& x : v) {
+        x = lo + rand() % (hi - lo + 1);
+    }
+    return v;
+}
+
+// ベクトル幅の倍数でない長さと、複数スレッドに分かれる長さ
+bool test_vadd() {
+    bool ok = true;
+    for (size_t size : {size_t(0), size_t(1), size_t(17), size_t(1000), CPU_MIN_PARALLEL * 3 + 5}) {
+        std::vector<int> a = random_ints(size, -1000000, 1000000);
+        std::vector<int> b = random_ints(size, -1000000, 1000000);
+        std::vector<int> expected(size), result(size);
+        vadd(a.data(), b.data(), expected.data(), size);
+        cpu_vadd(a.data(), b.data(), result.data(), size);
+        ok &= check(result == expected, "cpu_vadd matches the vadd kernel");
+    }
+    return ok;
+}
+
+// int8の内積。全要素が-128のときは32ビットのレーンが溢れないことを確認する。
+bool test_vdot() {
+    bool ok = true;
+    for (size_t size : {size_t(0), size_t(5), size_t(63), size_t(100000), size_t(1) << 20}) {
+        std::vector<char> a(size), b(size);
+        for (size_t i = 0; i < size; ++i) {
+            a[i] = static_cast<char>(rand() % 256 - 128);
+            b[i] = static_cast<char>(rand() % 256 - 128);
+        }
+        long long expected = 0;
+        vdot(a.data(), b.data(), &expected, size);
+        ok &= check(cpu_vdot(a.data(), b.data(), size) == expected, "cpu_vdot matches the vdot kernel");
+    }
+    const size_t size = 3 << 20;
+    std::vector<char> a(size, static_cast<char>(-128)), b(size, static_cast<char>(-128));
+    ok &= check(cpu_vdot(a.data(), b.data(), size) == 16384LL * static_cast<long long>(size), "no 32-bit overflow");
+    return ok;
+}
+
+// 任意の形の行列積。ブロックの端をまたぐ形と、16x16タイルのmmと同じ形。
+bool test_gemm() {
+    bool ok = true;
+    const int shapes[][3] = {{1, 1, 1}, {16, 16, 16}, {3, 300, 17}, {33, 257, 520}, {200, 64, 40}};
+    for (const auto& s : shapes) {
+        int m = s[0], k = s[1], n = s[2];
+        std::vector<int> a = random_ints(static_cast<size_t>(m) * k, -100, 100);
+        std::vector<int> b = random_ints(static_cast<size_t>(k) * n, -100, 100);
+        std::vector<int> expected(static_cast<size_t>(m) * n), result(static_cast<size_t>(m) * n, 12345);
+        mm_reference(a.data(), b.data(), expected.data(), m, k, n);
+        cpu_gemm(a.data(), b.data(), result.data(), m, k, n);
+        ok &= check(result == expected, "cpu_gemm matches the reference");
+    }
+
+    // 16x16のバッチ (mmカーネルのrun_batchと同じ形)
+    const int batch = 1000;
+    std::vector<int> a = random_ints(static_cast<size_t>(batch) * 256, -100, 100);
+    std::vector<int> b = random_ints(static_cast<size_t>(batch) * 256, -100, 100);
+    std::vector<int> expected(static_cast<size_t>(batch) * 256), result(static_cast<size_t>(batch) * 256);
+    for (int i = 0; i < batch; ++i) {
+        mm_reference(a.data() + i * 256, b.data() + i * 256, expected.data() + i * 256, 16, 16, 16);
+    }
+    cpu_gemm_batch(a.data(), b.data(), result.data(), batch, 16, 16, 16);
+    ok &= check(result == expected, "cpu_gemm_batch matches the reference");
+    return ok;
+}
+
+bool test_gemv() {
+    bool ok = true;
+    const int shapes[][2] = {{1, 1}, {7, 15}, {100, 1000}, {2000, 129}};
+    for (const auto& s : shapes) {
+        int rows = s[0], cols = s[1];
+        std::vector<int> a = random_ints(static_cast<size_t>(rows) * cols, -1000, 1000);
+        std::vector<int> x = random_ints(cols, -1000, 1000);
+        std::vector<int> expected(rows), result(rows);
+        std::vector<int> a_words(a);
+        a_words.resize(mv_padded_size(rows, cols));  // mvはAを512ビットのワード単位で読む
+        mv(reinterpret_cast<const ap_uint<512>*>(a_words.data()), x.data(), expected.data(), rows, cols, 1);
+        cpu_gemv(a.data(), x.data(), result.data(), rows, cols);
+        ok &= check(result == expected, "cpu_gemv matches the mv kernel");
+    }
+    return ok;
+}
+
+// "auto" はFPGAを開けなければCPUになる。"fpga" は例外をそのまま返す。
+bool test_select_backend() {
+    auto fails = [] { throw std::runtime_error("no device"); };
+    auto succeeds = [] {};
+    bool ok = true;
+    ok &= check(select_backend("auto", succeeds) == Backend::fpga, "auto picks the FPGA when it opens");
+    ok &= check(select_backend("auto", fails) == Backend::cpu, "auto falls back to the CPU");
+    ok &= check(select_backend("cpu", succeeds) == Backend::cpu, "cpu never opens the FPGA");
+
+    bool thrown = false;
+    try {
+        select_backend("fpga", fails);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ok &= check(thrown, "fpga propagates the error");
+
+    thrown = false;
+    try {
+        select_backend("gpu", succeeds);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    ok &= check(thrown, "unknown backend name");
+    ok &= check(std::string(backend_name(Backend::cpu)) == "cpu", "backend_name");
+    return ok;
+}
+
+bool test_cpu_tickets() {
+    CpuTickets<int> tickets;
+    uint64_t t0 = tickets.submit(10);
+    uint64_t t1 = tickets.submit(11);
+    uint64_t t2 = tickets.submit(12);
+
+    bool ok = true;
+    ok &= check(tickets.pending() == 3, "pending");
+    ok &= check(tickets.wait(t1) == 11, "wait by ticket");
+    std::pair<uint64_t, int> any = tickets.wait_any();
+    ok &= check(any.first == t0 && any.second == 10, "wait_any returns the oldest");
+    ok &= check(tickets.wait(t2) == 12 && tickets.pending() == 0, "all collected");
+
+    bool thrown = false;
+    try {
+        tickets.wait(t2);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ok &= check(thrown, "collected ticket cannot be waited again");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running CPU backend software test (" << parallel_data_threads() << " threads)" << std::endl;
+
+    bool ok = true;
+    ok &= test_vadd();
+    ok &= test_vdot();
+    ok &= test_gemm();
+    ok &= test_gemv();
+    ok &= test_select_backend();
+    ok &= test_cpu_tickets();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bo_pool.h"
+#include "cu_scheduler.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
+
+// CU 1つ分のカーネルハンドル、同期実行で使い回すrun、BOのプール。
+// BOはCUごとのプールから取るため、CUが別々のメモリバンクにつながっていても正しいバンクに置かれる。
+struct CuLane {
+    CuLane(XrtContext& context, const std::string& kernel_name, size_t pool_byte_budget)
+        : krnl(context.kernel(kernel_name)), launch(krnl), pool(context.device(), pool_byte_budget) {}
+
+    xrt::kernel krnl;
+    ReusableRun launch;
+    BOPool pool;
+};
+
+// kernelのCUをnum_cus個開く。pool_byte_budgetはCUごとの上限。
+inline std::vector<std::unique_ptr<CuLane>> open_cu_lanes(XrtContext& context, const std::string& kernel, size_t num_cus,
+                                                          size_t pool_byte_budget = 0) {
+    std::vector<std::unique_ptr<CuLane>> lanes;
+    for (size_t i = 0; i < (num_cus > 0 ? num_cus : 1); ++i) {
+        lanes.emplace_back(new CuLane(context, cu_kernel_name(kernel, num_cus, i), pool_byte_budget));
+    }
+    return lanes;
+}
+
+// 全CUのプールの統計の合計
+inline BOPool::Stats total_pool_stats(const std::vector<std::unique_ptr<CuLane>>& lanes) {
+    BOPool::Stats total;
+    for (const auto& lane : lanes) {
+        BOPool::Stats s = lane->pool.stats();
+        total.allocations += s.allocations;
+        total.reuses += s.reuses;
+        total.evictions += s.evictions;
+        total.bytes_allocated += s.bytes_allocated;
+        total.bytes_in_use += s.bytes_in_use;
+    }
+    return total;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// 同じカーネルの計算ユニット (CU) 複数個に要求を振り分けるスケジューラ。
+// xclbinは `v++ -l --connectivity.nk <kernel>:<N>` でN個のCU (<kernel>_1 .. <kernel>_N) を持つ。
+// ランナーはCUごとにxrt::kernelとBOを持ち、acquire()で選ばれたCUで要求を実行する。
+// 負荷は「acquire()してからLeaseを破棄するまで」の要求数で数える。スレッドセーフではない。
+
+enum class CuPolicy {
+    round_robin,   // 順番に割り当てる
+    least_loaded,  // 実行中の要求が最も少ないCU (同数なら順番に)
+};
+
+inline CuPolicy parse_cu_policy(const std::string& name) {
+    if (name == "round_robin") {
+        return CuPolicy::round_robin;
+    }
+    if (name == "least_loaded") {
+        return CuPolicy::least_loaded;
+    }
+    throw std::invalid_argument("Unknown CU policy: " + name + " (expected round_robin or least_loaded)");
+}
+
+// index番目 (0始まり) のCUを開くためのカーネル名。CUが1つならカーネル名のまま。
+inline std::string cu_kernel_name(const std::string& kernel, size_t num_cus, size_t index) {
+    if (num_cus <= 1) {
+        return kernel;
+    }
+    return kernel + ":{" + kernel + "_" + std::to_string(index + 1) + "}";
+}
+
+class CuScheduler {
+public:
+    // 割り当てたCUの番号。破棄時にそのCUの負荷を1つ減らす。
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept : scheduler_(other.scheduler_), cu_(other.cu_) { other.scheduler_ = nullptr; }
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                release();
+                scheduler_ = other.scheduler_;
+                cu_ = other.cu_;
+                other.scheduler_ = nullptr;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { release(); }
+
+        size_t cu() const { return cu_; }
+
+    private:
+        friend class CuScheduler;
+        Lease(CuScheduler* scheduler, size_t cu) : scheduler_(scheduler), cu_(cu) {}
+
+        void release() {
+            if (scheduler_) {
+                scheduler_->loads_[cu_]--;
+                scheduler_ = nullptr;
+            }
+        }
+
+        CuScheduler* scheduler_;
+        size_t cu_;
+    };
+
+    CuScheduler(size_t num_cus, CuPolicy policy)
+        : policy_(policy), loads_(num_cus > 0 ? num_cus : 1, 0), dispatched_(loads_.size(), 0) {}
+
+    // 次の要求を実行するCUを選ぶ。Leaseはスケジューラより長く保持しないこと。
+    Lease acquire() {
+        size_t cu = next_;
+        if (policy_ == CuPolicy::least_loaded) {
+            for (size_t i = 1; i < loads_.size(); ++i) {
+                size_t candidate = (next_ + i) % loads_.size();
+                if (loads_[candidate] < loads_[cu]) {
+                    cu = candidate;
+                }
+            }
+        }
+        next_ = (cu + 1) % loads_.size();
+        loads_[cu]++;
+        dispatched_[cu]++;
+        return Lease(this, cu);
+    }
+
+    size_t num_cus() const { return loads_.size(); }
+    CuPolicy policy() const { return policy_; }
+    size_t load(size_t cu) const { return loads_.at(cu); }
+    // CUごとにこれまで割り当てた要求数
+    const std::vector<uint64_t>& dispatched() const { return dispatched_; }
+
+private:
+    CuPolicy policy_;
+    std::vector<size_t> loads_;
+    std::vector<uint64_t> dispatched_;
+    size_t next_ = 0;
+};
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "cu_scheduler.h"
+#include "test_check.h"
+
+bool test_names_and_policy() {
+    bool ok = true;
+    ok &= check(cu_kernel_name("vadd", 1, 0) == "vadd", "a single CU keeps the kernel name");
+    ok &= check(cu_kernel_name("vadd", 4, 0) == "vadd:{vadd_1}", "first CU");
+    ok &= check(cu_kernel_name("vdot_wide", 4, 3) == "vdot_wide:{vdot_wide_4}", "last CU");
+    ok &= check(parse_cu_policy("round_robin") == CuPolicy::round_robin, "round_robin");
+    ok &= check(parse_cu_policy("least_loaded") == CuPolicy::least_loaded, "least_loaded");
+    bool threw = false;
+    try {
+        parse_cu_policy("random");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ok &= check(threw, "unknown policy is rejected");
+    return ok;
+}
+
+// CU 0だけが長い要求を抱えている状態で、次の3件をどこに割り当てるか
+static std::vector<size_t> place_after_slow_request(CuPolicy policy) {
+    CuScheduler scheduler(4, policy);
+    std::vector<CuScheduler::Lease> leases;
+    for (int i = 0; i < 4; ++i) {
+        leases.push_back(scheduler.acquire());
+    }
+    leases.erase(leases.begin() + 1, leases.end());  // CU 1..3は完了、CU 0は実行中
+
+    std::vector<size_t> placed;
+    for (int i = 0; i < 3; ++i) {
+        CuScheduler::Lease lease = scheduler.acquire();
+        placed.push_back(lease.cu());
+    }
+    return placed;
+}
+
+bool test_policies() {
+    bool ok = true;
+    CuScheduler scheduler(3, CuPolicy::round_robin);
+    for (int i = 0; i < 6; ++i) {
+        ok &= check(scheduler.acquire().cu() == static_cast<size_t>(i % 3), "round robin visits CUs in order");
+    }
+    ok &= check(scheduler.dispatched() == std::vector<uint64_t>({2, 2, 2}), "dispatch counts");
+    ok &= check(scheduler.load(0) == 0, "lease destruction releases the CU");
+
+    ok &= check(place_after_slow_request(CuPolicy::round_robin) == std::vector<size_t>({0, 1, 2}),
+                "round robin queues behind the slow CU");
+    ok &= check(place_after_slow_request(CuPolicy::least_loaded) == std::vector<size_t>({1, 2, 3}),
+                "least loaded avoids the slow CU");
+
+    // 負荷が同じなら順番に割り当てる
+    CuScheduler balanced(2, CuPolicy::least_loaded);
+    std::vector<CuScheduler::Lease> leases;
+    for (int i = 0; i < 4; ++i) {
+        leases.push_back(balanced.acquire());
+    }
+    ok &= check(balanced.load(0) == 2 && balanced.load(1) == 2, "least loaded spreads equal work");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running CuScheduler software test" << std::endl;
+    bool ok = true;
+    ok &= test_names_and_policy();
+    ok &= test_policies();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
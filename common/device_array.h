@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// カーネルの出力をホストへ戻さずに次のカーネルの入力として渡すための配列。
+// 形 (shape) と要素型 (dtype) を持ち、中身はカード上のBO (device_array_bo.h) に置く。
+// カードを使わないビルド (ソフトウェアシミュレーションとCPUバックエンド) では同じ型の中身をホストメモリに置く。
+// ホストへの転送はto_host()を呼んだときだけ行う。
+
+enum class DType { int8, int32, int64 };
+
+inline size_t dtype_size(DType dtype) {
+    switch (dtype) {
+    case DType::int8:
+        return 1;
+    case DType::int32:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+inline const char* dtype_name(DType dtype) {
+    switch (dtype) {
+    case DType::int8:
+        return "int8";
+    case DType::int32:
+        return "int32";
+    default:
+        return "int64";
+    }
+}
+
+// 要素のC++の型からDTypeを引く (vdotの入力はchar)
+template <typename T>
+struct dtype_of;
+template <>
+struct dtype_of<char> {
+    static constexpr DType value = DType::int8;
+};
+template <>
+struct dtype_of<int> {
+    static constexpr DType value = DType::int32;
+};
+template <>
+struct dtype_of<long long> {
+    static constexpr DType value = DType::int64;
+};
+
+// ホストメモリ上の配列のデバイス番号
+const int HOST_DEVICE = -1;
+
+// 配列の中身の置き場所
+class ArrayStorage {
+public:
+    virtual ~ArrayStorage() = default;
+    // 置いているカードの番号 (ホストメモリならHOST_DEVICE)
+    virtual int device_index() const = 0;
+    // 先頭bytesバイトをdstへ読み出す。カード上ならDMAで同期してから読む。
+    virtual void read(void* dst, size_t bytes) = 0;
+    // ホストメモリの先頭 (カード上ならnull)
+    virtual char* host_data() { return nullptr; }
+};
+
+// ホストメモリ上の中身。カーネルのC++実装が最後の512ビットのワードまで読めるよう、64バイト単位に切り上げて確保する。
+class HostStorage : public ArrayStorage {
+public:
+    static const size_t ALIGN_BYTES = 64;
+
+    explicit HostStorage(size_t bytes) : data_((bytes + ALIGN_BYTES - 1) / ALIGN_BYTES * ALIGN_BYTES) {}
+
+    int device_index() const override { return HOST_DEVICE; }
+    void read(void* dst, size_t bytes) override { std::memcpy(dst, data_.data(), bytes); }
+    char* host_data() override { return data_.data(); }
+
+private:
+    std::vector<char> data_;
+};
+
+class DeviceArray {
+public:
+    DeviceArray(std::shared_ptr<ArrayStorage> storage, std::vector<size_t> shape, DType dtype)
+        : storage_(std::move(storage)), shape_(std::move(shape)), dtype_(dtype) {}
+
+    // ホストメモリに置いた配列 (要素は0)。srcがあればその内容をコピーする。
+    static DeviceArray host(std::vector<size_t> shape, DType dtype, const void* src = nullptr) {
+        DeviceArray array(nullptr, std::move(shape), dtype);
+        array.storage_ = std::make_shared<HostStorage>(array.bytes());
+        if (src) {
+            std::memcpy(array.storage_->host_data(), src, array.bytes());
+        }
+        return array;
+    }
+
+    const std::vector<size_t>& shape() const { return shape_; }
+    size_t ndim() const { return shape_.size(); }
+    DType dtype() const { return dtype_; }
+
+    size_t size() const {
+        size_t n = 1;
+        for (size_t d : shape_) {
+            n *= d;
+        }
+        return n;
+    }
+
+    size_t bytes() const { return size() * dtype_size(dtype_); }
+
+    int device_index() const { return storage_->device_index(); }
+    bool on_host() const { return device_index() == HOST_DEVICE; }
+
+    // 同じ中身を別の形で見る (要素数は同じ)。転送もコピーもしない。
+    DeviceArray reshape(std::vector<size_t> shape) const {
+        DeviceArray array(storage_, std::move(shape), dtype_);
+        if (array.size() != size()) {
+            throw std::runtime_error("Cannot reshape a DeviceArray of " + std::to_string(size()) + " elements to " +
+                                     std::to_string(array.size()) + " elements.");
+        }
+        return array;
+    }
+
+    // 中身をdst (bytes()バイト) へ読み出す
+    void to_host(void* dst) const { storage_->read(dst, bytes()); }
+
+    // ホストメモリ上の要素。カード上の配列はCPUでは読めないため例外を投げる (to_host()で明示的に転送する)。
+    template <typename T>
+    T* host_data() const {
+        if (dtype_of<T>::value != dtype_) {
+            throw std::runtime_error(std::string("DeviceArray holds ") + dtype_name(dtype_) + " elements.");
+        }
+        if (!on_host()) {
+            throw std::runtime_error("DeviceArray is on device " + std::to_string(device_index()) +
+                                     ", but this runner computes on the host.");
+        }
+        return reinterpret_cast<T*>(storage_->host_data());
+    }
+
+    // 中身の置き場所を具体的な型で取り出す (違う型ならnull)
+    template <typename Storage>
+    Storage* storage_as() const {
+        return dynamic_cast<Storage*>(storage_.get());
+    }
+
+    // 要素型と次元数がカーネルの引数に合うか確かめる。nameは例外のメッセージに使う引数名。
+    void expect(DType dtype, size_t ndim, const char* name) const {
+        if (dtype_ != dtype || shape_.size() != ndim) {
+            throw std::runtime_error(std::string(name) + " must be a " + std::to_string(ndim) + "-dimensional " +
+                                     dtype_name(dtype) + " DeviceArray.");
+        }
+    }
+
+private:
+    std::shared_ptr<ArrayStorage> storage_;
+    std::vector<size_t> shape_;
+    DType dtype_;
+};
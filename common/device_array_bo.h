@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_device.h>
+
+#include "device_array.h"
+
+// DeviceArrayの中身をカード上のBOに置く。BOは64バイト (512ビットの1ワード) 単位に切り上げて確保するため、
+// vadd_wide・vdot_wideにも末尾の詰め直しなしでそのまま渡せる (切り上げた部分の値は使わない)。
+const size_t DEVICE_ARRAY_ALIGN = 64;
+
+class BoStorage : public ArrayStorage {
+public:
+    BoStorage(const xrt::device& device, unsigned int device_index, size_t bytes, xrt::memory_group group)
+        : bo_(device, padded_bytes(bytes), group), device_index_(device_index) {}
+
+    int device_index() const override { return static_cast<int>(device_index_); }
+
+    void read(void* dst, size_t bytes) override {
+        if (bytes == 0) {
+            return;
+        }
+        bo_.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        bo_.read(dst, bytes, 0);
+    }
+
+    xrt::bo& bo() { return bo_; }
+
+private:
+    static size_t padded_bytes(size_t bytes) {
+        size_t words = (bytes + DEVICE_ARRAY_ALIGN - 1) / DEVICE_ARRAY_ALIGN;
+        return (words > 0 ? words : 1) * DEVICE_ARRAY_ALIGN;
+    }
+
+    xrt::bo bo_;
+    unsigned int device_index_;
+};
+
+// device_indexのカードに配列を確保する。srcがあればその内容を書き込んでカードへ転送し、
+// なければ中身は未定義のまま (カーネルの出力に使う)。
+inline DeviceArray device_array(const xrt::device& device, unsigned int device_index, xrt::memory_group group,
+                                std::vector<size_t> shape, DType dtype, const void* src = nullptr) {
+    size_t bytes = 1;
+    for (size_t d : shape) {
+        bytes *= d;
+    }
+    bytes *= dtype_size(dtype);
+    auto storage = std::make_shared<BoStorage>(device, device_index, bytes, group);
+    if (src && bytes > 0) {
+        storage->bo().write(src, bytes, 0);
+        storage->bo().sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+    }
+    return DeviceArray(storage, std::move(shape), dtype);
+}
+
+// arrayがdevice_indexのカード上にあればそのBOを返す。ホストや別のカードの配列は暗黙に転送せず例外を投げる。
+inline xrt::bo& device_bo(const DeviceArray& array, unsigned int device_index) {
+    BoStorage* storage = array.storage_as<BoStorage>();
+    if (!storage || storage->device_index() != static_cast<int>(device_index)) {
+        std::string where = array.on_host() ? "the host" : "device " + std::to_string(array.device_index());
+        throw std::runtime_error("DeviceArray is on " + where + ", but this runner uses device " +
+                                 std::to_string(device_index) + ".");
+    }
+    return storage->bo();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "device_array.h"
+
+// DeviceArrayをPythonのクラスとして公開する。型はpybind11の共有の型登録に載せるため、
+// あるモジュール (libvadd_module_hw) が返した配列を別のモジュール (libmv_module_hw) にそのまま渡せる。
+
+// numpy配列の形
+inline std::vector<size_t> array_shape(const pybind11::array& a) {
+    std::vector<size_t> shape;
+    for (pybind11::ssize_t i = 0; i < a.ndim(); ++i) {
+        shape.push_back(static_cast<size_t>(a.shape(i)));
+    }
+    return shape;
+}
+
+// numpy配列の内容をホストメモリのDeviceArrayにコピーする (ソフトウェアシミュレーションとCPUバックエンドのto_device())
+template <typename T>
+DeviceArray host_device_array(const pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>& a) {
+    return DeviceArray::host(array_shape(a), dtype_of<T>::value, a.data());
+}
+
+template <typename T>
+pybind11::array device_array_to_numpy(const DeviceArray& array) {
+    std::vector<pybind11::ssize_t> shape(array.shape().begin(), array.shape().end());
+    pybind11::array_t<T> result(shape);
+    {
+        pybind11::gil_scoped_release release;
+        array.to_host(result.mutable_data());
+    }
+    return result;
+}
+
+// 中身をホストへ転送し、新しいnumpy配列として返す
+inline pybind11::array device_array_to_host(const DeviceArray& array) {
+    switch (array.dtype()) {
+    case DType::int8:
+        return device_array_to_numpy<char>(array);
+    case DType::int32:
+        return device_array_to_numpy<int>(array);
+    default:
+        return device_array_to_numpy<long long>(array);
+    }
+}
+
+// モジュールにDeviceArrayを登録する。型の登録はプロセスで1回だけで、後から読み込まれたモジュールは
+// 登録済みの型を自分の属性として見せる。
+inline void register_device_array(pybind11::module_& m) {
+    if (pybind11::detail::get_type_info(typeid(DeviceArray))) {
+        m.attr("DeviceArray") = pybind11::type::of<DeviceArray>();
+        return;
+    }
+    pybind11::class_<DeviceArray>(m, "DeviceArray")
+        .def_property_readonly("shape",
+                               [](const DeviceArray& a) {
+                                   pybind11::tuple shape(a.ndim());
+                                   for (size_t i = 0; i < a.ndim(); ++i) {
+                                       shape[i] = a.shape()[i];
+                                   }
+                                   return shape;
+                               })
+        .def_property_readonly("dtype", [](const DeviceArray& a) { return std::string(dtype_name(a.dtype())); })
+        .def_property_readonly("nbytes", &DeviceArray::bytes)
+        .def_property_readonly("device", &DeviceArray::device_index,
+                               "Index of the device holding the array, or -1 for host memory (software build and CPU backend).")
+        .def("reshape", &DeviceArray::reshape, pybind11::arg("shape"),
+             "Returns a view of the same device memory with another shape of the same size.")
+        .def("to_host", &device_array_to_host,
+             "Transfers the array to the host and returns it as a new numpy array.")
+        .def("__repr__", [](const DeviceArray& a) {
+            std::string shape;
+            for (size_t d : a.shape()) {
+                shape += (shape.empty() ? "" : ", ") + std::to_string(d);
+            }
+            return "DeviceArray(shape=(" + shape + (a.ndim() == 1 ? ",)" : ")") + ", dtype=" + dtype_name(a.dtype()) +
+                   ", device=" + std::to_string(a.device_index()) + ")";
+        });
+}
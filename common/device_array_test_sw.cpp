@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "device_array_bo.h"
+#include "test_check.h"
+
+template <typename Fn>
+static bool throws(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// ソフトウェアビルドとCPUバックエンドの配列: 中身はホストメモリで、要素をそのまま読み書きできる
+bool test_host_array() {
+    std::vector<int> src = {1, 2, 3, 4, 5, 6};
+    DeviceArray a = DeviceArray::host({2, 3}, DType::int32, src.data());
+
+    bool ok = true;
+    ok &= check(a.on_host() && a.device_index() == HOST_DEVICE, "host array reports the host");
+    ok &= check(a.ndim() == 2 && a.size() == 6 && a.bytes() == 24, "shape and size");
+    a.host_data<int>()[5] = 60;
+    std::vector<int> out(6);
+    a.to_host(out.data());
+    ok &= check(out == std::vector<int>({1, 2, 3, 4, 5, 60}), "to_host copies the elements");
+    ok &= check(throws([&] { a.host_data<char>(); }), "element type is checked");
+    ok &= check(throws([&] { a.expect(DType::int32, 1, "a"); }), "dimensions are checked");
+    DeviceArray flat = a.reshape({6});
+    ok &= check(flat.ndim() == 1 && flat.host_data<int>() == a.host_data<int>(), "reshape shares the elements");
+    ok &= check(throws([&] { a.reshape({4}); }), "reshape keeps the size");
+    ok &= check(DeviceArray::host({0}, DType::int8).bytes() == 0, "empty array");
+    return ok;
+}
+
+// カード上の配列: 作るときに1回だけ転送し、カーネル間で渡す間は転送せず、to_host()で1回だけ戻す
+bool test_bo_array() {
+    xrt::device device(0);
+    std::vector<char> src(100);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<char>(i);
+    }
+
+    xrt_fake::reset_counters();
+    DeviceArray a = device_array(device, 0, 0, {100}, DType::int8, src.data());
+    DeviceArray b = a;  // 別のカーネルへ渡すコピーは同じBOを共有する
+
+    bool ok = true;
+    ok &= check(xrt_fake::counters().bytes_to_device == 100, "created with one transfer of the elements");
+    ok &= check(device_bo(a, 0).size() == 128, "BO is padded to whole 512-bit words");
+    ok &= check(device_bo(a, 0) == device_bo(b, 0), "copies share the BO");
+    ok &= check(!a.on_host() && a.device_index() == 0, "array reports its device");
+    ok &= check(throws([&] { a.host_data<char>(); }), "device array is not readable on the host");
+    ok &= check(xrt_fake::counters().bytes_from_device == 0, "nothing is read back implicitly");
+
+    std::vector<char> out(100);
+    b.to_host(out.data());
+    ok &= check(out == src, "to_host reads the device copy");
+    ok &= check(xrt_fake::counters().bytes_from_device == 100, "to_host transfers only the elements");
+    return ok;
+}
+
+// ホストの配列や別のカードの配列は暗黙に転送せず、カーネルに渡す前に拒否する
+bool test_device_mismatch() {
+    xrt_fake::device_count() = 2;
+    xrt::device device1(1);
+    DeviceArray on_device1 = device_array(device1, 1, 0, {16}, DType::int32);
+    DeviceArray on_host = DeviceArray::host({16}, DType::int32);
+
+    bool ok = true;
+    ok &= check(throws([&] { device_bo(on_device1, 0); }), "array on another device is rejected");
+    ok &= check(throws([&] { device_bo(on_host, 0); }), "host array is rejected");
+    ok &= check(device_bo(on_device1, 1).size() == 64, "array on the same device is accepted");
+    xrt_fake::device_count() = 1;
+    return ok;
+}
+
+int main() {
+    std::cout << "Running DeviceArray software test" << std::endl;
+    bool ok = true;
+    ok &= test_host_array();
+    ok &= test_bo_array();
+    ok &= test_device_mismatch();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
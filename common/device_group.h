@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <experimental/xrt_system.h>
+
+// 複数枚のカードにxclbinを読み込み、1つの大きな要求を要素の範囲 (シャード) に分けて同時に実行する。
+// ランナーはカードごとに1つ作り (それぞれがXrtContext::get(xclbin, device_index) で自分のカードを開く)、
+// シャードの結果の結合 (vdotの部分和の加算など) は呼び出し側がホストで行う。
+
+// 要素の範囲 [begin, begin + count)
+struct Shard {
+    size_t begin;
+    size_t count;
+};
+
+// count要素をparts個以下のシャードに分ける。境界はalignの倍数で、大きさの差は高々align。
+// 要素がparts * align個に満たなければシャードを減らし、空のシャードは作らない。
+inline std::vector<Shard> split_shards(size_t count, size_t parts, size_t align = 1) {
+    if (align == 0) {
+        align = 1;
+    }
+    const size_t units = (count + align - 1) / align;
+    if (parts > units) {
+        parts = units;
+    }
+    std::vector<Shard> shards;
+    size_t unit = 0;
+    for (size_t i = 0; i < parts; ++i) {
+        size_t n = units / parts + (i < units % parts ? 1 : 0);
+        size_t begin = unit * align;
+        size_t end = (unit + n) * align < count ? (unit + n) * align : count;
+        shards.push_back({begin, end - begin});
+        unit += n;
+    }
+    return shards;
+}
+
+// シャードごとにfn(index, shard)を別スレッドで呼ぶ (先頭は呼び出し元のスレッド)。
+// 全シャードの終了を待ってから、最初に失敗したシャードの例外を投げ直す。
+inline void run_shards(const std::vector<Shard>& shards, const std::function<void(size_t, const Shard&)>& fn) {
+    std::vector<std::exception_ptr> errors(shards.size());
+    auto guarded = [&](size_t i) {
+        try {
+            fn(i, shards[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < shards.size(); ++i) {
+        threads.emplace_back(guarded, i);
+    }
+    if (!shards.empty()) {
+        guarded(0);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// 使うカードの番号。requestedが0なら見つかったすべてのカード、1なら0番だけ (列挙しない)。
+inline std::vector<unsigned int> select_devices(size_t requested) {
+    size_t available = requested == 1 ? 1 : xrt::system::enumerate_devices();
+    if (requested == 0) {
+        requested = available;
+    }
+    if (requested == 0 || requested > available) {
+        throw std::runtime_error("Requested " + std::to_string(requested) + " devices but " + std::to_string(available) +
+                                 " are available.");
+    }
+    std::vector<unsigned int> indices;
+    for (size_t i = 0; i < requested; ++i) {
+        indices.push_back(static_cast<unsigned int>(i));
+    }
+    return indices;
+}
+
+template <typename Runner>
+class DeviceGroup {
+public:
+    using Opener = std::function<std::unique_ptr<Runner>(unsigned int device_index)>;
+
+    // select_devices(num_devices) のカードごとにopen(device_index) でランナーを作る
+    DeviceGroup(size_t num_devices, const Opener& open) {
+        for (unsigned int index : select_devices(num_devices)) {
+            runners_.push_back(open(index));
+        }
+    }
+
+    size_t size() const { return runners_.size(); }
+    Runner& runner(size_t i) { return *runners_.at(i); }
+    const Runner& runner(size_t i) const { return *runners_.at(i); }
+    // 分割しない経路 (非同期実行やゼロコピー経路) で使う0番のカード
+    Runner& primary() { return *runners_[0]; }
+    const Runner& primary() const { return *runners_[0]; }
+
+    // count要素をカードの数に分け、fn(runner, shard, index) を各カードで同時に呼ぶ。分けたシャードを返す。
+    template <typename Fn>
+    std::vector<Shard> shard(size_t count, size_t align, Fn fn) {
+        std::vector<Shard> shards = split_shards(count, runners_.size(), align);
+        run_shards(shards, [&](size_t i, const Shard& s) { fn(*runners_[i], s, i); });
+        return shards;
+    }
+
+private:
+    std::vector<std::unique_ptr<Runner>> runners_;
+};
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "device_group.h"
+#include "xrt_context.h"
+#include "test_check.h"
+
+bool test_split_shards() {
+    bool ok = true;
+    for (size_t count : {0, 1, 15, 16, 17, 1000, 4096, 4097}) {
+        for (size_t parts : {1, 2, 3, 4, 7}) {
+            for (size_t align : {1, 16, 64}) {
+                std::vector<Shard> shards = split_shards(count, parts, align);
+                size_t next = 0;
+                size_t smallest = count, largest = 0;
+                bool aligned = true;
+                for (const Shard& s : shards) {
+                    aligned &= s.begin == next && s.begin % align == 0 && s.count > 0;
+                    next = s.begin + s.count;
+                    smallest = std::min(smallest, s.count);
+                    largest = std::max(largest, s.count);
+                }
+                ok &= check(aligned && next == count, "shards are contiguous, aligned and non-empty");
+                ok &= check(shards.size() <= parts, "no more shards than parts");
+                ok &= check(shards.empty() || largest - smallest <= 2 * align, "shards are balanced");
+            }
+        }
+    }
+    ok &= check(split_shards(40, 4, 16).size() == 3, "short inputs use fewer devices");
+    return ok;
+}
+
+// 1つのシャードが失敗しても他のシャードは最後まで実行され、その後で例外が伝わる
+bool test_run_shards_errors() {
+    std::atomic<int> finished{0};
+    bool threw = false;
+    try {
+        run_shards(split_shards(4, 4), [&](size_t i, const Shard&) {
+            if (i == 2) {
+                throw std::runtime_error("shard failed");
+            }
+            finished++;
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    bool ok = true;
+    ok &= check(threw, "shard exception is rethrown");
+    ok &= check(finished == 3, "other shards complete");
+    return ok;
+}
+
+bool test_select_devices() {
+    xrt_fake::device_count() = 4;
+    bool ok = true;
+    ok &= check(select_devices(0).size() == 4, "0 selects every device");
+    ok &= check(select_devices(2) == std::vector<unsigned int>({0, 1}), "first devices are selected");
+    bool threw = false;
+    try {
+        select_devices(5);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "too many devices is rejected");
+    xrt_fake::device_count() = 1;
+    ok &= check(select_devices(1).size() == 1, "one device");
+    return ok;
+}
+
+// 各サンプルのランナーと同じく、カードごとにXrtContextでxclbinを読み込み、要素の範囲のvdotを計算する
+class ShardedVDot {
+public:
+    explicit ShardedVDot(unsigned int device_index)
+        : context_(XrtContext::get("vdot.xclbin", device_index)), krnl_(context_->kernel("vdot")) {}
+
+    long long run(const char* a, const char* b, size_t size) {
+        xrt::bo bo_a(context_->device(), size, krnl_.group_id(0));
+        xrt::bo bo_b(context_->device(), size, krnl_.group_id(1));
+        xrt::bo bo_result(context_->device(), sizeof(long long), krnl_.group_id(2));
+        bo_a.write(a, size, 0);
+        bo_b.write(b, size, 0);
+        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        krnl_(bo_a, bo_b, bo_result, static_cast<int>(size)).wait();
+        bo_result.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        long long result;
+        bo_result.read(&result, sizeof(long long), 0);
+        calls_++;
+        return result;
+    }
+
+    unsigned int device_index() const { return context_->device_index(); }
+    int calls() const { return calls_; }
+
+private:
+    std::shared_ptr<XrtContext> context_;
+    xrt::kernel krnl_;
+    int calls_ = 0;
+};
+
+static void register_vdot() {
+    xrt_fake::register_kernel("vdot", [](const std::vector<xrt_fake::kernel_arg>& args) {
+        const char* a = args[0].ptr<char>();
+        const char* b = args[1].ptr<char>();
+        long long sum = 0;
+        for (int64_t i = 0; i < args[3].scalar; ++i) {
+            sum += a[i] * b[i];
+        }
+        *args[2].ptr<long long>() = sum;
+    });
+}
+
+// 部分和をホストで足し合わせ、全体の時間 (ms) を返す
+static double sharded_vdot(DeviceGroup<ShardedVDot>& group, const std::vector<char>& a, const std::vector<char>& b,
+                           long long* result) {
+    std::vector<long long> partial(group.size(), 0);
+    auto start = std::chrono::steady_clock::now();
+    group.shard(a.size(), 64, [&](ShardedVDot& runner, const Shard& s, size_t i) {
+        partial[i] = runner.run(a.data() + s.begin, b.data() + s.begin, s.count);
+    });
+    *result = 0;
+    for (long long p : partial) {
+        *result += p;
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 1コアの環境ではスレッドの起動が遅れることがあるため、数回のうち最も速い時間を使う
+const int SHARD_REPEATS = 3;
+
+static double fastest_sharded_vdot(DeviceGroup<ShardedVDot>& group, const std::vector<char>& a,
+                                   const std::vector<char>& b, long long* result) {
+    double best = sharded_vdot(group, a, b, result);
+    for (int r = 1; r < SHARD_REPEATS; ++r) {
+        best = std::min(best, sharded_vdot(group, a, b, result));
+    }
+    return best;
+}
+
+// フェイクのカード4枚: 結果は1枚と同じで、PCIeの帯域が律速ならカードの枚数に比例して速くなる
+bool test_fake_devices() {
+    register_vdot();
+    xrt_fake::device_count() = 4;
+    auto open = [](unsigned int index) { return std::unique_ptr<ShardedVDot>(new ShardedVDot(index)); };
+    DeviceGroup<ShardedVDot> one(1, open);
+    DeviceGroup<ShardedVDot> four(0, open);
+
+    const size_t size = 1000 * 1000 + 37;
+    std::vector<char> a(size), b(size);
+    long long expected = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = static_cast<char>(i % 23 - 11);
+        b[i] = static_cast<char>(i % 7 - 3);
+        expected += a[i] * b[i];
+    }
+
+    xrt_fake::latency().pcie_mb_s = 50.0;  // 1枚なら2MBの転送に40ms
+    long long one_result = 0, four_result = 0;
+    double one_ms = fastest_sharded_vdot(one, a, b, &one_result);
+    double four_ms = fastest_sharded_vdot(four, a, b, &four_result);
+    xrt_fake::latency() = xrt_fake::latency_model();
+    xrt_fake::device_count() = 1;
+
+    std::cout << "  1 device: " << one_ms << " ms, 4 devices: " << four_ms << " ms" << std::endl;
+    bool ok = true;
+    ok &= check(one_result == expected && four_result == expected, "partial sums combine to the full result");
+    for (size_t i = 0; i < four.size(); ++i) {
+        ok &= check(four.runner(i).device_index() == i && four.runner(i).calls() == SHARD_REPEATS, "every device runs one shard per call");
+    }
+    ok &= check(four_ms < one_ms / 2.5, "throughput scales with the number of devices");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running DeviceGroup software test" << std::endl;
+    bool ok = true;
+    ok &= test_split_shards();
+    ok &= test_run_shards_errors();
+    ok &= test_select_devices();
+    ok &= test_fake_devices();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <xrt/xrt_kernel.h>
+
+// 最大depth件のカーネル実行を同時に投入しておくためのキュー。
+// submit()は入力転送とカーネル起動だけを行ってすぐ戻るため、次の要求の転送が前の要求の計算と重なる。
+// 各要求のBOはcollect関数が保持し、結果を回収した時点で解放される (BOPoolと組み合わせると
+// depth組のBOセットが順に使い回される)。スレッドセーフではない。
+template <typename Result>
+class InflightQueue {
+public:
+    using Ticket = uint64_t;
+    using Collect = std::function<Result()>;
+
+    struct Launch {
+        xrt::run run;
+        Collect collect;  // カーネル完了後に出力をデバイスから読み出して結果を返す
+    };
+
+    explicit InflightQueue(size_t depth) : depth_(depth > 0 ? depth : 1) {}
+
+    // launchは入力を転送してカーネルを起動し、Launchを返す。
+    // 実行中の要求がdepth件に達している場合は、最も古い要求を回収してから起動する。
+    Ticket submit(const std::function<Launch()>& launch) {
+        while (inflight_.size() >= depth_) {
+            retire(inflight_.begin());
+        }
+        Launch l = launch();
+        Ticket ticket = next_ticket_++;
+        inflight_.push_back({ticket, std::move(l.run), std::move(l.collect)});
+        return ticket;
+    }
+
+    // 指定した要求の完了を待って結果を返す
+    Result wait(Ticket ticket) {
+        auto done = done_.find(ticket);
+        if (done != done_.end()) {
+            Result result = std::move(done->second);
+            done_.erase(done);
+            return result;
+        }
+        for (auto it = inflight_.begin(); it != inflight_.end(); ++it) {
+            if (it->ticket == ticket) {
+                return finish(it);
+            }
+        }
+        throw std::runtime_error("InflightQueue: unknown ticket " + std::to_string(ticket));
+    }
+
+    // 完了済みの要求のうちどれか1つを返す。なければいずれかが完了するまで待つ。
+    std::pair<Ticket, Result> wait_any() {
+        if (!done_.empty()) {
+            auto done = done_.begin();
+            std::pair<Ticket, Result> result(done->first, std::move(done->second));
+            done_.erase(done);
+            return result;
+        }
+        if (inflight_.empty()) {
+            throw std::runtime_error("InflightQueue: nothing in flight");
+        }
+        while (true) {
+            for (auto it = inflight_.begin(); it != inflight_.end(); ++it) {
+                // COMPLETED以外の終了状態 (ERROR/ABORT/TIMEOUTなど) もここで拾い、finish()で例外にする
+                ert_cmd_state state = it->run.state();
+                if (state != ERT_CMD_STATE_NEW && state != ERT_CMD_STATE_QUEUED &&
+                    state != ERT_CMD_STATE_RUNNING) {
+                    Ticket ticket = it->ticket;
+                    return {ticket, finish(it)};
+                }
+            }
+            inflight_.front().run.wait(std::chrono::milliseconds(1));
+        }
+    }
+
+    size_t depth() const { return depth_; }
+    size_t in_flight() const { return inflight_.size(); }
+    size_t pending() const { return inflight_.size() + done_.size(); }
+
+private:
+    struct Entry {
+        Ticket ticket;
+        xrt::run run;
+        Collect collect;
+    };
+
+    using Iterator = typename std::deque<Entry>::iterator;
+
+    // 完了を待って結果を回収し、BOを手放す
+    Result finish(Iterator it) {
+        ert_cmd_state state = it->run.wait();
+        Collect collect = std::move(it->collect);
+        inflight_.erase(it);
+        if (state != ERT_CMD_STATE_COMPLETED) {
+            throw std::runtime_error("InflightQueue: kernel run failed");
+        }
+        return collect();
+    }
+
+    // 空きを作るため、結果を後のwait()用に保持して回収する
+    void retire(Iterator it) {
+        Ticket ticket = it->ticket;
+        done_.emplace(ticket, finish(it));
+    }
+
+    size_t depth_;
+    Ticket next_ticket_ = 0;
+    std::deque<Entry> inflight_;
+    std::map<Ticket, Result> done_;
+};
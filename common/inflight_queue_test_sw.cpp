@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "inflight_queue.h"
+#include "test_check.h"
+
+// キューの動作だけを確かめるため、カーネルは引数を持たず、回収した結果は投入時の番号とする。
+// BOを使う実際の投入経路 (VAddRunner::submit) は vadd/vadd_runner_test_sw で確かめる。
+static InflightQueue<int>::Ticket submit_tick(InflightQueue<int>& queue, xrt::kernel& kernel, int value) {
+    return queue.submit([&] {
+        xrt::run run = kernel(value);
+        return InflightQueue<int>::Launch{run, [value] { return value; }};
+    });
+}
+
+// 投入順とは異なる順でwait()しても、各チケットに正しい結果が返る
+bool test_results() {
+    xrt::device device(0);
+    xrt::kernel kernel(device, device.load_xclbin("tick.xclbin"), "tick");
+    InflightQueue<int> queue(3);
+
+    const int NUM_REQUESTS = 10;
+    std::vector<InflightQueue<int>::Ticket> tickets;
+    bool ok = true;
+    for (int r = 0; r < NUM_REQUESTS; ++r) {
+        tickets.push_back(submit_tick(queue, kernel, r));
+        ok &= check(queue.in_flight() <= 3, "no more than depth runs in flight");
+    }
+    ok &= check(queue.pending() == NUM_REQUESTS, "retired results are kept for wait()");
+    for (int r = NUM_REQUESTS - 1; r >= 0; --r) {
+        ok &= check(queue.wait(tickets[r]) == r, "result matches its ticket");
+    }
+    ok &= check(queue.pending() == 0, "all results collected");
+
+    bool threw = false;
+    try {
+        queue.wait(tickets[0]);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ok &= check(threw, "a collected ticket is unknown");
+    return ok;
+}
+
+// カーネルは投入順に実行されるため、wait_any()は古い要求から返る
+bool test_wait_any_order() {
+    xrt_fake::latency().kernel = std::chrono::milliseconds(2);
+    xrt::device device(0);
+    xrt::kernel kernel(device, device.load_xclbin("tick.xclbin"), "tick");
+    InflightQueue<int> queue(3);
+
+    bool ok = true;
+    for (int r = 0; r < 3; ++r) {
+        submit_tick(queue, kernel, r);
+    }
+    for (int r = 0; r < 3; ++r) {
+        auto result = queue.wait_any();
+        ok &= check(result.first == static_cast<uint64_t>(r), "completion order follows submission order");
+        ok &= check(result.second == r, "wait_any result");
+    }
+    xrt_fake::latency() = xrt_fake::latency_model();
+    return ok;
+}
+
+// 中断されたカーネル (ERT_CMD_STATE_ABORT) でもwait_any()は待ち続けず、例外で知らせる
+bool test_wait_any_abort() {
+    xrt_fake::register_kernel("abort", [](const std::vector<xrt_fake::kernel_arg>&) { throw xrt_fake::kernel_abort(); });
+    xrt::device device(0);
+    xrt::kernel kernel(device, device.load_xclbin("tick.xclbin"), "abort");
+    InflightQueue<int> queue(2);
+
+    submit_tick(queue, kernel, 0);
+    bool threw = false;
+    try {
+        queue.wait_any();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+
+    bool ok = true;
+    ok &= check(threw, "aborted run is reported by wait_any");
+    ok &= check(queue.pending() == 0, "aborted run is removed from the queue");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running InflightQueue software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_results();
+    ok &= test_wait_any_order();
+    ok &= test_wait_any_abort();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
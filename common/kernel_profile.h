@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+// 計測版カーネル (*_prof) がカーネル内で数えたサイクル数の形式と、ホストでの時間への換算。
+// 計測版カーネルは最後の引数に KERNEL_PROFILE_WORDS 個の64ビットワードのBOを取り、
+// フェーズごとのサイクル数と全体のサイクル数を書く。カーネル側の実装は kernel_profile_counter.h。
+//
+// ホストで測った起動から完了までの時間からカーネル内の全体の時間を引いた残りが、
+// 起動と完了通知にかかったオーバーヘッド (XRTのコマンド処理、レジスタの読み書き、割り込み) になる。
+
+// カーネルのフェーズ。カーネルは KERNEL_PROFILE_START から始まり、KERNEL_PROFILE_DONE で計測を終える。
+enum KernelProfilePhase {
+    KERNEL_PROFILE_START = 0,    // 入力の読み込み (DDRからローカルメモリへ)
+    KERNEL_PROFILE_COMPUTE = 1,  // 計算
+    KERNEL_PROFILE_END = 2,      // 結果の書き出し
+    KERNEL_PROFILE_DONE = 3,
+};
+
+const int KERNEL_PROFILE_PHASES = 3;
+// プロファイル出力のワード数: [0..2] フェーズごとのサイクル数、[3] 起動から KERNEL_PROFILE_DONE までのサイクル数
+const int KERNEL_PROFILE_WORDS = KERNEL_PROFILE_PHASES + 1;
+const int KERNEL_PROFILE_TOTAL = KERNEL_PROFILE_PHASES;
+
+// サイクル数を時間に換算するカーネルクロック (MHz)。U250でv++の既定 (300MHz) から変えた場合は -D で合わせる。
+// ソフトウェアのカウンタの模擬 (kernel_profile_counter.h) もこの周波数でサイクル数を数える。
+#ifndef KERNEL_PROFILE_CLOCK_MHZ
+#define KERNEL_PROFILE_CLOCK_MHZ 300
+#endif
+
+// ここから下はホスト側 (高位合成の対象外)
+#ifndef __SYNTHESIS__
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "bench_stats.h"
+
+inline const char* kernel_profile_phase_name(int phase) {
+    static const char* const names[KERNEL_PROFILE_WORDS] = {"start", "compute", "end", "total"};
+    return names[phase];
+}
+
+// 1回の起動のプロファイル (時間はマイクロ秒)
+struct KernelProfile {
+    unsigned long long cycles[KERNEL_PROFILE_WORDS] = {};
+    double us[KERNEL_PROFILE_WORDS] = {};
+};
+
+inline KernelProfile kernel_profile_decode(const unsigned long long* words, double clock_mhz = KERNEL_PROFILE_CLOCK_MHZ) {
+    KernelProfile p;
+    for (int i = 0; i < KERNEL_PROFILE_WORDS; ++i) {
+        p.cycles[i] = words[i];
+        p.us[i] = words[i] / clock_mhz;
+    }
+    return p;
+}
+
+// フェーズの合計が全体を超えていないか。ハードウェアのカウンタでは一致し、
+// 模擬では区間ごとに切り捨てる分だけフェーズの合計が小さくなる。
+inline bool kernel_profile_consistent(const unsigned long long* words) {
+    unsigned long long sum = 0;
+    for (int i = 0; i < KERNEL_PROFILE_PHASES; ++i) {
+        sum += words[i];
+    }
+    return sum <= words[KERNEL_PROFILE_TOTAL];
+}
+
+// 複数回の起動のプロファイルをホストの時間と並べて集め、フェーズごとの中央値を出す。
+class KernelProfileLog {
+public:
+    explicit KernelProfileLog(double clock_mhz = KERNEL_PROFILE_CLOCK_MHZ) : clock_mhz_(clock_mhz) {}
+
+    // host_usはホストで測った起動 (run.start) から完了 (run.wait) までの時間
+    void add(const unsigned long long* words, double host_us) {
+        profiles_.push_back(kernel_profile_decode(words, clock_mhz_));
+        host_us_.push_back(host_us);
+    }
+
+    size_t size() const { return profiles_.size(); }
+    const KernelProfile& profile(size_t i) const { return profiles_[i]; }
+
+    double median_us(int word) const {
+        std::vector<double> v;
+        for (const auto& p : profiles_) {
+            v.push_back(p.us[word]);
+        }
+        return bench_summarize(v).median;
+    }
+
+    double median_host_us() const { return bench_summarize(host_us_).median; }
+
+    // ホストの時間からカーネル内の時間を引いた残り (起動ごとに引いてから中央値を取る)
+    double median_overhead_us() const {
+        std::vector<double> v;
+        for (size_t i = 0; i < profiles_.size(); ++i) {
+            v.push_back(host_us_[i] - profiles_[i].us[KERNEL_PROFILE_TOTAL]);
+        }
+        return bench_summarize(v).median;
+    }
+
+    void print(std::ostream& out) const {
+        out << "Kernel profile (" << size() << " runs, " << clock_mhz_ << " MHz, median us):";
+        for (int i = 0; i < KERNEL_PROFILE_WORDS; ++i) {
+            out << " " << kernel_profile_phase_name(i) << " " << median_us(i);
+        }
+        out << ", host " << median_host_us() << ", launch overhead " << median_overhead_us() << std::endl;
+    }
+
+private:
+    double clock_mhz_;
+    std::vector<KernelProfile> profiles_;
+    std::vector<double> host_us_;
+};
+
+#endif  // __SYNTHESIS__
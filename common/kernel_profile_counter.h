@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "kernel_profile.h"
+
+// 計測版カーネルのサイクルカウンタ。カーネルの本体は kernel_profile_mark() でフェーズの切り替わりを知らせ、
+// kernel_profile_counter() がフェーズごとのサイクル数をプロファイル出力 (kernel_profile.h) に書く。
+//
+//   KernelProfileEvents events;
+// #pragma HLS STREAM variable=events depth=4
+// #pragma HLS DATAFLOW
+//   body(..., events);                       // kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE) など
+//   kernel_profile_counter(events, prof);
+//
+// 本体は KERNEL_PROFILE_DONE を最後に必ず1回だけ送ること (送らないとカウンタが終わらない)。
+// 高位合成では、カウンタは本体と並んで動くDATAFLOWのプロセスで、毎サイクル1つ数えながら
+// イベントのストリームをノンブロッキングで読み、そのときのフェーズにサイクルを積む。
+// 本体の m_axi の書き込みが応答を待たずに完了扱いになる分と、イベントがカウンタに届くまでの数サイクルは誤差になる。
+//
+// それ以外 (ソフトウェアテスト、XRTフェイク、C シミュレーション) では、DATAFLOWのプロセスが順に実行されるため
+// 並んで数えられない。代わりに kernel_profile_mark() が呼ばれた時刻をsteady_clockで読み、
+// KERNEL_PROFILE_CLOCK_MHZ のサイクル数に換算して積む (カウンタの模擬)。出力の形式はハードウェアと同じ。
+
+// 計測しない通常版のカーネルが本体に渡すダミー。markは何もしない。
+struct KernelProfileNone {};
+
+inline void kernel_profile_mark(KernelProfileNone&, int) {}
+
+#ifdef __SYNTHESIS__
+
+#include "ap_int.h"
+#include "hls_stream.h"
+
+typedef hls::stream<ap_uint<2> > KernelProfileEvents;
+
+inline void kernel_profile_mark(KernelProfileEvents& events, int phase) {
+    events.write(phase);
+}
+
+inline void kernel_profile_counter(KernelProfileEvents& events, unsigned long long* prof) {
+    unsigned long long counts[KERNEL_PROFILE_PHASES] = {0, 0, 0};
+#pragma HLS ARRAY_PARTITION variable=counts complete
+    unsigned long long cycle = 0;
+    int phase = KERNEL_PROFILE_START;
+count_cycles:
+    while (phase != KERNEL_PROFILE_DONE) {
+#pragma HLS PIPELINE II=1
+        counts[phase]++;
+        cycle++;
+        ap_uint<2> next;
+        if (events.read_nb(next)) {
+            phase = next.to_uint();
+        }
+    }
+    for (int i = 0; i < KERNEL_PROFILE_PHASES; i++) {
+        prof[i] = counts[i];
+    }
+    prof[KERNEL_PROFILE_TOTAL] = cycle;
+}
+
+#else
+
+#include <chrono>
+
+class KernelProfileEvents {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    KernelProfileEvents() : begin_(Clock::now()), last_(begin_) {}
+
+    void mark(int phase) {
+        if (phase_ == KERNEL_PROFILE_DONE) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        counts_[phase_] += cycles(now - last_);
+        last_ = now;
+        phase_ = phase;
+        if (phase == KERNEL_PROFILE_DONE) {
+            total_ = cycles(now - begin_);
+        }
+    }
+
+    void write(unsigned long long* prof) const {
+        for (int i = 0; i < KERNEL_PROFILE_PHASES; i++) {
+            prof[i] = counts_[i];
+        }
+        prof[KERNEL_PROFILE_TOTAL] = total_;
+    }
+
+private:
+    static unsigned long long cycles(Clock::duration elapsed) {
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        return ns > 0 ? static_cast<unsigned long long>(ns) * KERNEL_PROFILE_CLOCK_MHZ / 1000 : 0;
+    }
+
+    Clock::time_point begin_;
+    Clock::time_point last_;
+    int phase_ = KERNEL_PROFILE_START;
+    unsigned long long counts_[KERNEL_PROFILE_PHASES] = {0, 0, 0};
+    unsigned long long total_ = 0;
+};
+
+inline void kernel_profile_mark(KernelProfileEvents& events, int phase) {
+    events.mark(phase);
+}
+
+inline void kernel_profile_counter(KernelProfileEvents& events, unsigned long long* prof) {
+    events.write(prof);
+}
+
+#endif  // __SYNTHESIS__
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "kernel_profile_counter.h"
+#include "test_check.h"
+
+static bool near(double value, double expected) {
+    return std::fabs(value - expected) <= 1e-9 * std::fabs(expected) + 1e-12;
+}
+
+// サイクル数からマイクロ秒への換算
+bool test_decode() {
+    const unsigned long long words[KERNEL_PROFILE_WORDS] = {300, 3000, 150, 3450};
+    KernelProfile p = kernel_profile_decode(words, 300.0);
+    bool ok = true;
+    ok &= check(p.cycles[KERNEL_PROFILE_COMPUTE] == 3000, "cycles are kept");
+    ok &= check(near(p.us[KERNEL_PROFILE_START], 1.0) && near(p.us[KERNEL_PROFILE_COMPUTE], 10.0) &&
+                    near(p.us[KERNEL_PROFILE_END], 0.5) && near(p.us[KERNEL_PROFILE_TOTAL], 11.5),
+                "cycles / MHz = us");
+    ok &= check(near(kernel_profile_decode(words, 150.0).us[KERNEL_PROFILE_TOTAL], 23.0), "clock is a parameter");
+    ok &= check(kernel_profile_consistent(words), "phases add up to the total");
+    const unsigned long long broken[KERNEL_PROFILE_WORDS] = {10, 10, 10, 20};
+    ok &= check(!kernel_profile_consistent(broken), "phases exceeding the total are rejected");
+    ok &= check(std::string(kernel_profile_phase_name(KERNEL_PROFILE_TOTAL)) == "total", "phase names");
+    return ok;
+}
+
+// ホストの時間との差がオーバーヘッドになり、中央値は外れ値に引きずられない
+bool test_log() {
+    KernelProfileLog log(100.0);
+    const unsigned long long words[KERNEL_PROFILE_WORDS] = {100, 800, 100, 1000};  // 全体10us
+    log.add(words, 25.0);
+    log.add(words, 30.0);
+    log.add(words, 5000.0);  // 起動が遅れた1回
+    bool ok = true;
+    ok &= check(log.size() == 3, "size");
+    ok &= check(near(log.median_us(KERNEL_PROFILE_COMPUTE), 8.0), "median compute");
+    ok &= check(near(log.median_host_us(), 30.0), "median host");
+    ok &= check(near(log.median_overhead_us(), 20.0), "overhead is host - device");
+
+    std::ostringstream out;
+    log.print(out);
+    ok &= check(out.str().find("launch overhead 20") != std::string::npos, "print reports the overhead");
+    return ok;
+}
+
+// カウンタの模擬: markの間の時間がKERNEL_PROFILE_CLOCK_MHZのサイクル数としてフェーズに積まれる
+bool test_emulated_counter() {
+    const double cycles_per_ms = KERNEL_PROFILE_CLOCK_MHZ * 1000.0;
+    unsigned long long prof[KERNEL_PROFILE_WORDS] = {};
+    unsigned long long after_done[KERNEL_PROFILE_WORDS] = {};
+    {
+        KernelProfileEvents events;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        kernel_profile_mark(events, KERNEL_PROFILE_END);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+        kernel_profile_counter(events, prof);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);  // DONEの後は数えない
+        kernel_profile_counter(events, after_done);
+    }
+    bool ok = true;
+    ok &= check(prof[KERNEL_PROFILE_START] >= 2 * cycles_per_ms, "start phase");
+    ok &= check(prof[KERNEL_PROFILE_COMPUTE] >= 4 * cycles_per_ms, "compute phase");
+    ok &= check(prof[KERNEL_PROFILE_END] >= 1 * cycles_per_ms, "end phase");
+    ok &= check(kernel_profile_consistent(prof), "emulated phases do not exceed the total");
+    // 区間ごとの切り捨てで失うのは1区間あたり1サイクル未満
+    ok &= check(prof[KERNEL_PROFILE_TOTAL] - (prof[0] + prof[1] + prof[2]) < KERNEL_PROFILE_PHASES,
+                "total stops at done");
+    bool unchanged = true;
+    for (int i = 0; i < KERNEL_PROFILE_WORDS; ++i) {
+        unchanged &= after_done[i] == prof[i];
+    }
+    ok &= check(unchanged, "marks after done are ignored");
+
+    // 同じフェーズを続けて送ってもよい (バッチのループで毎回startを送る場合)
+    unsigned long long repeated[KERNEL_PROFILE_WORDS] = {};
+    KernelProfileEvents events;
+    for (int i = 0; i < 3; ++i) {
+        kernel_profile_mark(events, KERNEL_PROFILE_START);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+    kernel_profile_counter(events, repeated);
+    ok &= check(repeated[KERNEL_PROFILE_START] >= 3 * cycles_per_ms && repeated[KERNEL_PROFILE_COMPUTE] >= 3 * cycles_per_ms,
+                "phases accumulate across a batch");
+    ok &= check(repeated[KERNEL_PROFILE_END] == 0, "unused phase stays zero");
+
+    KernelProfileNone none;
+    kernel_profile_mark(none, KERNEL_PROFILE_DONE);  // 通常版のカーネルでは何もしない
+    return ok;
+}
+
+int main() {
+    std::cout << "Running kernel profile software test" << std::endl;
+    bool ok = true;
+    ok &= test_decode();
+    ok &= test_log();
+    ok &= test_emulated_counter();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
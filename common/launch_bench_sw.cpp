@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "reusable_run.h"
+
+// 起動から完了までの時間と、1回あたりのset_arg呼び出し数を、毎回runを作る経路 (krnl(args...))
+// とReusableRunの経路で比較する。カーネル本体は空にして起動処理だけを測る。
+
+const int ITERATIONS = 20000;
+
+struct Result {
+    double us_per_launch;
+    double set_args_per_launch;
+};
+
+template <typename Launch>
+Result measure(Launch launch) {
+    launch(0).wait();  // ウォームアップ
+    xrt_fake::reset_counters();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        launch(i).wait();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    Result r;
+    r.us_per_launch = std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS;
+    r.set_args_per_launch = static_cast<double>(xrt_fake::counters().set_args) / ITERATIONS;
+    return r;
+}
+
+static void report(const char* name, const Result& old_path, const Result& new_path) {
+    printf("%-24s %10.2f %10.2f %12.2f %12.2f\n", name, old_path.us_per_launch, new_path.us_per_launch,
+           old_path.set_args_per_launch, new_path.set_args_per_launch);
+}
+
+int main() {
+    xrt_fake::register_kernel("mm", [](const std::vector<xrt_fake::kernel_arg>&) {});
+    xrt_fake::register_kernel("mv", [](const std::vector<xrt_fake::kernel_arg>&) {});
+
+    xrt::device device(0);
+    xrt::kernel mm(device, xrt::uuid("bench"), "mm");
+    xrt::kernel mv(device, xrt::uuid("bench"), "mv");
+    xrt::bo a(device, 256 * sizeof(int), 0), b(device, 256 * sizeof(int), 1), c(device, 256 * sizeof(int), 2);
+    xrt::bo mat(device, 32 * 32 * sizeof(int), 0), x(device, 32 * sizeof(int), 1), y(device, 32 * sizeof(int), 2);
+
+    printf("%-24s %10s %10s %12s %12s\n", "case", "old us", "new us", "old set_arg", "new set_arg");
+
+    // 16x16のmm: 引数はすべて毎回同じ
+    ReusableRun mm_run(mm);
+    report("mm 16x16",
+           measure([&](int) { return mm(a, b, c, 16, 1, 256); }),
+           measure([&](int) -> xrt::run& { return mm_run(a, b, c, 16, 1, 256); }));
+
+    // 32x32のmv: 引数はすべて毎回同じ
+    ReusableRun mv_run(mv);
+    report("mv 32x32",
+           measure([&](int) { return mv(mat, x, y, 32, 32, 1); }),
+           measure([&](int) -> xrt::run& { return mv_run(mat, x, y, 32, 32, 1); }));
+
+    // mv: 呼び出しごとに行数だけが変わる
+    ReusableRun mv_rows_run(mv);
+    report("mv rows change",
+           measure([&](int i) { return mv(mat, x, y, 1 + i % 32, 32, 1); }),
+           measure([&](int i) -> xrt::run& { return mv_rows_run(mat, x, y, 1 + i % 32, 32, 1); }));
+    return 0;
+}
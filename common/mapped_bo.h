@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_device.h>
+
+// ホスト側をmap()したxrt::bo。呼び出し側がdata()へ直接書き込み・読み出しを行い、
+// ホストとデバイス間の転送はto_device()/from_device()のDMA同期だけになる (bo.write/bo.readによるコピーなし)。
+template <typename T>
+class MappedBo {
+public:
+    MappedBo(const xrt::device& device, size_t count, xrt::memory_group group)
+        : bo_(device, (count > 0 ? count : 1) * sizeof(T), group), data_(bo_.map<T*>()), count_(count) {}
+
+    MappedBo(const MappedBo&) = delete;
+    MappedBo& operator=(const MappedBo&) = delete;
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return count_; }
+    size_t bytes() const { return count_ * sizeof(T); }
+    xrt::bo& bo() { return bo_; }
+
+    void to_device() { bo_.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes(), 0); }
+    void from_device() { bo_.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes(), 0); }
+
+private:
+    xrt::bo bo_;
+    T* data_;
+    size_t count_;
+};
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 大きなテストデータの生成と検証を全コアで行うユーティリティ。
+// 乱数はカウンタベース (seed, stream, index のハッシュ) なので、どの要素もどのスレッドからでも
+// 独立に求まり、期待値の配列を持たずに出力をその場で検証できる。
+// データはmapしたBOのホスト側メモリへ直接書けばよく、ホスト側に別のコピーは要らない。
+
+// SplitMix64の最終段。連続する入力をよく混ぜる。
+inline uint64_t counter_rng_mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// (seed, stream) の系列のindex番目の64ビット乱数
+inline uint64_t counter_rng(uint64_t seed, uint64_t stream, uint64_t index) {
+    return counter_rng_mix(counter_rng_mix(seed ^ counter_rng_mix(stream)) + index);
+}
+
+// 0以上bound未満の乱数 (テストデータ用なので剰余の偏りは無視する)
+inline int counter_rng_int(uint64_t seed, uint64_t stream, uint64_t index, int bound) {
+    return static_cast<int>(counter_rng(seed, stream, index) % static_cast<uint64_t>(bound));
+}
+
+// 既定のスレッド数 (論理コア数)
+inline int parallel_data_threads() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n ? static_cast<int>(n) : 1;
+}
+
+// [0, count) をthreads個の連続した範囲に分け、fn(begin, end) を並列に呼ぶ
+template <typename Fn>
+void parallel_for_range(size_t count, Fn fn, int threads = parallel_data_threads()) {
+    size_t workers = std::max<size_t>(1, std::min<size_t>(threads > 0 ? threads : 1, count));
+    size_t step = (count + workers - 1) / workers;
+    if (workers == 1) {
+        fn(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; ++w) {
+        size_t begin = std::min(count, w * step);
+        size_t end = std::min(count, begin + step);
+        pool.emplace_back([=] { fn(begin, end); });
+    }
+    fn(size_t(0), std::min(count, step));
+    for (auto& t : pool) {
+        t.join();
+    }
+}
+
+// data[i] = counter_rng_int(seed, stream, i, bound)
+inline void parallel_fill(int* data, size_t count, uint64_t seed, uint64_t stream, int bound,
+                          int threads = parallel_data_threads()) {
+    parallel_for_range(count, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            data[i] = counter_rng_int(seed, stream, i, bound);
+        }
+    }, threads);
+}
+
+// data[i] == expected(i) をすべてのiについて調べ、一致しない最小のindexを返す (すべて一致すればcount)
+template <typename Expected>
+size_t parallel_find_mismatch(const int* data, size_t count, Expected expected, int threads = parallel_data_threads()) {
+    std::atomic<size_t> first(count);
+    parallel_for_range(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && i < first.load(std::memory_order_relaxed); ++i) {
+            if (data[i] != expected(i)) {
+                size_t current = first.load();
+                while (i < current && !first.compare_exchange_weak(current, i)) {
+                }
+                return;
+            }
+        }
+    }, threads);
+    return first.load();
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "parallel_data.h"
+#include "test_check.h"
+
+// プロセスの最大RSS (バイト)
+static size_t peak_rss_bytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// スレッド数によらず同じ値になり、値は [0, bound) に収まる
+bool test_deterministic() {
+    const size_t count = 100003;
+    std::vector<int> serial(count), parallel(count), other(count);
+    parallel_fill(serial.data(), count, 42, 0, 100, 1);
+    parallel_fill(parallel.data(), count, 42, 0, 100, 7);
+    parallel_fill(other.data(), count, 42, 1, 100, 7);
+
+    bool ok = true;
+    ok &= check(serial == parallel, "same values for any thread count");
+    ok &= check(serial != other, "streams differ");
+    bool in_range = true;
+    std::vector<size_t> histogram(100);
+    for (int v : serial) {
+        in_range &= (v >= 0 && v < 100);
+        if (v >= 0 && v < 100) {
+            histogram[v]++;
+        }
+    }
+    ok &= check(in_range, "values are in [0, bound)");
+    bool spread = true;
+    for (size_t h : histogram) {
+        spread &= (h > count / 100 / 2 && h < count / 100 * 2);
+    }
+    ok &= check(spread, "values are spread over the range");
+    ok &= check(serial[12345] == counter_rng_int(42, 0, 12345, 100), "any element can be recomputed");
+    return ok;
+}
+
+// 期待値の配列なしで検証し、最初の不一致を見つける
+bool test_find_mismatch() {
+    const size_t count = 1 << 20;
+    std::vector<int> data(count);
+    parallel_fill(data.data(), count, 7, 3, 1000);
+    auto expected = [](size_t i) { return counter_rng_int(7, 3, i, 1000); };
+
+    bool ok = true;
+    ok &= check(parallel_find_mismatch(data.data(), count, expected) == count, "no mismatch");
+    data[900000] += 1;
+    data[300000] += 1;
+    ok &= check(parallel_find_mismatch(data.data(), count, expected, 1) == 300000, "first mismatch (1 thread)");
+    ok &= check(parallel_find_mismatch(data.data(), count, expected, 8) == 300000, "first mismatch (8 threads)");
+    ok &= check(parallel_find_mismatch(data.data(), 0, expected) == 0, "empty range");
+    return ok;
+}
+
+// maximum_bandwidthと同じ形 (入力4つ、出力4つ) で、生成と検証の時間と最大RSSを測る。
+// ホスト側に期待値の配列を持たないので、RSSの増加はバッファ8つ分に収まる。
+bool test_setup_cost() {
+    const size_t count = 16 * 1024 * 1024 / sizeof(int);
+    const int banks = 4;
+    const uint64_t seed = 2025;
+
+    size_t rss_before = peak_rss_bytes();
+    std::vector<int*> inputs, outputs;
+    for (int bank = 0; bank < banks; ++bank) {
+        inputs.push_back(static_cast<int*>(std::malloc(count * sizeof(int))));
+        outputs.push_back(static_cast<int*>(std::malloc(count * sizeof(int))));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int bank = 0; bank < banks; ++bank) {
+        parallel_fill(inputs[bank], count, seed, bank, 100);
+    }
+    double fill_ms = elapsed_ms(start);
+
+    // カーネルの代わり: 出力 = 入力 + バンク番号 + 1
+    for (int bank = 0; bank < banks; ++bank) {
+        int* in = inputs[bank];
+        int* out = outputs[bank];
+        parallel_for_range(count, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = in[i] + bank + 1;
+            }
+        });
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    bool verified = true;
+    for (int bank = 0; bank < banks; ++bank) {
+        auto expected = [=](size_t i) { return counter_rng_int(seed, bank, i, 100) + bank + 1; };
+        verified &= (parallel_find_mismatch(outputs[bank], count, expected) == count);
+    }
+    double verify_ms = elapsed_ms(start);
+
+    // 比較用: 従来のシングルスレッドのrand()
+    std::vector<int> legacy(count);
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        legacy[i] = rand() % 100;
+    }
+    double legacy_ms = elapsed_ms(start) * banks;
+    size_t rss_growth = peak_rss_bytes() - rss_before;
+
+    const size_t buffer_bytes = count * sizeof(int) * 2 * banks;
+    std::cout << "  " << parallel_data_threads() << " threads, " << (buffer_bytes >> 20) << " MiB of buffers: fill "
+              << fill_ms << " ms (single-thread rand() " << legacy_ms << " ms), verify " << verify_ms
+              << " ms, peak RSS growth " << (rss_growth >> 20) << " MiB" << std::endl;
+
+    for (int bank = 0; bank < banks; ++bank) {
+        std::free(inputs[bank]);
+        std::free(outputs[bank]);
+    }
+
+    bool ok = true;
+    ok &= check(verified, "outputs verify against recomputed inputs");
+    ok &= check(rss_growth <= buffer_bytes + count * sizeof(int) + 16 * 1024 * 1024,
+                "no expected arrays are kept in host memory");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running parallel data generation software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_deterministic();
+    ok &= test_find_mismatch();
+    ok &= test_setup_cost();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+
+// 複数のBOのsyncを固定数のワーカースレッドから同時に発行するプール (SyncPool)。
+// 各BOの先頭bytesバイトをスレッド数に応じたスライスに分け、ワーカーが順に取り出してsyncする。
+// スレッドは生成時に起動して使い回すため、計測にスレッド生成の時間は含まれない。
+// sync_all()は1つのスレッドからだけ呼ぶこと。
+
+class SyncPool {
+public:
+    static const size_t SLICE_ALIGN = 4096;  // スライスの境界 (ページ単位)
+
+    explicit SyncPool(int threads) {
+        for (int t = 0; t < (threads > 0 ? threads : 1); ++t) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ~SyncPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+
+    SyncPool(const SyncPool&) = delete;
+    SyncPool& operator=(const SyncPool&) = delete;
+
+    int threads() const { return static_cast<int>(workers_.size()); }
+
+    // 全BOの先頭bytesバイトをdirの方向にsyncし、全て終わるまで待つ。経過時間 (ms) を返す。
+    // いずれかのsyncが例外を投げた場合は、全スライスの終了後に最初の例外を投げ直す。
+    double sync_all(std::vector<xrt::bo>& bos, size_t bytes, xclBOSyncDirection dir) {
+        std::vector<Slice> slices = split(bos, bytes);
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slices_ = &slices;
+            dir_ = dir;
+            next_ = 0;
+            remaining_ = slices.size();
+            error_ = nullptr;
+            ++generation_;
+            start_cv_.notify_all();
+            // 遅れて起きたワーカーがこの呼び出しのスライスを参照し終えるまで待つ
+            done_cv_.wait(lock, [this] { return remaining_ == 0 && active_ == 0; });
+            slices_ = nullptr;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    double sync_all(std::vector<xrt::bo>& bos, xclBOSyncDirection dir) {
+        return sync_all(bos, bos.empty() ? 0 : bos.front().size(), dir);
+    }
+
+    // スライス数: 全スレッドに仕事が行き渡るよう、1つのBOを ceil(threads / BO数) 個に分ける
+    size_t slices_per_bo(size_t num_bos) const {
+        size_t t = workers_.size();
+        return num_bos == 0 ? 0 : (t + num_bos - 1) / num_bos;
+    }
+
+private:
+    struct Slice {
+        xrt::bo* bo;
+        size_t offset;
+        size_t size;
+    };
+
+    std::vector<Slice> split(std::vector<xrt::bo>& bos, size_t bytes) const {
+        std::vector<Slice> slices;
+        size_t per_bo = slices_per_bo(bos.size());
+        for (xrt::bo& bo : bos) {
+            size_t length = bytes < bo.size() ? bytes : bo.size();
+            size_t step = (length + per_bo - 1) / per_bo;
+            step = (step + SLICE_ALIGN - 1) / SLICE_ALIGN * SLICE_ALIGN;
+            for (size_t offset = 0; offset < length; offset += step) {
+                slices.push_back({&bo, offset, (length - offset < step) ? length - offset : step});
+            }
+        }
+        return slices;
+    }
+
+    void work() {
+        uint64_t seen = 0;
+        while (true) {
+            std::vector<Slice>* slices;
+            xclBOSyncDirection dir;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                if (!slices_) {
+                    continue;  // 起きる前に終わった呼び出し
+                }
+                slices = slices_;
+                dir = dir_;
+                ++active_;
+            }
+            size_t finished = 0;
+            std::exception_ptr error;
+            for (size_t i = next_++; i < slices->size(); i = next_++) {
+                const Slice& s = (*slices)[i];
+                try {
+                    s.bo->sync(dir, s.size, s.offset);
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                ++finished;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !error_) {
+                error_ = error;
+            }
+            remaining_ -= finished;
+            --active_;
+            if (remaining_ == 0 && active_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    bool stop_ = false;
+    uint64_t generation_ = 0;
+    std::vector<Slice>* slices_ = nullptr;
+    xclBOSyncDirection dir_ = XCL_BO_SYNC_BO_TO_DEVICE;
+    std::atomic<size_t> next_{0};
+    size_t remaining_ = 0;
+    int active_ = 0;  // スライスを取り出している最中のワーカー数
+    std::exception_ptr error_;
+};
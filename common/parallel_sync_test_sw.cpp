@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "parallel_sync.h"
+#include "test_check.h"
+
+static const size_t MIB = 1024 * 1024;
+
+static std::vector<xrt::bo> make_bos(xrt::device& device, int count, size_t bytes) {
+    std::vector<xrt::bo> bos;
+    for (int i = 0; i < count; ++i) {
+        bos.emplace_back(device, bytes, 0);
+        std::vector<char> data(bytes, static_cast<char>(i + 1));
+        bos.back().write(data.data());
+    }
+    return bos;
+}
+
+// 全BOの先頭bytesバイトがデバイス側へ届いているか
+static bool on_device(const std::vector<xrt::bo>& bos, size_t bytes) {
+    for (size_t i = 0; i < bos.size(); ++i) {
+        for (size_t j = 0; j < bytes; ++j) {
+            if (bos[i].device_data()[j] != static_cast<char>(i + 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// syncが転送量に比例して時間がかかるとき、スレッドを増やすと全体の時間が短くなる
+bool test_concurrent_speedup() {
+    xrt::device device(0);
+    xrt_fake::latency().sync_us_per_mib = 4000.0;  // 1MiBあたり4ms (memcpyより十分長く)
+
+    std::vector<xrt::bo> bos = make_bos(device, 4, 8 * MIB);
+    SyncPool serial(1);
+    SyncPool parallel(4);
+
+    xrt_fake::reset_counters();
+    double serial_ms = serial.sync_all(bos, XCL_BO_SYNC_BO_TO_DEVICE);
+    bool ok = true;
+    ok &= check(xrt_fake::counters().bytes_to_device == 4 * 8 * MIB, "serial sync transfers every byte once");
+    ok &= check(on_device(bos, 8 * MIB), "serial sync reaches the device");
+
+    xrt_fake::reset_counters();
+    double parallel_ms = parallel.sync_all(bos, XCL_BO_SYNC_BO_TO_DEVICE);
+    ok &= check(xrt_fake::counters().bytes_to_device == 4 * 8 * MIB, "parallel sync transfers every byte once");
+    ok &= check(xrt_fake::counters().syncs_to_device == 4, "one slice per buffer with 4 threads and 4 buffers");
+
+    std::cout << "  4 x 8 MiB: 1 thread " << serial_ms << " ms, 4 threads " << parallel_ms << " ms" << std::endl;
+    ok &= check(serial_ms >= 120.0, "serial sync takes the modeled time");
+    ok &= check(serial_ms > 2.0 * parallel_ms, "4 threads overlap the transfers");
+
+    xrt_fake::latency().sync_us_per_mib = 0.0;
+    return ok;
+}
+
+// 1つの大きなBOもスライスに分けて同時に転送する
+bool test_single_buffer_is_split() {
+    xrt::device device(0);
+    xrt_fake::latency().sync_us_per_mib = 4000.0;
+
+    std::vector<xrt::bo> bos = make_bos(device, 1, 16 * MIB);
+    SyncPool serial(1);
+    SyncPool parallel(4);
+
+    double serial_ms = serial.sync_all(bos, XCL_BO_SYNC_BO_TO_DEVICE);
+    xrt_fake::reset_counters();
+    double parallel_ms = parallel.sync_all(bos, XCL_BO_SYNC_BO_TO_DEVICE);
+
+    bool ok = true;
+    ok &= check(xrt_fake::counters().syncs_to_device == 4, "the buffer is split into 4 slices");
+    ok &= check(xrt_fake::counters().bytes_to_device == 16 * MIB, "slices cover the buffer exactly");
+    ok &= check(serial_ms > 2.0 * parallel_ms, "slices of one buffer overlap");
+
+    xrt_fake::latency().sync_us_per_mib = 0.0;
+    return ok;
+}
+
+// 先頭の一部だけ、ページ境界に揃わない長さでも過不足なく転送する。デバイスからの方向も確認する。
+bool test_partial_and_from_device() {
+    xrt::device device(0);
+    std::vector<xrt::bo> bos = make_bos(device, 3, MIB);
+    SyncPool pool(8);
+
+    const size_t bytes = 100000;
+    xrt_fake::reset_counters();
+    pool.sync_all(bos, bytes, XCL_BO_SYNC_BO_TO_DEVICE);
+    bool ok = true;
+    ok &= check(xrt_fake::counters().bytes_to_device == 3 * bytes, "only the requested prefix is transferred");
+    ok &= check(on_device(bos, bytes), "prefix reaches the device");
+    ok &= check(bos[0].device_data()[bytes] == 0, "bytes past the prefix stay untouched");
+
+    for (size_t i = 0; i < bos.size(); ++i) {
+        std::memset(bos[i].device_data(), 0x5a, MIB);
+    }
+    pool.sync_all(bos, XCL_BO_SYNC_BO_FROM_DEVICE);
+    std::vector<char> host(MIB);
+    bos[2].read(host.data());
+    ok &= check(host[0] == 0x5a && host[MIB - 1] == 0x5a, "sync from device copies the whole buffer");
+    ok &= check(xrt_fake::counters().bytes_from_device == 3 * MIB, "bytes from device");
+
+    // 同じプールを繰り返し使える
+    for (int i = 0; i < 100; ++i) {
+        pool.sync_all(bos, 4096, XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+    ok &= check(xrt_fake::counters().bytes_to_device == 3 * bytes + 100 * 3 * 4096, "repeated use of the pool");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running SyncPool software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_concurrent_speedup();
+    ok &= test_single_buffer_is_split();
+    ok &= test_partial_and_from_device();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// ランナーの1回の呼び出しを段階 (フェーズ) に分けて時間を測り、フェーズごとにレイテンシのヒストグラムへ積む。
+// 記録は固定のバケット配列へのrelaxedなアトミック加算だけで、ロックもメモリ確保もしないため、
+// 本番でも有効のままにできる。複数のスレッド (submit()や複数カードのシャード) から同時に記録してよい。
+
+enum class Phase {
+    from_numpy,        // 入力のnumpy配列をホストのベクトルへ写す
+    alloc,             // BOの確保・プールからの取得
+    write,             // ホストのデータをBOへ書く (bo.write、詰め替え)
+    sync_to_device,    // ホストからデバイスへのDMA
+    launch,            // カーネルの起動 (引数の設定と開始)
+    wait,              // カーネルの完了待ち
+    sync_from_device,  // デバイスからホストへのDMA
+    read,              // BOから結果を読む (bo.read)
+    to_numpy,          // 結果をnumpy配列へ写す
+    cpu,               // CPUバックエンドでの計算
+    total,             // 呼び出し全体
+};
+
+const size_t NUM_PHASES = static_cast<size_t>(Phase::total) + 1;
+
+inline const char* phase_name(Phase phase) {
+    static const char* const names[NUM_PHASES] = {"from_numpy", "alloc", "write", "sync_to_device", "launch", "wait",
+                                                  "sync_from_device", "read", "to_numpy", "cpu", "total"};
+    return names[static_cast<size_t>(phase)];
+}
+
+// ヒストグラムの要約 (時間はマイクロ秒)
+struct PhaseStats {
+    uint64_t count = 0;
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+// ナノ秒の対数ヒストグラム。2のべき乗の区間をそれぞれ8つに分けるため、パーセンタイルの誤差は1/16以内。
+// 2^40 ns (約18分) 以上は最後のバケットに入る。
+class LatencyHistogram {
+public:
+    static const int SUB_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_BITS = 40;
+    static const size_t NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t ns) {
+        buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = max_ns_.load(std::memory_order_relaxed);
+        while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        sum_ns_.store(0, std::memory_order_relaxed);
+        max_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    // 記録中に呼んでもよいが、その間の値は一部だけが反映されることがある
+    PhaseStats stats() const {
+        PhaseStats s;
+        std::array<uint64_t, NUM_BUCKETS> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return s;
+        }
+        s.count = total;
+        s.max_us = max_ns_.load(std::memory_order_relaxed) / 1000.0;
+        s.mean_us = sum_ns_.load(std::memory_order_relaxed) / 1000.0 / total;
+        s.p50_us = std::min(percentile(counts, total, 0.50), s.max_us);
+        s.p90_us = std::min(percentile(counts, total, 0.90), s.max_us);
+        s.p99_us = std::min(percentile(counts, total, 0.99), s.max_us);
+        return s;
+    }
+
+    // nsが入るバケット。SUB_BUCKETS未満はそのまま、それ以上は最上位ビットの位置と続く3ビットで決める。
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<size_t>(ns);
+        }
+        int msb = 63 - __builtin_clzll(ns);
+        if (msb >= MAX_BITS) {
+            return NUM_BUCKETS - 1;
+        }
+        int shift = msb - SUB_BITS;
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + ((ns >> shift) & (SUB_BUCKETS - 1)));
+    }
+
+    // バケットの下限と幅 (ns)
+    static double bucket_lower(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return static_cast<double>(index);
+        }
+        int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+        uint64_t mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+        return static_cast<double>(mantissa << shift);
+    }
+
+    static double bucket_width(size_t index) {
+        return index < SUB_BUCKETS ? 1.0 : static_cast<double>(uint64_t(1) << (index / SUB_BUCKETS - 1));
+    }
+
+private:
+    // 順位がq * totalに達したバケットの中央の値 (マイクロ秒)
+    static double percentile(const std::array<uint64_t, NUM_BUCKETS>& counts, uint64_t total, double q) {
+        uint64_t rank = static_cast<uint64_t>(q * total);
+        if (rank >= total) {
+            rank = total - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen > rank) {
+                return (bucket_lower(i) + bucket_width(i) / 2.0) / 1000.0;
+            }
+        }
+        return 0.0;
+    }
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_;
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
+
+// フェーズごとのヒストグラム。ランナーはスコープで囲んだ区間を記録する。
+//   PhaseTimer::Scope scope(timer, Phase::sync_to_device);
+// set_enabled(false) の間は時刻も読まない。
+class PhaseTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Scope {
+    public:
+        Scope(PhaseTimer& timer, Phase phase)
+            : timer_(timer.enabled() ? &timer : nullptr), phase_(phase), start_(timer_ ? Clock::now() : Clock::time_point()) {}
+        ~Scope() { stop(); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // スコープの終わりより前に区間を閉じる (2回目以降は何もしない)
+        void stop() {
+            if (timer_) {
+                timer_->record(phase_, Clock::now() - start_);
+                timer_ = nullptr;
+            }
+        }
+
+    private:
+        PhaseTimer* timer_;
+        Phase phase_;
+        Clock::time_point start_;
+    };
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    void record(Phase phase, Clock::duration elapsed) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        histograms_[static_cast<size_t>(phase)].record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    const LatencyHistogram& histogram(Phase phase) const { return histograms_[static_cast<size_t>(phase)]; }
+    PhaseStats stats(Phase phase) const { return histogram(phase).stats(); }
+
+    void reset() {
+        for (auto& histogram : histograms_) {
+            histogram.reset();
+        }
+    }
+
+private:
+    std::atomic<bool> enabled_{true};
+    std::array<LatencyHistogram, NUM_PHASES> histograms_;
+};
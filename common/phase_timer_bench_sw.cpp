@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "cpu_backend.h"
+#include "phase_timer.h"
+
+// フェーズ計測のコスト。1スコープあたりの時間 (有効・無効) と、CPUバックエンドのvaddを
+// Pythonのラッパーと同じくtotalとcpuのスコープで囲んだときの増分を表示する。
+// CPUバックエンドは転送がなく呼び出しが最も短いため、計測の割合が最も大きく出る経路になる。
+
+const int SCOPE_ITERATIONS = 1000000;
+const int REPEATS = 7;
+
+template <typename Fn>
+static double median_ns_per_call(int calls, Fn fn) {
+    std::vector<double> samples;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            fn();
+        }
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / calls);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[REPEATS / 2];
+}
+
+int main() {
+    PhaseTimer timer;
+    double enabled_ns = median_ns_per_call(SCOPE_ITERATIONS, [&] { PhaseTimer::Scope scope(timer, Phase::launch); });
+    timer.set_enabled(false);
+    double disabled_ns = median_ns_per_call(SCOPE_ITERATIONS, [&] { PhaseTimer::Scope scope(timer, Phase::launch); });
+    timer.set_enabled(true);
+    printf("scope enabled:  %8.1f ns\n", enabled_ns);
+    printf("scope disabled: %8.1f ns\n", disabled_ns);
+    // FPGAの同期経路は1回の呼び出しで最大10スコープ (total, from_numpy, alloc, write, sync_to_device, launch, wait,
+    // sync_from_device, read, to_numpy) を記録する
+    printf("per FPGA call (10 scopes): %6.2f us\n\n", enabled_ns * 10 / 1000.0);
+
+    printf("%10s %12s %12s %10s\n", "vadd size", "plain us", "timed us", "overhead");
+    for (int size : {1 << 10, 1 << 14, 1 << 18, 1 << 22}) {
+        std::vector<int> a(size), b(size), c(size);
+        for (int i = 0; i < size; ++i) {
+            a[i] = rand() % 201 - 100;
+            b[i] = rand() % 201 - 100;
+        }
+        int calls = std::max(8, (1 << 24) / size);
+        double plain_ns = median_ns_per_call(calls, [&] { cpu_vadd(a.data(), b.data(), c.data(), size); });
+        double timed_ns = median_ns_per_call(calls, [&] {
+            PhaseTimer::Scope total(timer, Phase::total);
+            PhaseTimer::Scope cpu(timer, Phase::cpu);
+            cpu_vadd(a.data(), b.data(), c.data(), size);
+        });
+        printf("%10d %12.2f %12.2f %9.2f%%\n", size, plain_ns / 1000.0, timed_ns / 1000.0,
+               (timed_ns - plain_ns) / plain_ns * 100.0);
+    }
+    return 0;
+}
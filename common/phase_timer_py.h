@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include "phase_timer.h"
+
+// get_phase_stats() の戻り値: 記録のあるフェーズ名 -> {count, mean_us, p50_us, p90_us, p99_us, max_us}
+inline pybind11::dict phase_stats_dict(const PhaseTimer& timer) {
+    pybind11::dict result;
+    for (size_t i = 0; i < NUM_PHASES; ++i) {
+        Phase phase = static_cast<Phase>(i);
+        PhaseStats s = timer.stats(phase);
+        if (s.count == 0) {
+            continue;
+        }
+        pybind11::dict d;
+        d["count"] = s.count;
+        d["mean_us"] = s.mean_us;
+        d["p50_us"] = s.p50_us;
+        d["p90_us"] = s.p90_us;
+        d["p99_us"] = s.p99_us;
+        d["max_us"] = s.max_us;
+        result[phase_name(phase)] = d;
+    }
+    return result;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "phase_timer.h"
+#include "test_check.h"
+
+static bool near(double value, double expected, double tolerance) {
+    return std::fabs(value - expected) <= expected * tolerance;
+}
+
+// バケットは値を含み、下限は単調に増え、幅は下限の1/8以下
+bool test_buckets() {
+    bool ok = true;
+    for (uint64_t ns : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull, (1ull << 39) + 5}) {
+        size_t i = LatencyHistogram::bucket_of(ns);
+        double lower = LatencyHistogram::bucket_lower(i);
+        ok &= check(lower <= ns && ns < lower + LatencyHistogram::bucket_width(i), "bucket contains the value");
+    }
+    for (size_t i = 1; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+        ok &= check(LatencyHistogram::bucket_lower(i) > LatencyHistogram::bucket_lower(i - 1), "bucket bounds increase");
+        if (i >= LatencyHistogram::SUB_BUCKETS) {
+            ok &= check(LatencyHistogram::bucket_width(i) * 8 <= LatencyHistogram::bucket_lower(i), "bucket width is at most 1/8");
+        }
+    }
+    ok &= check(LatencyHistogram::bucket_of(~0ull) == LatencyHistogram::NUM_BUCKETS - 1, "huge values go to the last bucket");
+    return ok;
+}
+
+// 1..1000 us の一様分布: 平均と最大は正確に、パーセンタイルは1/16以内
+bool test_percentiles() {
+    LatencyHistogram h;
+    for (uint64_t us = 1; us <= 1000; ++us) {
+        h.record(us * 1000);
+    }
+    PhaseStats s = h.stats();
+    bool ok = true;
+    ok &= check(s.count == 1000, "count");
+    ok &= check(near(s.mean_us, 500.5, 1e-9), "mean is exact");
+    ok &= check(s.max_us == 1000.0, "max is exact");
+    ok &= check(near(s.p50_us, 500.0, 1.0 / 16), "p50");
+    ok &= check(near(s.p90_us, 900.0, 1.0 / 16), "p90");
+    ok &= check(near(s.p99_us, 990.0, 1.0 / 16), "p99");
+    ok &= check(s.p99_us <= s.max_us, "percentiles do not exceed the max");
+
+    // 1件だけ遅い外れ値はp50に影響せず、maxに現れる
+    LatencyHistogram tail;
+    for (int i = 0; i < 999; ++i) {
+        tail.record(10000);
+    }
+    tail.record(5000000);
+    PhaseStats t = tail.stats();
+    ok &= check(near(t.p50_us, 10.0, 1.0 / 16) && near(t.p99_us, 10.0, 1.0 / 16), "outlier does not move p50 and p99");
+    ok &= check(t.max_us == 5000.0, "outlier is the max");
+    return ok;
+}
+
+// 複数スレッドから同時に記録しても件数と合計は欠けない
+bool test_concurrent() {
+    const int THREADS = 4;
+    const int PER_THREAD = 100000;
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&h, t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                h.record(1000 * (t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    PhaseStats s = h.stats();
+    bool ok = true;
+    ok &= check(s.count == THREADS * PER_THREAD, "no lost records");
+    ok &= check(near(s.mean_us, 2.5, 1e-9), "no lost sums");
+    ok &= check(s.max_us == 4.0, "max across threads");
+    return ok;
+}
+
+bool test_timer() {
+    PhaseTimer timer;
+    bool ok = true;
+    {
+        PhaseTimer::Scope total(timer, Phase::total);
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        wait.stop();
+        wait.stop();  // 2回目は記録しない
+    }
+    ok &= check(timer.stats(Phase::wait).count == 1 && timer.stats(Phase::total).count == 1, "one record per scope");
+    ok &= check(timer.stats(Phase::wait).max_us >= 2000.0, "scope measures the elapsed time");
+    ok &= check(timer.stats(Phase::total).max_us >= timer.stats(Phase::wait).max_us, "outer scope covers the inner one");
+    ok &= check(timer.stats(Phase::alloc).count == 0, "other phases are untouched");
+
+    timer.set_enabled(false);
+    {
+        PhaseTimer::Scope launch(timer, Phase::launch);
+    }
+    ok &= check(timer.stats(Phase::launch).count == 0, "disabled timer records nothing");
+
+    timer.set_enabled(true);
+    timer.reset();
+    ok &= check(timer.stats(Phase::wait).count == 0 && timer.stats(Phase::total).max_us == 0.0, "reset clears every phase");
+    ok &= check(std::string(phase_name(Phase::sync_from_device)) == "sync_from_device", "phase names");
+    ok &= check(std::string(phase_name(Phase::from_numpy)) == "from_numpy" && std::string(phase_name(Phase::total)) == "total",
+                "phase names cover the whole enum");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running PhaseTimer software test" << std::endl;
+    bool ok = true;
+    ok &= test_buckets();
+    ok &= test_percentiles();
+    ok &= test_concurrent();
+    ok &= test_timer();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_kernel.h>
+
+// xrt::runを1回だけ作って使い回す起動ハンドル。
+// krnl(args...) は呼び出しごとにrunを作って全引数を設定し直すが、ReusableRunは前回と値が変わった
+// 引数だけをset_argで更新してstart()する。BO引数はデバイスアドレスで比較する。
+// 同じrunを再起動するため、前回の実行の完了を待ってから次を呼び出すこと (同期実行の経路向け)。
+class ReusableRun {
+public:
+    ReusableRun() = default;
+    explicit ReusableRun(const xrt::kernel& kernel) : run_(kernel) {}
+
+    template <typename... Args>
+    xrt::run& operator()(const Args&... args) {
+        int index = 0;
+        (update(index++, args), ...);
+        run_.start();
+        launches_++;
+        return run_;
+    }
+
+    xrt::run& run() { return run_; }
+
+    // 起動回数と、実際に呼んだset_argの回数
+    uint64_t launches() const { return launches_; }
+    uint64_t set_arg_calls() const { return set_arg_calls_; }
+
+private:
+    struct Slot {
+        bool valid = false;
+        bool is_bo = false;
+        uint64_t value = 0;
+    };
+
+    void update(int index, const xrt::bo& value) {
+        if (changed(index, true, value.address())) {
+            run_.set_arg(index, value);
+        }
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    void update(int index, T value) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        if (changed(index, false, bits)) {
+            run_.set_arg(index, value);
+        }
+    }
+
+    bool changed(int index, bool is_bo, uint64_t value) {
+        if (static_cast<size_t>(index) >= slots_.size()) {
+            slots_.resize(index + 1);
+        }
+        Slot& slot = slots_[index];
+        if (slot.valid && slot.is_bo == is_bo && slot.value == value) {
+            return false;
+        }
+        slot.valid = true;
+        slot.is_bo = is_bo;
+        slot.value = value;
+        set_arg_calls_++;
+        return true;
+    }
+
+    xrt::run run_;
+    std::vector<Slot> slots_;
+    uint64_t launches_ = 0;
+    uint64_t set_arg_calls_ = 0;
+};
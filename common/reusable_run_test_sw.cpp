@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <iostream>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "reusable_run.h"
+#include "test_check.h"
+
+static void register_vadd() {
+    xrt_fake::register_kernel("vadd", [](const std::vector<xrt_fake::kernel_arg>& args) {
+        const int* a = args[0].ptr<int>();
+        const int* b = args[1].ptr<int>();
+        int* c = args[2].ptr<int>();
+        for (int i = 0; i < args[3].scalar; ++i) {
+            c[i] = a[i] + b[i];
+        }
+    });
+}
+
+// 引数が変わらなければ2回目以降はset_argを呼ばない
+bool test_unchanged_args() {
+    register_vadd();
+    xrt::device device(0);
+    xrt::kernel kernel(device, xrt::uuid("test"), "vadd");
+    const int size = 64;
+    xrt::bo a(device, size * sizeof(int), 0), b(device, size * sizeof(int), 1), c(device, size * sizeof(int), 2);
+    std::vector<int> ones(size, 1);
+    a.write(ones.data());
+    b.write(ones.data());
+    a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+    xrt_fake::reset_counters();
+    ReusableRun launch(kernel);
+    for (int i = 0; i < 10; ++i) {
+        launch(a, b, c, size).wait();
+    }
+    c.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    std::vector<int> result(size);
+    c.read(result.data());
+
+    bool ok = true;
+    ok &= check(xrt_fake::counters().set_args == 4, "four set_arg calls for ten launches");
+    ok &= check(xrt_fake::counters().kernel_launches == 10, "ten launches");
+    ok &= check(launch.launches() == 10 && launch.set_arg_calls() == 4, "launch statistics");
+    ok &= check(result[size - 1] == 2, "result");
+    return ok;
+}
+
+// 変わった引数だけを更新し、その値でカーネルが実行される
+bool test_changed_args() {
+    register_vadd();
+    xrt::device device(0);
+    xrt::kernel kernel(device, xrt::uuid("test"), "vadd");
+    const int size = 64;
+    xrt::bo a(device, size * sizeof(int), 0), b(device, size * sizeof(int), 1);
+    xrt::bo c1(device, size * sizeof(int), 2), c2(device, size * sizeof(int), 2);
+    std::vector<int> ones(size, 1);
+    a.write(ones.data());
+    b.write(ones.data());
+    a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+    xrt_fake::reset_counters();
+    ReusableRun launch(kernel);
+    launch(a, b, c1, size).wait();
+    launch(a, b, c2, size / 2).wait();  // 出力BOとsizeだけが変わる
+    launch(a, b, c2, size / 2).wait();
+    xrt::bo c2_half(c2, size / 2 * sizeof(int), size / 2 * sizeof(int));
+    launch(a, b, c2_half, size / 2).wait();  // サブバッファはアドレスが異なる
+
+    c1.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    c2.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    std::vector<int> r1(size), r2(size);
+    c1.read(r1.data());
+    c2.read(r2.data());
+
+    bool ok = true;
+    ok &= check(xrt_fake::counters().set_args == 4 + 2 + 0 + 1, "only changed arguments are set");
+    ok &= check(r1[size - 1] == 2, "first output written");
+    ok &= check(r2[0] == 2 && r2[size - 1] == 2, "second output written through both launches");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running ReusableRun software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_unchanged_args();
+    ok &= test_changed_args();
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// ソフトウェアテストの確認項目。失敗したら項目名を標準エラーに出し、condをそのまま返す (ok &= check(...) で集計する)。
+inline bool check(bool cond, const char* what) {
+    if (!cond) {
+        std::cerr << "Check failed: " << what << std::endl;
+    }
+    return cond;
+}
+
+inline bool check(bool cond, const std::string& what) {
+    return check(cond, what.c_str());
+}
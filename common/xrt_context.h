@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <xrt/xrt_device.h>
+#include <xrt/xrt_kernel.h>
+
+// プロセス全体で共有するデバイスとxclbinのキャッシュ。
+// (デバイス番号, xclbinのUUID) ごとにload_xclbinを1回だけ行い、同じxclbinを使うランナーは
+// デバイスとカーネルのハンドルを共有する。同じデバイスへ別のxclbinを書き込むと、
+// 以前のxclbinのコンテキストはキャッシュから外れる (そのカーネルハンドルは使えなくなる)。
+// xclbinのUUIDも (デバイス番号, パス) ごとに最初の1回だけファイルから読む。プロセスの実行中に
+// 同じパスのxclbinを作り直した場合は、set_loader() でキャッシュを空にするまで以前のUUIDを使う。
+class XrtContext {
+public:
+    // デバイスを開く・xclbinのUUIDを読む・xclbinを書き込む処理。テストではスタブに差し替える。
+    struct Loader {
+        std::function<xrt::device(unsigned int)> open_device;
+        std::function<xrt::uuid(const std::string&)> read_uuid;
+        std::function<xrt::uuid(xrt::device&, const std::string&)> load_xclbin;
+    };
+
+    static Loader default_loader() {
+        Loader loader;
+        loader.open_device = [](unsigned int index) { return xrt::device(index); };
+        loader.read_uuid = [](const std::string& path) { return xrt::xclbin(path).get_uuid(); };
+        loader.load_xclbin = [](xrt::device& device, const std::string& path) { return device.load_xclbin(path); };
+        return loader;
+    }
+
+    // xclbinを書き込み済みのコンテキストを返す。未ロードなら書き込む。スレッドセーフ。
+    static std::shared_ptr<XrtContext> get(const std::string& xclbin_path, unsigned int device_index = 0) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        auto key = std::make_pair(device_index, xclbin_path);
+        auto known = r.uuids.find(key);
+        if (known == r.uuids.end()) {
+            known = r.uuids.emplace(key, r.loader.read_uuid(xclbin_path)).first;
+        }
+        const xrt::uuid& uuid = known->second;
+        auto loaded = r.loaded.find(device_index);
+        if (loaded != r.loaded.end() && loaded->second->uuid_ == uuid) {
+            return loaded->second;
+        }
+
+        auto device = r.devices.find(device_index);
+        if (device == r.devices.end()) {
+            device = r.devices.emplace(device_index, r.loader.open_device(device_index)).first;
+        }
+        xrt::uuid loaded_uuid = r.loader.load_xclbin(device->second, xclbin_path);
+        auto context = std::shared_ptr<XrtContext>(new XrtContext(device->second, loaded_uuid, device_index));
+        r.loaded[device_index] = context;
+        return context;
+    }
+
+    // ローダーを差し替え、キャッシュを空にする (テスト用)
+    static void set_loader(Loader loader) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.loader = std::move(loader);
+        r.devices.clear();
+        r.loaded.clear();
+        r.uuids.clear();
+    }
+
+    XrtContext(const XrtContext&) = delete;
+    XrtContext& operator=(const XrtContext&) = delete;
+
+    const xrt::device& device() const { return device_; }
+    const xrt::uuid& uuid() const { return uuid_; }
+    unsigned int device_index() const { return device_index_; }
+
+    // カーネルハンドルを名前ごとに1回だけ作って共有する
+    xrt::kernel kernel(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = kernels_.find(name);
+        if (it == kernels_.end()) {
+            it = kernels_.emplace(name, xrt::kernel(device_, uuid_, name)).first;
+        }
+        return it->second;
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        Loader loader = default_loader();
+        std::map<unsigned int, xrt::device> devices;
+        std::map<unsigned int, std::shared_ptr<XrtContext>> loaded;  // デバイスごとに現在書き込まれているxclbin
+        std::map<std::pair<unsigned int, std::string>, xrt::uuid> uuids;  // (デバイス番号, パス) ごとに読んだUUID
+    };
+
+    static Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    XrtContext(const xrt::device& device, const xrt::uuid& uuid, unsigned int device_index)
+        : device_(device), uuid_(uuid), device_index_(device_index) {}
+
+    xrt::device device_;
+    xrt::uuid uuid_;
+    unsigned int device_index_;
+    std::mutex mutex_;
+    std::map<std::string, xrt::kernel> kernels_;
+};
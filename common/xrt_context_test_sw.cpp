@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "xrt_context.h"
+#include "test_check.h"
+
+static std::atomic<int> device_opens{0};
+static std::atomic<int> xclbin_loads{0};
+static std::atomic<int> uuid_reads{0};
+
+// カードへの書き込みを模擬するスタブ。1回の書き込みに20msかかる。
+static void install_stub_loader() {
+    device_opens = 0;
+    xclbin_loads = 0;
+    uuid_reads = 0;
+    XrtContext::Loader loader;
+    loader.open_device = [](unsigned int index) {
+        device_opens++;
+        return xrt::device(index);
+    };
+    loader.read_uuid = [](const std::string& path) {
+        uuid_reads++;
+        return xrt::uuid("stub-" + path);
+    };
+    loader.load_xclbin = [](xrt::device&, const std::string& path) {
+        xclbin_loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return xrt::uuid("stub-" + path);
+    };
+    XrtContext::set_loader(loader);
+}
+
+// 同じxclbinは1回だけ書き込み、コンテキストとカーネルハンドルを共有する
+bool test_load_once() {
+    install_stub_loader();
+    auto a = XrtContext::get("vadd.xclbin");
+    auto b = XrtContext::get("vadd.xclbin");
+
+    bool ok = true;
+    ok &= check(a == b, "same context for the same xclbin");
+    ok &= check(xclbin_loads == 1, "xclbin loaded once");
+    ok &= check(device_opens == 1, "device opened once");
+    ok &= check(uuid_reads == 1, "xclbin file parsed only on the first get");
+
+    xrt::kernel k1 = a->kernel("vadd");
+    xrt::kernel k2 = b->kernel("vadd");
+    ok &= check(&k1.name() == &k2.name(), "kernel handle shared");
+    return ok;
+}
+
+// 複数スレッドから同時に要求しても書き込みは1回
+bool test_threads() {
+    install_stub_loader();
+    const int NUM_THREADS = 8;
+    std::vector<std::shared_ptr<XrtContext>> contexts(NUM_THREADS);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&contexts, t] {
+            contexts[t] = XrtContext::get("mm.xclbin");
+            contexts[t]->kernel("mm");
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "  " << NUM_THREADS << " runners started in " << elapsed_ms << " ms" << std::endl;
+
+    bool ok = true;
+    ok &= check(xclbin_loads == 1, "concurrent requests load once");
+    for (int t = 1; t < NUM_THREADS; ++t) {
+        ok &= check(contexts[t] == contexts[0], "all threads share the context");
+    }
+    return ok;
+}
+
+// 別のxclbinを書き込むと以前のコンテキストは外れ、再度要求すると書き込み直す
+bool test_switch_image() {
+    install_stub_loader();
+    auto a = XrtContext::get("burst_32.xclbin");
+    auto b = XrtContext::get("burst_64.xclbin");
+    auto c = XrtContext::get("burst_64.xclbin");
+    auto d = XrtContext::get("burst_32.xclbin");
+
+    bool ok = true;
+    ok &= check(b == c, "current image reused");
+    ok &= check(a != d, "replaced image gets a new context");
+    ok &= check(xclbin_loads == 3, "loads only when the image changes");
+    ok &= check(uuid_reads == 2, "uuid read once per path");
+    ok &= check(device_opens == 1, "device opened once");
+    return ok;
+}
+
+// デバイス番号が異なればそれぞれに書き込む
+bool test_devices() {
+    install_stub_loader();
+    auto a = XrtContext::get("vadd.xclbin", 0);
+    auto b = XrtContext::get("vadd.xclbin", 1);
+    auto c = XrtContext::get("vadd.xclbin", 1);
+
+    bool ok = true;
+    ok &= check(a != b && b == c, "one context per device");
+    ok &= check(b->device_index() == 1, "device index recorded");
+    ok &= check(xclbin_loads == 2 && device_opens == 2, "each device loaded once");
+    return ok;
+}
+
+int main() {
+    std::cout << "Running XrtContext software test" << std::endl;
+
+    bool ok = true;
+    ok &= test_load_once();
+    ok &= test_threads();
+    ok &= test_switch_image();
+    ok &= test_devices();
+    XrtContext::set_loader(XrtContext::default_loader());
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+
+// maximum_bandwidthカーネルとホストで共有する定数。
+// 各ポートは512ビット (intが16個) のワード単位で読み書きするため、入出力のバッファは
+// maximum_bandwidth_padded_size(size) 個のintを確保する。size以降の末尾の値は不定になる。
+
+// 1回のバーストで読み書きするワード数 (max_read/write_burst_lengthとFIFOの深さ、256以下)。ビルド時に -D で変更できる。
+#ifndef MAXIMUM_BANDWIDTH_CHUNK
+#define MAXIMUM_BANDWIDTH_CHUNK 64
+#endif
+
+const int MAXIMUM_BANDWIDTH_LANES = 16;  // 1ワードあたりのint数
+
+inline int maximum_bandwidth_num_words(int size) {
+    return (size + MAXIMUM_BANDWIDTH_LANES - 1) / MAXIMUM_BANDWIDTH_LANES;
+}
+
+inline size_t maximum_bandwidth_padded_size(int size) {
+    return static_cast<size_t>(maximum_bandwidth_num_words(size)) * MAXIMUM_BANDWIDTH_LANES;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "ap_int.h"
+#include "hls_stream.h"
+
+#include "kernel_profile_counter.h"
+#include "maximum_bandwidth.h"
+
+typedef ap_uint<512> mb_word_t;
+
+// 読み出し: 全ワードを1つのパイプラインループで読む。バーストはm_axiがmax_read_burst_length
+// (MAXIMUM_BANDWIDTH_CHUNKワード) ごとに切るので、チャンクの境目でもパイプラインは止まらない
+static void read_words(const mb_word_t* in, hls::stream<mb_word_t>& out, int size) {
+    const int num_words = maximum_bandwidth_num_words(size);
+read_loop:
+    for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=1
+        out.write(in[i]);
+    }
+}
+
+// 演算: ワード内の16個のintにvalueを足す
+static void add_words(hls::stream<mb_word_t>& in, hls::stream<mb_word_t>& out, int size, int value) {
+    const int num_words = maximum_bandwidth_num_words(size);
+add_loop:
+    for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=1
+        mb_word_t word = in.read();
+        mb_word_t result;
+        for (int lane = 0; lane < MAXIMUM_BANDWIDTH_LANES; lane++) {
+#pragma HLS UNROLL
+            ap_int<32> x = word.range(lane * 32 + 31, lane * 32);
+            ap_int<32> sum = x + value;
+            result.range(lane * 32 + 31, lane * 32) = sum;
+        }
+        out.write(result);
+    }
+}
+
+// 書き込み: 読み出しと同じく1つのパイプラインループで書く (バーストはmax_write_burst_lengthごと)
+static void write_words(hls::stream<mb_word_t>& in, mb_word_t* out, int size) {
+    const int num_words = maximum_bandwidth_num_words(size);
+write_loop:
+    for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=1
+        out[i] = in.read();
+    }
+}
+
+// 計測版で最後のバンクの書き込みに使う。DATAFLOWの各段は重なって動くため、最初のワードが届くまで
+// (DDRの読み出しと加算のレイテンシ) をstart、最後のワードを書くまでをcomputeとして数える。
+static void write_words(hls::stream<mb_word_t>& in, mb_word_t* out, int size, KernelProfileEvents& events) {
+    const int num_words = maximum_bandwidth_num_words(size);
+write_loop_prof:
+    for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=1
+        mb_word_t word = in.read();
+        if (i == 0) {
+            kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+        }
+        out[i] = word;
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+}
+
+static void write_words(hls::stream<mb_word_t>& in, mb_word_t* out, int size, KernelProfileNone&) {
+    write_words(in, out, size);
+}
+
+// maximum_bandwidth (maximum_bandwidth.cpp) と計測版 maximum_bandwidth_prof (maximum_bandwidth_prof.cpp) が共有する本体。
+// 4つのバンクそれぞれで read -> add -> write の3段をストリームでつなぎ、12個のプロセスを同時に動かす。
+// 各バンクは512ビットの読み出しポートと書き込みポートを1つずつ持つ (バンクの割り当ては maximum_bandwidth.cfg)。
+// sizeはバッファあたりのint数。バッファは maximum_bandwidth_padded_size(size) 個分を確保しておく。
+template <typename Events>
+static void maximum_bandwidth_body(
+    const mb_word_t* input0, const mb_word_t* input1, const mb_word_t* input2, const mb_word_t* input3,
+    mb_word_t* output0, mb_word_t* output1, mb_word_t* output2, mb_word_t* output3,
+    const int size, Events& events) {
+    // 書き込み側のバーストが途切れないよう、FIFOはチャンク2つ分の深さを持たせる
+    hls::stream<mb_word_t> in_stream0("in_stream0"), in_stream1("in_stream1"), in_stream2("in_stream2"), in_stream3("in_stream3");
+    hls::stream<mb_word_t> out_stream0("out_stream0"), out_stream1("out_stream1"), out_stream2("out_stream2"), out_stream3("out_stream3");
+#pragma HLS STREAM variable=in_stream0 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=in_stream1 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=in_stream2 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=in_stream3 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=out_stream0 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=out_stream1 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=out_stream2 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+#pragma HLS STREAM variable=out_stream3 depth=2*MAXIMUM_BANDWIDTH_CHUNK
+
+#pragma HLS DATAFLOW
+
+    read_words(input0, in_stream0, size);
+    read_words(input1, in_stream1, size);
+    read_words(input2, in_stream2, size);
+    read_words(input3, in_stream3, size);
+
+    add_words(in_stream0, out_stream0, size, 1);
+    add_words(in_stream1, out_stream1, size, 2);
+    add_words(in_stream2, out_stream2, size, 3);
+    add_words(in_stream3, out_stream3, size, 4);
+
+    write_words(out_stream0, output0, size);
+    write_words(out_stream1, output1, size);
+    write_words(out_stream2, output2, size);
+    write_words(out_stream3, output3, size, events);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "ap_int.h"
+#include "maximum_bandwidth.h"
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装
+extern "C" void maximum_bandwidth(
+    const ap_uint<512>* input0, const ap_uint<512>* input1, const ap_uint<512>* input2, const ap_uint<512>* input3,
+    ap_uint<512>* output0, ap_uint<512>* output1, ap_uint<512>* output2, ap_uint<512>* output3,
+    const int size);
+extern "C" void maximum_bandwidth_prof(
+    const ap_uint<512>* input0, const ap_uint<512>* input1, const ap_uint<512>* input2, const ap_uint<512>* input3,
+    ap_uint<512>* output0, ap_uint<512>* output1, ap_uint<512>* output2, ap_uint<512>* output3,
+    const int size, unsigned long long* prof);
+
+// 入出力のBOはsizeより大きく確保されることがあるため、実際に読み書きする範囲だけをDDRの転送量とする
+static size_t maximum_bandwidth_traffic(const std::vector<xrt_fake::kernel_arg>& args) {
+    return 8 * maximum_bandwidth_padded_size(static_cast<int>(args.at(8).scalar)) * sizeof(int);
+}
+
+static bool register_maximum_bandwidth = [] {
+    xrt_fake::register_kernel("maximum_bandwidth", xrt_fake::bind_kernel(maximum_bandwidth), maximum_bandwidth_traffic);
+    xrt_fake::register_kernel("maximum_bandwidth_prof", xrt_fake::bind_kernel(maximum_bandwidth_prof), maximum_bandwidth_traffic);
+    return true;
+}();
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "maximum_bandwidth_body.h"
+
+// 計測版 (maximum_bandwidth_prof)。最後の引数profに4バンク目の書き込みから見たサイクル数を書く (../common/kernel_profile.h)。
+extern "C" void maximum_bandwidth_prof(
+    const mb_word_t* input0, const mb_word_t* input1, const mb_word_t* input2, const mb_word_t* input3,
+    mb_word_t* output0, mb_word_t* output1, mb_word_t* output2, mb_word_t* output3,
+    const int size, unsigned long long* prof) {
+
+#pragma HLS INTERFACE m_axi port=input0 offset=slave bundle=gmem0 max_read_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=input1 offset=slave bundle=gmem1 max_read_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=input2 offset=slave bundle=gmem2 max_read_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=input3 offset=slave bundle=gmem3 max_read_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=output0 offset=slave bundle=gmem4 max_write_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_write_outstanding=16
+#pragma HLS INTERFACE m_axi port=output1 offset=slave bundle=gmem5 max_write_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_write_outstanding=16
+#pragma HLS INTERFACE m_axi port=output2 offset=slave bundle=gmem6 max_write_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_write_outstanding=16
+#pragma HLS INTERFACE m_axi port=output3 offset=slave bundle=gmem7 max_write_burst_length=MAXIMUM_BANDWIDTH_CHUNK num_write_outstanding=16
+#pragma HLS INTERFACE m_axi port=prof offset=slave bundle=gmem8
+#pragma HLS INTERFACE s_axilite port=size
+#pragma HLS INTERFACE s_axilite port=return
+
+    KernelProfileEvents events;
+#pragma HLS STREAM variable=events depth=4
+#pragma HLS DATAFLOW
+    maximum_bandwidth_body(input0, input1, input2, input3, output0, output1, output2, output3, size, events);
+    kernel_profile_counter(events, prof);
+}
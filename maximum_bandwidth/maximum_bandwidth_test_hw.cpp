@@ -13,12 +13,23 @@
 #include <ctime>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 
 #include "experimental/xrt_bo.h"
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
 
+#include "bench_record.h"
+#include "kernel_profile.h"
+#include "parallel_data.h"
+#include "parallel_sync.h"
+#include "maximum_bandwidth.h"
+
 const char* KERNEL_NAME = "maximum_bandwidth";
+const int NUM_ITERATIONS = 10;
+const int NUM_BANKS = 4;
+const int BUFFER_MIB[] = {1, 4, 16, 64, 256};  // バッファ1つあたりのサイズの候補
+const int THREADS[] = {1, 2, 4, 8};             // sync を発行するスレッド数の候補
 
 inline double to_gb(double bytes) {
     return bytes / (1024.0 * 1024.0 * 1024.0);
@@ -28,168 +39,184 @@ inline double calculate_bandwidth(size_t bytes, double milliseconds) {
     return to_gb(bytes) / (milliseconds / 1000.0);
 }
 
+// 出力全体を、入力の乱数を計算し直した期待値 (入力 + バンク番号 + 1) と全コアで比べる
+static bool verify(const std::vector<int*>& outputs, int size, uint64_t seed) {
+    for (int bank = 0; bank < NUM_BANKS; ++bank) {
+        auto expected = [=](size_t i) { return counter_rng_int(seed, bank, i, 100) + bank + 1; };
+        size_t i = parallel_find_mismatch(outputs[bank], size, expected);
+        if (i != static_cast<size_t>(size)) {
+            std::cerr << "Mismatch at bank " << bank << " index " << i << " (size " << size << ")" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cout << "Usage: " << argv[0] << " <xclbin_file>" << std::endl;
+    // 最後に --profile を付けると計測版カーネル (maximum_bandwidth_prof.xclbin) でカーネル内のサイクル数も読む
+    const bool profile = argc >= 3 && std::string(argv[argc - 1]) == "--profile";
+    if (profile) {
+        --argc;
+    }
+    if (argc < 2 || argc > 4) {
+        std::cout << "Usage: " << argv[0] << " <xclbin_file> [max_threads=8] [max_mib=256] [--profile]" << std::endl;
         return EXIT_FAILURE;
     }
+    const std::string kernel_name = profile ? std::string(KERNEL_NAME) + "_prof" : KERNEL_NAME;
     std::string xclbin_file = argv[1];
+    const int max_threads = (argc > 2) ? std::atoi(argv[2]) : 8;
+    const int max_mib = (argc > 3) ? std::atoi(argv[3]) : 256;
 
-    const int DATA_SIZE = 64 * 1024 * 1024; // 各入力/出力で256MB (64M個の整数)
-    const size_t DATA_BYTES = DATA_SIZE * sizeof(int);
-    const size_t TOTAL_BYTES = DATA_BYTES * 8; // 4入力 + 4出力
-
-    std::cout << "Running DDR Bandwidth Test with data size per buffer: " 
-              << (DATA_BYTES / (1024 * 1024)) << " MB" << std::endl;
-    std::cout << "Total data transfer: " << (TOTAL_BYTES / (1024 * 1024)) << " MB" << std::endl;
-
-    srand(time(nullptr));
-
-    std::cout << "Preparing input data..." << std::endl;
-    std::vector<int> source_input0(DATA_SIZE);
-    std::vector<int> source_input1(DATA_SIZE);
-    std::vector<int> source_input2(DATA_SIZE);
-    std::vector<int> source_input3(DATA_SIZE);
-    std::vector<int> result_output0(DATA_SIZE);
-    std::vector<int> result_output1(DATA_SIZE);
-    std::vector<int> result_output2(DATA_SIZE);
-    std::vector<int> result_output3(DATA_SIZE);
-    
-    std::vector<int> expected_output0(DATA_SIZE);
-    std::vector<int> expected_output1(DATA_SIZE);
-    std::vector<int> expected_output2(DATA_SIZE);
-    std::vector<int> expected_output3(DATA_SIZE);
-
-    for (int i = 0; i < DATA_SIZE; ++i) {
-        source_input0[i] = rand() % 100;
-        source_input1[i] = rand() % 100;
-        source_input2[i] = rand() % 100;
-        source_input3[i] = rand() % 100;
-        
-        expected_output0[i] = source_input0[i] + 1;
-        expected_output1[i] = source_input1[i] + 2;
-        expected_output2[i] = source_input2[i] + 3;
-        expected_output3[i] = source_input3[i] + 4;
+    std::vector<int> sizes_mib;
+    for (int mib : BUFFER_MIB) {
+        if (mib <= max_mib) {
+            sizes_mib.push_back(mib);
+        }
+    }
+    std::vector<int> thread_counts;
+    for (int t : THREADS) {
+        if (t <= max_threads) {
+            thread_counts.push_back(t);
+        }
     }
+    if (sizes_mib.empty() || thread_counts.empty()) {
+        std::cerr << "max_threads must be >= 1 and max_mib must be >= 1" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // バッファは最大サイズで1回だけ確保し、各計測ではその先頭だけを使う
+    const int MAX_SIZE = sizes_mib.back() * 1024 * 1024 / sizeof(int);
+    const size_t BUFFER_BYTES = maximum_bandwidth_padded_size(MAX_SIZE) * sizeof(int);
+
+    std::cout << "Running DDR/PCIe Bandwidth Test: buffers up to " << sizes_mib.back() << " MB x "
+              << NUM_BANKS << " in / " << NUM_BANKS << " out, up to " << thread_counts.back() << " sync threads"
+              << std::endl;
+
+    const uint64_t seed = static_cast<uint64_t>(time(nullptr));
+
+    BenchRecorder recorder;
+    recorder.env().set("xclbin", xclbin_file);
+    bool match = true;
 
     try {
         auto device = xrt::device(0);
         auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME);
+        auto kernel = xrt::kernel(device, uuid, kernel_name);
 
         std::cout << "Allocating buffers..." << std::endl;
-        
-        auto bo_input0 = xrt::bo(device, DATA_BYTES, kernel.group_id(0));
-        auto bo_input1 = xrt::bo(device, DATA_BYTES, kernel.group_id(1));
-        auto bo_input2 = xrt::bo(device, DATA_BYTES, kernel.group_id(2));
-        auto bo_input3 = xrt::bo(device, DATA_BYTES, kernel.group_id(3));
-        
-        auto bo_output0 = xrt::bo(device, DATA_BYTES, kernel.group_id(4));
-        auto bo_output1 = xrt::bo(device, DATA_BYTES, kernel.group_id(5));
-        auto bo_output2 = xrt::bo(device, DATA_BYTES, kernel.group_id(6));
-        auto bo_output3 = xrt::bo(device, DATA_BYTES, kernel.group_id(7));
-
-        std::cout << "Writing data to device..." << std::endl;
-        
-        auto transfer_start_time = std::chrono::high_resolution_clock::now();
-        
-        bo_input0.write(source_input0.data());
-        bo_input1.write(source_input1.data());
-        bo_input2.write(source_input2.data());
-        bo_input3.write(source_input3.data());
-
-        bo_input0.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_input1.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_input2.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_input3.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        
-        auto transfer_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> transfer_to_device_ms = transfer_end_time - transfer_start_time;
-        
-        std::cout << "Executing kernel..." << std::endl;
-        
-        auto kernel_start_time = std::chrono::high_resolution_clock::now();
-        
-        auto run = kernel(bo_input0, bo_input1, bo_input2, bo_input3,
-                         bo_output0, bo_output1, bo_output2, bo_output3,
-                         DATA_SIZE);
-        run.wait();
-        
-        auto kernel_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> kernel_duration_ms = kernel_end_time - kernel_start_time;
-        
-        std::cout << "Reading data from device..." << std::endl;
-        
-        auto read_start_time = std::chrono::high_resolution_clock::now();
-        
-        bo_output0.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_output1.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_output2.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_output3.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        
-        bo_output0.read(result_output0.data());
-        bo_output1.read(result_output1.data());
-        bo_output2.read(result_output2.data());
-        bo_output3.read(result_output3.data());
-        
-        auto read_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> transfer_from_device_ms = read_end_time - read_start_time;
-        
-        std::chrono::duration<double, std::milli> total_duration_ms = read_end_time - transfer_start_time;
-        
-        double write_bandwidth_gb_per_sec = calculate_bandwidth(DATA_BYTES * 4, transfer_to_device_ms.count());
-        double kernel_bandwidth_gb_per_sec = calculate_bandwidth(DATA_BYTES * 8, kernel_duration_ms.count());
-        double read_bandwidth_gb_per_sec = calculate_bandwidth(DATA_BYTES * 4, transfer_from_device_ms.count());
-        double total_bandwidth_gb_per_sec = calculate_bandwidth(DATA_BYTES * 8, total_duration_ms.count());
-        
-        std::cout << "\n--- Performance Results ---" << std::endl;
-        std::cout << "Host to Device Transfer: " << transfer_to_device_ms.count() << " ms" << std::endl;
-        std::cout << "Kernel Execution: " << kernel_duration_ms.count() << " ms" << std::endl;
-        std::cout << "Device to Host Transfer: " << transfer_from_device_ms.count() << " ms" << std::endl;
-        std::cout << "Total Time: " << total_duration_ms.count() << " ms" << std::endl;
-        
+        std::vector<xrt::bo> bo_inputs, bo_outputs;
+        std::vector<int*> inputs, outputs;  // ホスト側はBOのmapだけで、別の配列は持たない
+        for (int bank = 0; bank < NUM_BANKS; ++bank) {
+            bo_inputs.push_back(xrt::bo(device, BUFFER_BYTES, kernel.group_id(bank)));
+            bo_outputs.push_back(xrt::bo(device, BUFFER_BYTES, kernel.group_id(NUM_BANKS + bank)));
+            inputs.push_back(bo_inputs.back().map<int*>());
+            outputs.push_back(bo_outputs.back().map<int*>());
+        }
+        xrt::bo bo_prof;
+        unsigned long long prof_words[KERNEL_PROFILE_WORDS] = {};
+        if (profile) {
+            bo_prof = xrt::bo(device, sizeof(prof_words), kernel.group_id(2 * NUM_BANKS + 1));
+        }
+
+        // 転送だけを計測するため、入力はmapしたホスト側メモリへ全コアで直接生成しておく
+        std::cout << "Preparing input data (" << parallel_data_threads() << " threads)..." << std::endl;
+        auto prepare_start_time = std::chrono::high_resolution_clock::now();
+        for (int bank = 0; bank < NUM_BANKS; ++bank) {
+            parallel_fill(inputs[bank], MAX_SIZE, seed, bank, 100);
+        }
+        auto prepare_end_time = std::chrono::high_resolution_clock::now();
+        std::cout << "Prepared in " << std::chrono::duration<double, std::milli>(prepare_end_time - prepare_start_time).count()
+                  << " ms" << std::endl;
+
+        // スレッドは計測の外で起動しておく
+        std::vector<std::unique_ptr<SyncPool>> pools;
+        for (int t : thread_counts) {
+            pools.emplace_back(new SyncPool(t));
+        }
+
         std::cout << std::fixed << std::setprecision(2);
-        std::cout << "\n--- Bandwidth Measurements ---" << std::endl;
-        std::cout << "Host to Device Bandwidth: " << write_bandwidth_gb_per_sec << " GB/s" << std::endl;
-        std::cout << "Kernel Bandwidth: " << kernel_bandwidth_gb_per_sec << " GB/s" << std::endl;
-        std::cout << "Device to Host Bandwidth: " << read_bandwidth_gb_per_sec << " GB/s" << std::endl;
-        std::cout << "Total Effective Bandwidth: " << total_bandwidth_gb_per_sec << " GB/s" << std::endl;
-        
+        std::cout << "\n--- Performance Results (median of " << NUM_ITERATIONS << " runs) ---" << std::endl;
+        std::cout << std::setw(8) << "MB/buf" << std::setw(9) << "threads" << std::setw(11) << "H2D ms"
+                  << std::setw(11) << "H2D GB/s" << std::setw(11) << "D2H ms" << std::setw(11) << "D2H GB/s"
+                  << std::setw(11) << "kernel ms" << std::setw(13) << "kernel GB/s" << std::endl;
+
+        for (int mib : sizes_mib) {
+            const int size = mib * 1024 * 1024 / sizeof(int);
+            const size_t bytes = maximum_bandwidth_padded_size(size) * sizeof(int);  // バッファ1つあたり
+
+            // カーネル: 入力を転送してから単独で計測する (スレッド数には依存しない)
+            pools.back()->sync_all(bo_inputs, bytes, XCL_BO_SYNC_BO_TO_DEVICE);
+            auto run = profile ? kernel(bo_inputs[0], bo_inputs[1], bo_inputs[2], bo_inputs[3],
+                                        bo_outputs[0], bo_outputs[1], bo_outputs[2], bo_outputs[3], size, bo_prof)
+                               : kernel(bo_inputs[0], bo_inputs[1], bo_inputs[2], bo_inputs[3],
+                                        bo_outputs[0], bo_outputs[1], bo_outputs[2], bo_outputs[3],
+                                        size);  // ウォームアップ
+            run.wait();
+            KernelProfileLog profile_log;
+            BenchRecord& kernel_record = recorder.add(kernel_name, "maximum_bandwidth_test_hw")
+                                             .param("phase", "kernel")
+                                             .param("buffer_mib", mib)
+                                             .param("bytes", bytes * 2 * NUM_BANKS);
+            for (int i = 0; i < NUM_ITERATIONS; ++i) {
+                auto kernel_start_time = std::chrono::high_resolution_clock::now();
+                run.start();
+                run.wait();
+                auto kernel_end_time = std::chrono::high_resolution_clock::now();
+                kernel_record.add_sample(std::chrono::duration<double, std::milli>(kernel_end_time - kernel_start_time).count());
+                if (profile) {
+                    bo_prof.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+                    bo_prof.read(prof_words);
+                    profile_log.add(prof_words, std::chrono::duration<double, std::micro>(kernel_end_time - kernel_start_time).count());
+                }
+            }
+            double kernel_ms = bench_summarize(kernel_record.samples()).median;
+
+            for (size_t p = 0; p < pools.size(); ++p) {
+                SyncPool& pool = *pools[p];
+                BenchRecord& h2d_record = recorder.add(kernel_name, "maximum_bandwidth_test_hw")
+                                              .param("phase", "host_to_device")
+                                              .param("buffer_mib", mib)
+                                              .param("threads", pool.threads())
+                                              .param("bytes", bytes * NUM_BANKS);
+                BenchRecord& d2h_record = recorder.add(kernel_name, "maximum_bandwidth_test_hw")
+                                              .param("phase", "device_to_host")
+                                              .param("buffer_mib", mib)
+                                              .param("threads", pool.threads())
+                                              .param("bytes", bytes * NUM_BANKS);
+                for (int i = 0; i < NUM_ITERATIONS; ++i) {
+                    h2d_record.add_sample(pool.sync_all(bo_inputs, bytes, XCL_BO_SYNC_BO_TO_DEVICE));
+                }
+                for (int i = 0; i < NUM_ITERATIONS; ++i) {
+                    d2h_record.add_sample(pool.sync_all(bo_outputs, bytes, XCL_BO_SYNC_BO_FROM_DEVICE));
+                }
+                double h2d_ms = bench_summarize(h2d_record.samples()).median;
+                double d2h_ms = bench_summarize(d2h_record.samples()).median;
+
+                std::cout << std::setw(8) << mib << std::setw(9) << pool.threads()
+                          << std::setw(11) << h2d_ms << std::setw(11) << calculate_bandwidth(bytes * NUM_BANKS, h2d_ms)
+                          << std::setw(11) << d2h_ms << std::setw(11) << calculate_bandwidth(bytes * NUM_BANKS, d2h_ms);
+                if (p == 0) {
+                    std::cout << std::setw(11) << kernel_ms
+                              << std::setw(13) << calculate_bandwidth(bytes * 2 * NUM_BANKS, kernel_ms);
+                }
+                std::cout << std::endl;
+            }
+            if (profile) {
+                std::cout << std::setw(8) << mib << "  ";
+                profile_log.print(std::cout);
+            }
+
+            match &= verify(outputs, size, seed);
+        }
     } catch (const std::exception& ex) {
         std::cerr << "Exception caught: " << ex.what() << std::endl;
         return EXIT_FAILURE;
     }
 
-    bool match = true;
-    const int verify_count = std::min(1000, DATA_SIZE);
-    
-    std::cout << "\nVerifying results (first and last " << verify_count << " elements)..." << std::endl;
-    
-    for (int i = 0; i < verify_count; ++i) {
-        if (result_output0[i] != expected_output0[i] ||
-            result_output1[i] != expected_output1[i] ||
-            result_output2[i] != expected_output2[i] ||
-            result_output3[i] != expected_output3[i]) {
-            std::cerr << "Mismatch at start index " << i << std::endl;
-            match = false;
-            break;
-        }
-    }
-    
     if (match) {
-        for (int i = DATA_SIZE - verify_count; i < DATA_SIZE; ++i) {
-            if (result_output0[i] != expected_output0[i] ||
-                result_output1[i] != expected_output1[i] ||
-                result_output2[i] != expected_output2[i] ||
-                result_output3[i] != expected_output3[i]) {
-                std::cerr << "Mismatch at end index " << i << std::endl;
-                match = false;
-                break;
-            }
+        if (!recorder.write()) {
+            std::cerr << "Failed to write benchmark records to " << recorder.path() << std::endl;
         }
-    }
-
-    if (match) {
         std::cout << "Test PASSED! Results match expected values." << std::endl;
         return EXIT_SUCCESS;
     } else {
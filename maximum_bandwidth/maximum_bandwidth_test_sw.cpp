@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ap_int.h"
+#include "kernel_profile.h"
+#include "maximum_bandwidth.h"
+
+extern "C" void maximum_bandwidth(
+    const ap_uint<512>* input0, const ap_uint<512>* input1, const ap_uint<512>* input2, const ap_uint<512>* input3,
+    ap_uint<512>* output0, ap_uint<512>* output1, ap_uint<512>* output2, ap_uint<512>* output3,
+    const int size);
+extern "C" void maximum_bandwidth_prof(
+    const ap_uint<512>* input0, const ap_uint<512>* input1, const ap_uint<512>* input2, const ap_uint<512>* input3,
+    ap_uint<512>* output0, ap_uint<512>* output1, ap_uint<512>* output2, ap_uint<512>* output3,
+    const int size, unsigned long long* prof);
+
+// 4つの出力がそれぞれ入力 + 1..4 になることを、size個までのintについて確認する。
+// 入力の末尾 (size以降) にはごみを入れ、出力の末尾は確認しない。
+// prof = trueのときは計測版で計算し、プロファイルの書き出しも確認する。
+bool test_size(int size, bool prof = false) {
+    const size_t words = maximum_bandwidth_num_words(size);
+    std::vector<std::vector<ap_uint<512>>> in(4, std::vector<ap_uint<512>>(words));
+    std::vector<std::vector<ap_uint<512>>> out(4, std::vector<ap_uint<512>>(words));
+    std::vector<std::vector<int>> source(4, std::vector<int>(size));
+
+    for (int p = 0; p < 4; p++) {
+        int* data = reinterpret_cast<int*>(in[p].data());
+        for (size_t i = 0; i < maximum_bandwidth_padded_size(size); i++) {
+            data[i] = rand() - RAND_MAX / 2;
+        }
+        for (int i = 0; i < size; i++) {
+            source[p][i] = data[i];
+        }
+    }
+
+    if (prof) {
+        unsigned long long words[KERNEL_PROFILE_WORDS] = {};
+        maximum_bandwidth_prof(in[0].data(), in[1].data(), in[2].data(), in[3].data(),
+                               out[0].data(), out[1].data(), out[2].data(), out[3].data(), size, words);
+        if (!kernel_profile_consistent(words) || words[KERNEL_PROFILE_TOTAL] == 0) {
+            std::cerr << "Unexpected profile (size " << size << "): total " << words[KERNEL_PROFILE_TOTAL] << " cycles" << std::endl;
+            return false;
+        }
+    } else {
+        maximum_bandwidth(in[0].data(), in[1].data(), in[2].data(), in[3].data(),
+                          out[0].data(), out[1].data(), out[2].data(), out[3].data(), size);
+    }
+
+    for (int p = 0; p < 4; p++) {
+        const int* result = reinterpret_cast<const int*>(out[p].data());
+        for (int i = 0; i < size; i++) {
+            int expected = static_cast<int>(static_cast<unsigned int>(source[p][i]) + (p + 1));
+            if (result[i] != expected) {
+                std::cerr << "Mismatch (size " << size << ", port " << p << ") at index " << i
+                          << ": HW=" << result[i] << ", SW=" << expected << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    const int CHUNK_INTS = MAXIMUM_BANDWIDTH_CHUNK * MAXIMUM_BANDWIDTH_LANES;
+    std::cout << "Running maximum_bandwidth software test (chunk " << MAXIMUM_BANDWIDTH_CHUNK << " words)" << std::endl;
+
+    // ワード幅 (16) とチャンク (CHUNK_INTS) の倍数の前後、複数チャンクの端数を含める
+    std::vector<int> sizes = {1, 15, 16, 17, 31, 33,
+                              CHUNK_INTS - 1, CHUNK_INTS, CHUNK_INTS + 1, CHUNK_INTS + 16,
+                              3 * CHUNK_INTS + 5, 3 * CHUNK_INTS - 17, 100003};
+    bool ok = true;
+    for (int size : sizes) {
+        ok &= test_size(size);
+    }
+    ok &= test_size(1, true);
+    ok &= test_size(3 * CHUNK_INTS + 5, true);
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_record.h"
+#include "mm_tiling.h"
+
+extern "C" void mm(const int* a, const int* b, int* c, int size, int batch, int a_step);
+
+// バッチ実行と1行列ずつの呼び出しで、16x16行列1個あたりの時間を比較する。
+// SEGMENTS回に分けて計測し、各回でおよそMIN_MATRICES / SEGMENTS個以上の行列を計算する。
+// 各回の行列1個あたりの時間を反復時間として記録し (BENCH_RECORDS)、表には中央値を表示する。
+int main() {
+    const int TILE_SIZE = MM_TILE * MM_TILE;
+    const int MAX_BATCH = 65536;
+    const long MIN_MATRICES = 65536;
+    const int SEGMENTS = 8;
+
+    std::vector<int> a(static_cast<size_t>(MAX_BATCH) * TILE_SIZE);
+    std::vector<int> b(static_cast<size_t>(MAX_BATCH) * TILE_SIZE);
+    std::vector<int> c(static_cast<size_t>(MAX_BATCH) * TILE_SIZE);
+    for (auto& v : a) v = rand() % 21 - 10;
+    for (auto& v : b) v = rand() % 21 - 10;
+
+    BenchRecorder recorder;
+    printf("%8s %16s %16s\n", "batch", "batched us/mat", "single us/mat");
+    for (int batch = 1; batch <= MAX_BATCH; batch *= 4) {
+        int repeats = static_cast<int>((MIN_MATRICES / SEGMENTS + batch - 1) / batch);
+        double matrices = static_cast<double>(repeats) * batch;
+        BenchRecord& batched = recorder.add("mm", "mm_bench_sw").param("mode", "batched").param("batch", batch);
+        BenchRecord& single = recorder.add("mm", "mm_bench_sw").param("mode", "single").param("batch", batch);
+
+        for (int s = 0; s < SEGMENTS; s++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                mm(a.data(), b.data(), c.data(), MM_TILE, batch, TILE_SIZE);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            batched.add_sample(std::chrono::duration<double, std::milli>(end - start).count() / matrices);
+
+            start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                for (int i = 0; i < batch; i++) {
+                    mm(a.data() + static_cast<size_t>(i) * TILE_SIZE, b.data() + static_cast<size_t>(i) * TILE_SIZE,
+                       c.data() + static_cast<size_t>(i) * TILE_SIZE, MM_TILE, 1, TILE_SIZE);
+                }
+            }
+            end = std::chrono::high_resolution_clock::now();
+            single.add_sample(std::chrono::duration<double, std::milli>(end - start).count() / matrices);
+        }
+
+        printf("%8d %16.3f %16.3f\n", batch, bench_summarize(batched.samples()).median * 1000.0,
+               bench_summarize(single.samples()).median * 1000.0);
+    }
+    if (!recorder.write()) {
+        fprintf(stderr, "Failed to write benchmark records to %s\n", recorder.path().c_str());
+        return 1;
+    }
+    return 0;
+}
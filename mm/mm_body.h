@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "kernel_profile_counter.h"
+
+// a: 16 x size (行優先), b: size x 16 (行優先), c: 16 x 16
+// sizeはK方向の長さ (16の倍数)。16ずつ読み込んでc_localに累積するため、部分積をホストへ戻す必要がない。
+// size = 16 のときは従来どおり16x16の行列積になる。
+// batch個の積を1回の起動で続けて計算する。n番目の積は a + n * a_step、b + n * size * 16、c + n * 256 を使う。
+// a_step = 0 ならすべての積で同じaを使う (タイル分割で1つの行パネルに複数の列パネルを掛ける場合)。
+// mm (mm.cpp) と計測版 mm_prof (mm_prof.cpp) が共有する本体。計測版では、16x16のブロックの読み込みをstart、積和をcompute、cの書き込みをendとして数える。
+template <typename Events>
+static void mm_body(const int* a, const int* b, int* c, int size, int batch, int a_step, Events& events) {
+    int matrix_size = 16;
+    
+    int a_local[16][16];
+    int b_local[16][16];
+    int c_local[16][16];
+    
+#pragma HLS ARRAY_PARTITION variable=a_local complete dim=0
+#pragma HLS ARRAY_PARTITION variable=b_local complete dim=0
+#pragma HLS ARRAY_PARTITION variable=c_local complete dim=0
+
+    for (int n = 0; n < batch; n++) {
+        const int* a_n = a + (long)n * a_step;
+        const int* b_n = b + (long)n * size * matrix_size;
+        int* c_n = c + (long)n * matrix_size * matrix_size;
+
+        for (int i = 0; i < matrix_size; i++) {
+#pragma HLS UNROLL
+            for (int j = 0; j < matrix_size; j++) {
+#pragma HLS UNROLL
+                c_local[i][j] = 0;
+            }
+        }
+
+        for (int kb = 0; kb < size; kb += matrix_size) {
+            kernel_profile_mark(events, KERNEL_PROFILE_START);
+            for (int i = 0; i < matrix_size; i++) {
+#pragma HLS UNROLL
+                for (int j = 0; j < matrix_size; j++) {
+#pragma HLS UNROLL
+                    a_local[i][j] = a_n[i * size + kb + j];
+                    b_local[i][j] = b_n[(kb + i) * matrix_size + j];
+                }
+            }
+
+            kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+            for (int i = 0; i < matrix_size; i++) {
+#pragma HLS UNROLL
+                for (int j = 0; j < matrix_size; j++) {
+#pragma HLS UNROLL
+                    for (int k = 0; k < matrix_size; k++) {
+#pragma HLS UNROLL
+                        c_local[i][j] += a_local[i][k] * b_local[k][j];
+                    }
+                }
+            }
+        }
+    
+        kernel_profile_mark(events, KERNEL_PROFILE_END);
+        for (int i = 0; i < matrix_size; i++) {
+#pragma HLS UNROLL
+            for (int j = 0; j < matrix_size; j++) {
+#pragma HLS UNROLL
+                c_n[i * matrix_size + j] = c_local[i][j];
+            }
+        }
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装
+extern "C" void mm(const int* a, const int* b, int* c, int size, int batch, int a_step);
+extern "C" void mm_prof(const int* a, const int* b, int* c, int size, int batch, int a_step, unsigned long long* prof);
+
+static xrt_fake::kernel_registrar register_mm("mm", mm);
+static xrt_fake::kernel_registrar register_mm_prof("mm_prof", mm_prof);
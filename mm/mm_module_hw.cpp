@@ -12,17 +12,35 @@
 #include "experimental/xrt_bo.h"
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
+#include <algorithm>
 #include <chrono>
+#include <optional>
+
+#include "bo_array.h"
+#include "bo_pool.h"
+#include "cpu_backend.h"
+#include "cu_lane.h"
+#include "device_array_bo.h"
+#include "device_array_py.h"
+#include "device_group.h"
+#include "mm_tiling.h"
+#include "phase_timer_py.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
 
 namespace py = pybind11;
 
+// サブバッファの先頭を4KiBに揃える (int要素数)
+const size_t MM_SUBBUFFER_ALIGN = 1024;
+
 class MMRunner {
 public:
-    MMRunner(const std::string& xclbin_path, const std::string& kernel_name) {
-        device_ = xrt::device(0); 
-        auto uuid = device_.load_xclbin(xclbin_path);
-        krnl_ = xrt::kernel(device_, uuid, kernel_name);
-    }
+    // num_cus > 1のときはrun_batch()のbatchをCU (mm_1, mm_2, ...) の数に分け、CUごとのBOで同時に実行する。
+    // それ以外の経路は先頭のCUで実行する。device_indexは開くカードの番号。
+    MMRunner(const std::string& xclbin_path, const std::string& kernel_name, size_t num_cus, unsigned int device_index = 0)
+        : context_(XrtContext::get(xclbin_path, device_index)), device_(context_->device()),
+          lanes_(open_cu_lanes(*context_, kernel_name, num_cus)), scheduler_(lanes_.size(), CuPolicy::least_loaded),
+          krnl_(lanes_[0]->krnl), launch_(lanes_[0]->launch) {}
 
     std::vector<int> run(const std::vector<int>& vec_a, const std::vector<int>& vec_b, int matrix_size) {
         int total_size = matrix_size * matrix_size;
@@ -30,27 +48,49 @@ public:
             throw std::runtime_error("Input vector sizes do not match the specified matrix size.");
         }
 
+        PhaseTimer& timer = *phases_;
         auto start_total = std::chrono::high_resolution_clock::now();
+        const size_t bytes = total_size * sizeof(int);
 
-        auto bo_a = xrt::bo(device_, total_size * sizeof(int), krnl_.group_id(0));
-        auto bo_b = xrt::bo(device_, total_size * sizeof(int), krnl_.group_id(1));
-        auto bo_c = xrt::bo(device_, total_size * sizeof(int), krnl_.group_id(2));
+        // BOは先頭のCUのプールから取る。同じ大きさの呼び出しが続けば前回と同じBOが返るため、
+        // launch_ (ReusableRun) はBO引数のset_argを省ける。BOはバケットサイズなので転送はbytes分だけ行う。
+        CuLane& lane = *lanes_[0];
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        auto buf_a = lane.pool.acquire(bytes, krnl_.group_id(0));
+        auto buf_b = lane.pool.acquire(bytes, krnl_.group_id(1));
+        auto buf_c = lane.pool.acquire(bytes, krnl_.group_id(2));
+        alloc.stop();
+        xrt::bo& bo_a = buf_a.bo();
+        xrt::bo& bo_b = buf_b.bo();
+        xrt::bo& bo_c = buf_c.bo();
 
-        bo_a.write(vec_a.data());
-        bo_b.write(vec_b.data());
-        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        PhaseTimer::Scope write(timer, Phase::write);
+        bo_a.write(vec_a.data(), bytes, 0);
+        bo_b.write(vec_b.data(), bytes, 0);
+        write.stop();
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        h2d.stop();
 
         auto start_kernel = std::chrono::high_resolution_clock::now();
-        auto kernel_run = krnl_(bo_a, bo_b, bo_c, matrix_size);
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& kernel_run = launch_(bo_a, bo_b, bo_c, matrix_size, 1, total_size);
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
         kernel_run.wait();
+        wait.stop();
         auto end_kernel = std::chrono::high_resolution_clock::now();
 
         kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
 
-        bo_c.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        bo_c.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        d2h.stop();
+        PhaseTimer::Scope read(timer, Phase::read);
         std::vector<int> vec_result(total_size);
-        bo_c.read(vec_result.data());
+        bo_c.read(vec_result.data(), bytes, 0);
+        read.stop();
 
         auto end_total = std::chrono::high_resolution_clock::now();
         total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
@@ -58,6 +98,202 @@ public:
         return vec_result;
     }
 
+    // batch個の独立した16x16行列積。CUごとに連続した範囲を受け持ち、入力はCUごとに1回のDMAで転送して
+    // カーネルも1回だけ起動する。全CUを起動してからまとめて完了を待つ。
+    // 各フェーズはCUの全範囲をまとめて1回として記録する。
+    void run_batch(const int* a, const int* b, int* c, int batch) {
+        PhaseTimer& timer = *phases_;
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        const size_t tile = MM_TILE * MM_TILE;
+        const int parts = std::max(1, std::min(batch, static_cast<int>(lanes_.size())));
+        const int chunk = (batch + parts - 1) / parts;
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        std::vector<BatchPart> work;
+        for (int first = 0; first < batch; first += chunk) {
+            CuScheduler::Lease lease = scheduler_.acquire();
+            CuLane& lane = *lanes_[lease.cu()];
+            int count = std::min(chunk, batch - first);
+            size_t bytes = count * tile * sizeof(int);
+            work.push_back({std::move(lease), lane.pool.acquire(bytes, lane.krnl.group_id(0)),
+                            lane.pool.acquire(bytes, lane.krnl.group_id(1)), lane.pool.acquire(bytes, lane.krnl.group_id(2)),
+                            first, count});
+        }
+        alloc.stop();
+
+        PhaseTimer::Scope write(timer, Phase::write);
+        for (BatchPart& part : work) {
+            size_t bytes = part.count * tile * sizeof(int);
+            part.a.bo().write(a + part.first * tile, bytes, 0);
+            part.b.bo().write(b + part.first * tile, bytes, 0);
+        }
+        write.stop();
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        for (BatchPart& part : work) {
+            size_t bytes = part.count * tile * sizeof(int);
+            part.a.bo().sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            part.b.bo().sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        }
+        h2d.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        std::vector<xrt::run*> runs;
+        for (BatchPart& part : work) {
+            CuLane& lane = *lanes_[part.lease.cu()];
+            runs.push_back(&lane.launch(part.a.bo(), part.b.bo(), part.c.bo(), MM_TILE, part.count, MM_TILE * MM_TILE));
+        }
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        for (xrt::run* run : runs) {
+            run->wait();
+        }
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        for (BatchPart& part : work) {
+            part.c.bo().sync(XCL_BO_SYNC_BO_FROM_DEVICE, part.count * tile * sizeof(int), 0);
+        }
+        d2h.stop();
+        PhaseTimer::Scope read(timer, Phase::read);
+        for (BatchPart& part : work) {
+            part.c.bo().read(c + part.first * tile, part.count * tile * sizeof(int), 0);
+        }
+        read.stop();
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    // 任意サイズの行列積 C(MxN) = A(MxK) * B(KxN)。
+    // Aパネル・Bパネル・CタイルをそれぞれのBOにまとめて1回ずつ転送し、行タイルごとにAパネルを共有した
+    // バッチ起動 (a_step = 0) で全列タイルを計算する。全行タイルを起動してからまとめて完了を待つ。
+    // タイルへの詰め替えはwrite、Cタイルからの書き戻しはreadとして記録する。
+    void matmul(const int* a, const int* b, int* c, int m, int k, int n) {
+        PhaseTimer& timer = *phases_;
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        MMTilePlan plan(m, k, n, MM_SUBBUFFER_ALIGN);
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        MappedBo<int> a_buf(device_, plan.a_panels_size(), krnl_.group_id(0));
+        MappedBo<int> b_buf(device_, plan.b_panels_size(), krnl_.group_id(1));
+        MappedBo<int> c_buf(device_, plan.c_tiles_size(), krnl_.group_id(2));
+        alloc.stop();
+
+        PhaseTimer::Scope write(timer, Phase::write);
+        std::optional<PhaseTimer::Scope> read;
+        mm_tiled(plan, a, b, c, a_buf.data(), b_buf.data(), c_buf.data(), [&] {
+            write.stop();
+            PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+            a_buf.to_device();
+            b_buf.to_device();
+            h2d.stop();
+
+            auto start_kernel = std::chrono::high_resolution_clock::now();
+            PhaseTimer::Scope launch(timer, Phase::launch);
+            std::vector<xrt::run> runs;
+            for (int rt = 0; rt < plan.row_tiles; rt++) {
+                xrt::bo a_panel(a_buf.bo(), MM_TILE * plan.depth * sizeof(int), rt * plan.a_stride * sizeof(int));
+                xrt::bo c_row(c_buf.bo(), plan.col_tiles * plan.c_stride * sizeof(int), plan.c_offset(rt, 0) * sizeof(int));
+                runs.push_back(krnl_(a_panel, b_buf.bo(), c_row, plan.depth, plan.col_tiles, 0));
+            }
+            launch.stop();
+            PhaseTimer::Scope wait(timer, Phase::wait);
+            for (auto& run : runs) {
+                run.wait();
+            }
+            wait.stop();
+            auto end_kernel = std::chrono::high_resolution_clock::now();
+            kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+            PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+            c_buf.from_device();
+            d2h.stop();
+            read.emplace(timer, Phase::read);
+        });
+        read.reset();
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    // カード上の16x16行列 (またはbatch個の行列) の積。転送は行わず、Cもカード上に置いたまま返す。
+    // batch個は先頭のCUで1回だけ起動する。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        xrt::bo& bo_a = device_bo(a, device_index());
+        xrt::bo& bo_b = device_bo(b, device_index());
+        int batch = a.ndim() == 3 ? static_cast<int>(a.shape()[0]) : 1;
+        PhaseTimer::Scope alloc(*phases_, Phase::alloc);
+        DeviceArray c = device_array(device_, device_index(), krnl_.group_id(2), a.shape(), DType::int32);
+        alloc.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(*phases_, Phase::launch);
+        auto& kernel_run = launch_(bo_a, bo_b, device_bo(c, device_index()), MM_TILE, batch, MM_TILE * MM_TILE);
+        launch.stop();
+        PhaseTimer::Scope wait(*phases_, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+        total_execution_time_ms_ = kernel_execution_time_ms_;
+        return c;
+    }
+
+    DeviceArray to_device(const int* src, const std::vector<size_t>& shape) {
+        return device_array(device_, device_index(), krnl_.group_id(0), shape, DType::int32, src);
+    }
+
+    unsigned int device_index() const { return context_->device_index(); }
+
+    void allocate_mapped(int matrix_size) {
+        int total_size = matrix_size * matrix_size;
+        mapped_a_ = std::make_shared<MappedBo<int>>(device_, total_size, krnl_.group_id(0));
+        mapped_b_ = std::make_shared<MappedBo<int>>(device_, total_size, krnl_.group_id(1));
+        mapped_c_ = std::make_shared<MappedBo<int>>(device_, total_size, krnl_.group_id(2));
+        mapped_matrix_size_ = matrix_size;
+    }
+
+    void run_mapped() {
+        if (!mapped_a_) {
+            throw std::runtime_error("Mapped buffers are not allocated.");
+        }
+
+        PhaseTimer& timer = *phases_;
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        mapped_a_->to_device();
+        mapped_b_->to_device();
+        h2d.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& kernel_run = launch_(mapped_a_->bo(), mapped_b_->bo(), mapped_c_->bo(), mapped_matrix_size_, 1,
+                                mapped_matrix_size_ * mapped_matrix_size_);
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        mapped_c_->from_device();
+        d2h.stop();
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    const std::shared_ptr<MappedBo<int>>& mapped_a() const { return mapped_a_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_b() const { return mapped_b_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_c() const { return mapped_c_; }
+
     double get_kernel_execution_time_ms() const {
         return kernel_execution_time_ms_;
     }
@@ -66,17 +302,62 @@ public:
         return total_execution_time_ms_;
     }
 
+    const std::vector<uint64_t>& cu_dispatched() const {
+        return scheduler_.dispatched();
+    }
+
+    // 同期実行で使い回すrun (起動回数とset_argの回数を数えている)
+    const ReusableRun& launcher() const {
+        return launch_;
+    }
+
+    // フェーズごとの時間の記録先 (複数枚のカードのランナーで共有する)
+    void share_phase_timer(std::shared_ptr<PhaseTimer> timer) {
+        phases_ = std::move(timer);
+    }
+
 private:
+    // run_batch()で1つのCUが受け持つ範囲 [first, first + count) とそのBO
+    struct BatchPart {
+        CuScheduler::Lease lease;
+        BOPool::Buffer a, b, c;
+        int first;
+        int count;
+    };
+
+    std::shared_ptr<XrtContext> context_;
     xrt::device device_;
-    xrt::kernel krnl_;
+    std::vector<std::unique_ptr<CuLane>> lanes_; // CUごとのカーネル・run・プール
+    CuScheduler scheduler_;
+    xrt::kernel krnl_; // run_batch()以外で使う先頭のCU
+    ReusableRun& launch_; // 同期実行の経路で使い回すrun
+    std::shared_ptr<MappedBo<int>> mapped_a_;
+    std::shared_ptr<MappedBo<int>> mapped_b_;
+    std::shared_ptr<MappedBo<int>> mapped_c_;
+    int mapped_matrix_size_ = 0;
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();
     double kernel_execution_time_ms_ = 0.0;
     double total_execution_time_ms_ = 0.0;
 };
 
+// backendは "auto" (既定、FPGAを開けなければCPU)、"fpga"、"cpu"。CPUバックエンドでもPythonからの使い方は同じ。
+// num_devices > 1のとき、matmul()はAとCを行タイル単位で、run_batch()はbatchをカードの数に分ける。
+// 各カードはBの全体を受け取り、Cの自分の行 (または行列) を結果の配列へ直接書く。
 class PyMMRunner {
 public:
-    PyMMRunner(const std::string& xclbin_path) 
-        : runner_(xclbin_path, "mm") {}
+    PyMMRunner(const std::string& xclbin_path, const std::string& backend, size_t num_cus, size_t num_devices)
+        : backend_(select_backend(backend, [&] {
+              devices_.reset(new DeviceGroup<MMRunner>(num_devices, [&](unsigned int device_index) {
+                  std::unique_ptr<MMRunner> runner(new MMRunner(xclbin_path, "mm", num_cus, device_index));
+                  runner->share_phase_timer(phases_);
+                  return runner;
+              }));
+              runner_ = &devices_->primary();
+          })) {}
+
+    std::string backend() const {
+        return backend_name(backend_);
+    }
 
     py::array_t<int> run(py::array_t<int, py::array::c_style | py::array::forcecast> a,
                          py::array_t<int, py::array::c_style | py::array::forcecast> b) {
@@ -93,7 +374,16 @@ public:
         
         int matrix_size = 16;
         int total_size = matrix_size * matrix_size;
+
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            py::array_t<int> result_array({matrix_size, matrix_size});
+            timed_cpu([&] { cpu_gemm(a.data(), b.data(), result_array.mutable_data(), matrix_size, matrix_size, matrix_size); });
+            return result_array;
+        }
         
+        // BOへの書き込み (write) はランナーが記録するので、ここでのコピーはfrom_numpyとして分ける
+        PhaseTimer::Scope from_numpy(*phases_, Phase::from_numpy);
         std::vector<int> vec_a(total_size);
         std::vector<int> vec_b(total_size);
         
@@ -103,9 +393,12 @@ public:
                 vec_b[i * matrix_size + j] = *b.data(i, j);
             }
         }
+        from_numpy.stop();
 
-        std::vector<int> vec_result = runner_.run(vec_a, vec_b, matrix_size);
+        sharded_last_ = false;
+        std::vector<int> vec_result = runner_->run(vec_a, vec_b, matrix_size);
 
+        PhaseTimer::Scope numpy(*phases_, Phase::to_numpy);
         py::array_t<int> result_array({matrix_size, matrix_size});
         for (int i = 0; i < matrix_size; i++) {
             for (int j = 0; j < matrix_size; j++) {
@@ -116,28 +409,281 @@ public:
         return result_array;
     }
 
+    py::array_t<int> matmul(py::array_t<int, py::array::c_style | py::array::forcecast> a,
+                            py::array_t<int, py::array::c_style | py::array::forcecast> b) {
+        if (a.ndim() != 2 || b.ndim() != 2) {
+            throw std::runtime_error("Input arrays must be 2-dimensional.");
+        }
+        if (a.shape(1) != b.shape(0)) {
+            throw std::runtime_error("Inner dimensions of the matrices do not match.");
+        }
+
+        int m = a.shape(0);
+        int k = a.shape(1);
+        int n = b.shape(1);
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        py::array_t<int> result_array({m, n});
+        if (!runner_) {
+            MMTilePlan plan(m, k, n);  // 形の検査はFPGAと同じにする
+            timed_cpu([&] { cpu_gemm(a.data(), b.data(), result_array.mutable_data(), plan.m, plan.k, plan.n); });
+            return result_array;
+        }
+        if (devices_->size() > 1) {
+            MMTilePlan plan(m, k, n);  // 分ける前に形を検査する
+            const int* pa = a.data();
+            const int* pb = b.data();
+            int* pc = result_array.mutable_data();
+            run_sharded(m, MM_TILE, [&](MMRunner& runner, const Shard& s) {
+                runner.matmul(pa + s.begin * k, pb, pc + s.begin * n, static_cast<int>(s.count), k, n);
+            });
+            return result_array;
+        }
+        sharded_last_ = false;
+        runner_->matmul(a.data(), b.data(), result_array.mutable_data(), m, k, n);
+        return result_array;
+    }
+
+    py::array_t<int> run_batch(py::array_t<int, py::array::c_style | py::array::forcecast> a,
+                               py::array_t<int, py::array::c_style | py::array::forcecast> b) {
+        if (a.ndim() != 3 || b.ndim() != 3) {
+            throw std::runtime_error("Input arrays must be 3-dimensional (batch, 16, 16).");
+        }
+        if (a.shape(1) != MM_TILE || a.shape(2) != MM_TILE || b.shape(1) != MM_TILE || b.shape(2) != MM_TILE) {
+            throw std::runtime_error("Input matrices must be 16x16.");
+        }
+        if (a.shape(0) != b.shape(0)) {
+            throw std::runtime_error("Input arrays must have the same batch size.");
+        }
+
+        int batch = a.shape(0);
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        py::array_t<int> result_array({batch, MM_TILE, MM_TILE});
+        if (!runner_) {
+            timed_cpu([&] { cpu_gemm_batch(a.data(), b.data(), result_array.mutable_data(), batch, MM_TILE, MM_TILE, MM_TILE); });
+            return result_array;
+        }
+        if (devices_->size() > 1) {
+            const size_t tile = MM_TILE * MM_TILE;
+            const int* pa = a.data();
+            const int* pb = b.data();
+            int* pc = result_array.mutable_data();
+            run_sharded(batch, 1, [&](MMRunner& runner, const Shard& s) {
+                runner.run_batch(pa + s.begin * tile, pb + s.begin * tile, pc + s.begin * tile, static_cast<int>(s.count));
+            });
+            return result_array;
+        }
+        sharded_last_ = false;
+        runner_->run_batch(a.data(), b.data(), result_array.mutable_data(), batch);
+        return result_array;
+    }
+
+    // 16x16または (batch, 16, 16) のDeviceArrayどうしの積をDeviceArrayで返す。FPGAでは0番のカードで実行する。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        check_tiles(a, "a");
+        check_tiles(b, "b");
+        if (a.shape() != b.shape()) {
+            throw std::runtime_error("Input arrays must have the same shape.");
+        }
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            int batch = a.ndim() == 3 ? static_cast<int>(a.shape()[0]) : 1;
+            DeviceArray c = DeviceArray::host(a.shape(), DType::int32);
+            timed_cpu([&] {
+                cpu_gemm_batch(a.host_data<int>(), b.host_data<int>(), c.host_data<int>(), batch, MM_TILE, MM_TILE, MM_TILE);
+            });
+            return c;
+        }
+        sharded_last_ = false;
+        py::gil_scoped_release release;
+        return runner_->run_device(a, b);
+    }
+
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 2 && a.ndim() != 3) {
+            throw std::runtime_error("Input array must be 2- or 3-dimensional.");
+        }
+        if (!runner_) {
+            return host_device_array(a);
+        }
+        return runner_->to_device(a.data(), array_shape(a));
+    }
+
+    py::tuple alloc_inputs() {
+        if (!runner_) {
+            cpu_a_ = py::array_t<int>({16, 16});
+            cpu_b_ = py::array_t<int>({16, 16});
+            cpu_c_ = py::array_t<int>({16, 16});
+            cpu_mapped_ = true;
+            return py::make_tuple(cpu_a_, cpu_b_);
+        }
+        runner_->allocate_mapped(16);
+        return py::make_tuple(bo_array(runner_->mapped_a(), {16, 16}), bo_array(runner_->mapped_b(), {16, 16}));
+    }
+
+    py::array_t<int> run_mapped() {
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            if (!cpu_mapped_) {
+                throw std::runtime_error("Mapped buffers are not allocated.");
+            }
+            timed_cpu([&] { cpu_gemm(cpu_a_.data(), cpu_b_.data(), cpu_c_.mutable_data(), 16, 16, 16); });
+            return cpu_c_;
+        }
+        sharded_last_ = false;
+        runner_->run_mapped();
+        return bo_array(runner_->mapped_c(), {16, 16});
+    }
+
     double get_kernel_execution_time_ms() const {
-        return runner_.get_kernel_execution_time_ms();
+        if (sharded_last_) {
+            return sharded_kernel_time_ms_;
+        }
+        return runner_ ? runner_->get_kernel_execution_time_ms() : cpu_time_ms_;
     }
 
     double get_total_execution_time_ms() const {
-        return runner_.get_total_execution_time_ms();
+        if (sharded_last_) {
+            return sharded_total_time_ms_;
+        }
+        return runner_ ? runner_->get_total_execution_time_ms() : cpu_time_ms_;
+    }
+
+    // 同期実行のrunの起動回数とset_argの回数。同じ形の呼び出しが続けばset_argは増えない (CPUバックエンドでは0)
+    py::dict get_launch_stats() const {
+        py::dict d;
+        d["launches"] = runner_ ? runner_->launcher().launches() : 0;
+        d["set_arg_calls"] = runner_ ? runner_->launcher().set_arg_calls() : 0;
+        return d;
+    }
+
+    // CUごとに割り当てたrun_batch()の範囲の数 (CPUバックエンドでは空)
+    std::vector<uint64_t> get_cu_stats() const {
+        return runner_ ? runner_->cu_dispatched() : std::vector<uint64_t>();
+    }
+
+    // 使っているカードの枚数 (CPUバックエンドでは0)
+    size_t num_devices() const {
+        return devices_ ? devices_->size() : 0;
+    }
+
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(*phases_);
+    }
+
+    void reset_phase_stats() {
+        phases_->reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        phases_->set_enabled(enabled);
     }
 
 private:
-    MMRunner runner_;
+    static void check_tiles(const DeviceArray& array, const char* name) {
+        bool tiles = array.ndim() == 2 || array.ndim() == 3;
+        for (size_t i = array.ndim() - 2; tiles && i < array.ndim(); ++i) {
+            tiles = array.shape()[i] == MM_TILE;
+        }
+        if (array.dtype() != DType::int32 || !tiles) {
+            throw std::runtime_error(std::string(name) + " must be an int32 DeviceArray of shape (16, 16) or (batch, 16, 16).");
+        }
+    }
+
+    // count行 (または行列) をalign単位でカードに分けてfn(runner, shard)を同時に呼ぶ。
+    // カーネル時間は最も遅いカードの値、合計時間は全カードの完了までを記録する。
+    template <typename Fn>
+    void run_sharded(int count, size_t align, Fn fn) {
+        py::gil_scoped_release release;
+        auto start_total = std::chrono::high_resolution_clock::now();
+        std::vector<Shard> shards = devices_->shard(count, align, [&](MMRunner& runner, const Shard& s, size_t) {
+            fn(runner, s);
+        });
+        sharded_kernel_time_ms_ = 0.0;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            sharded_kernel_time_ms_ = std::max(sharded_kernel_time_ms_, devices_->runner(i).get_kernel_execution_time_ms());
+        }
+        auto end_total = std::chrono::high_resolution_clock::now();
+        sharded_total_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+        sharded_last_ = true;
+    }
+
+    // CPUバックエンドでは転送がないため、カーネル時間と合計時間は同じ値になる
+    template <typename Fn>
+    void timed_cpu(Fn fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+        fn();
+        cpu.stop();
+        auto end = std::chrono::high_resolution_clock::now();
+        cpu_time_ms_ = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();  // 全カードのランナーで共有する
+    std::unique_ptr<DeviceGroup<MMRunner>> devices_;  // CPUバックエンドのときはnull
+    MMRunner* runner_ = nullptr;  // 0番のカードのランナー (CPUバックエンドのときはnull)
+    Backend backend_;
+    py::array_t<int> cpu_a_, cpu_b_, cpu_c_;  // CPUバックエンドのalloc_inputs()の配列
+    bool cpu_mapped_ = false;
+    double cpu_time_ms_ = 0.0;
+    bool sharded_last_ = false;  // 直前の計測が複数カードでの実行か
+    double sharded_kernel_time_ms_ = 0.0;
+    double sharded_total_time_ms_ = 0.0;
 };
 
 PYBIND11_MODULE(libmm_module_hw, m) {
     m.doc() = "pybind11 wrapper for MMRunner (Hardware)";
+    register_device_array(m);
 
     py::class_<PyMMRunner>(m, "MMRunner")
-        .def(py::init<const std::string&>())
+        .def(py::init<const std::string&, const std::string&, size_t, size_t>(),
+             py::arg("xclbin_path"), py::arg("backend") = "auto", py::arg("num_cus") = 1, py::arg("num_devices") = 1,
+             "backend is \"auto\" (FPGA if the device and xclbin open, otherwise the SIMD multithreaded CPU backend), "
+             "\"fpga\" or \"cpu\". num_cus > 1 splits run_batch() across the compute units mm_1..mm_N (built with NUM_CU=N). "
+             "num_devices > 1 (0 for every device found) splits matmul() by rows of 16 and run_batch() by batch across that many cards; "
+             "run() and the zero-copy path use device 0.")
+        .def("backend", &PyMMRunner::backend,
+             "Returns the backend selected at construction (\"fpga\" or \"cpu\").")
+        .def("run", &PyMMRunner::run_device,
+             py::arg("a"), py::arg("b"),
+             "Multiplies int32 DeviceArrays of shape (16, 16) or (batch, 16, 16) and returns the result as a DeviceArray "
+             "without transferring anything to the host. On the FPGA backend the arrays must be on device 0.")
         .def("run", &PyMMRunner::run,
              py::arg("a"), py::arg("b"),
              "Runs the mm kernel with two input numpy arrays (16x16 matrices) and returns the result as a numpy array.")
+        .def("run_batch", &PyMMRunner::run_batch,
+             py::arg("a"), py::arg("b"),
+             "Multiplies batch pairs of 16x16 matrices given as (batch, 16, 16) arrays with one DMA per input and a single kernel launch "
+             "per compute unit.")
+        .def("matmul", &PyMMRunner::matmul,
+             py::arg("a"), py::arg("b"),
+             "Multiplies an MxK and a KxN matrix of any shape by tiling them into 16x16 blocks. "
+             "Each row of tiles is one batched launch sharing the A panel; all launches are issued before waiting.")
+        .def("to_device", &PyMMRunner::to_device,
+             py::arg("a"),
+             "Transfers a (16, 16) or (batch, 16, 16) numpy array to device 0 and returns it as an int32 DeviceArray "
+             "(host memory on the CPU backend).")
+        .def("alloc_inputs", &PyMMRunner::alloc_inputs,
+             "Allocates the input matrices (a, b) of 16x16 directly in device buffer host memory. Fill them in place and call run_mapped().")
+        .def("run_mapped", &PyMMRunner::run_mapped,
+             "Runs the mm kernel on the matrices from alloc_inputs() and returns the output buffer as a 16x16 numpy array without copying. "
+             "The returned array is overwritten by the next run_mapped().")
         .def("get_kernel_execution_time_ms", &PyMMRunner::get_kernel_execution_time_ms,
             "Returns the kernel execution time in milliseconds.")
         .def("get_total_execution_time_ms", &PyMMRunner::get_total_execution_time_ms,
-            "Returns the total execution time including data transfers in milliseconds.");
+            "Returns the total execution time including data transfers in milliseconds.")
+        .def("get_launch_stats", &PyMMRunner::get_launch_stats,
+            "Returns {launches, set_arg_calls} for the reused run of the synchronous path. Repeated calls with the same "
+            "shape reuse the same BOs, so set_arg_calls stays flat (all 0 on the CPU backend).")
+        .def("get_cu_stats", &PyMMRunner::get_cu_stats,
+            "Returns the number of run_batch() ranges dispatched to each compute unit (empty on the CPU backend).")
+        .def("num_devices", &PyMMRunner::num_devices,
+            "Returns the number of devices in use (0 on the CPU backend).")
+        .def("get_phase_stats", &PyMMRunner::get_phase_stats,
+            "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}} "
+            "for the phases recorded so far. matmul() records tile packing as write and unpacking as read.")
+        .def("reset_phase_stats", &PyMMRunner::reset_phase_stats,
+            "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyMMRunner::set_phase_timing,
+            py::arg("enabled"),
+            "Enables or disables per-phase timing (enabled by default).");
 }
@@ -10,7 +10,10 @@
 #include <pybind11/numpy.h>
 #include <vector>
 
-extern "C" void mm(const int* a, const int* b, int* c, int size);
+#include "device_array_py.h"
+#include "mm_tiling.h"
+
+extern "C" void mm(const int* a, const int* b, int* c, int size, int batch, int a_step);
 
 namespace py = pybind11;
 
@@ -45,7 +48,7 @@ public:
             }
         }
 
-        mm(vec_a.data(), vec_b.data(), vec_result.data(), matrix_size);
+        mm(vec_a.data(), vec_b.data(), vec_result.data(), matrix_size, 1, total_size);
         
         py::array_t<int> result_array({matrix_size, matrix_size});
         for (int i = 0; i < matrix_size; i++) {
@@ -56,14 +59,100 @@ public:
         
         return result_array;
     }
+
+    // batch個の独立した16x16行列積: a, b は (batch, 16, 16)。1回のmm()呼び出しでまとめて計算する。
+    py::array_t<int> run_batch(py::array_t<int, py::array::c_style | py::array::forcecast> np_a,
+                               py::array_t<int, py::array::c_style | py::array::forcecast> np_b) {
+        if (np_a.ndim() != 3 || np_b.ndim() != 3) {
+            throw std::runtime_error("Input arrays must be 3-dimensional (batch, 16, 16).");
+        }
+        if (np_a.shape(1) != MM_TILE || np_a.shape(2) != MM_TILE || np_b.shape(1) != MM_TILE || np_b.shape(2) != MM_TILE) {
+            throw std::runtime_error("Input matrices must be 16x16.");
+        }
+        if (np_a.shape(0) != np_b.shape(0)) {
+            throw std::runtime_error("Input arrays must have the same batch size.");
+        }
+
+        int batch = np_a.shape(0);
+        py::array_t<int> result_array({batch, MM_TILE, MM_TILE});
+        mm(np_a.data(), np_b.data(), result_array.mutable_data(), MM_TILE, batch, MM_TILE * MM_TILE);
+        return result_array;
+    }
+
+    // ホストメモリの16x16または (batch, 16, 16) のDeviceArrayどうしの積。1回のmm()呼び出しで計算する。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        for (const DeviceArray* array : {&a, &b}) {
+            bool tiles = array->ndim() == 2 || array->ndim() == 3;
+            for (size_t i = array->ndim() - 2; tiles && i < array->ndim(); ++i) {
+                tiles = array->shape()[i] == MM_TILE;
+            }
+            if (array->dtype() != DType::int32 || !tiles) {
+                throw std::runtime_error("Inputs must be int32 DeviceArrays of shape (16, 16) or (batch, 16, 16).");
+            }
+        }
+        if (a.shape() != b.shape()) {
+            throw std::runtime_error("Input arrays must have the same shape.");
+        }
+        int batch = a.ndim() == 3 ? a.shape()[0] : 1;
+        DeviceArray c = DeviceArray::host(a.shape(), DType::int32);
+        mm(a.host_data<int>(), b.host_data<int>(), c.host_data<int>(), MM_TILE, batch, MM_TILE * MM_TILE);
+        return c;
+    }
+
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 2 && a.ndim() != 3) {
+            throw std::runtime_error("Input array must be 2- or 3-dimensional.");
+        }
+        return host_device_array(a);
+    }
+
+    // 任意サイズの行列積 (MxK * KxN)。16x16タイルに分割してmm()を呼び出す。
+    py::array_t<int> matmul(py::array_t<int, py::array::c_style | py::array::forcecast> np_a,
+                            py::array_t<int, py::array::c_style | py::array::forcecast> np_b) {
+        if (np_a.ndim() != 2 || np_b.ndim() != 2) {
+            throw std::runtime_error("Input arrays must be 2-dimensional.");
+        }
+        if (np_a.shape(1) != np_b.shape(0)) {
+            throw std::runtime_error("Inner dimensions of the matrices do not match.");
+        }
+
+        MMTilePlan plan(np_a.shape(0), np_a.shape(1), np_b.shape(1));
+        std::vector<int> a_panels(plan.a_panels_size());
+        std::vector<int> b_panels(plan.b_panels_size());
+        std::vector<int> c_tiles(plan.c_tiles_size());
+
+        py::array_t<int> result_array({plan.m, plan.n});
+        mm_tiled(plan, np_a.data(), np_b.data(), result_array.mutable_data(),
+                 a_panels.data(), b_panels.data(), c_tiles.data(), [&] {
+            // 行タイルごとに1回、Aパネルを共有して全列タイルをバッチ実行する
+            for (int rt = 0; rt < plan.row_tiles; rt++) {
+                mm(a_panels.data() + rt * plan.a_stride, b_panels.data(), c_tiles.data() + plan.c_offset(rt, 0),
+                   plan.depth, plan.col_tiles, 0);
+            }
+        });
+        return result_array;
+    }
 };
 
 PYBIND11_MODULE(libmm_module_sw, m) {
     m.doc() = "pybind11 wrapper for MM software simulation"; 
+    register_device_array(m);
 
     py::class_<MMSim>(m, "MMSim")
         .def(py::init<>())
+        .def("run", &MMSim::run_device,
+             py::arg("a"), py::arg("b"),
+             "Multiplies int32 DeviceArrays of shape (16, 16) or (batch, 16, 16) in host memory and returns a DeviceArray.")
         .def("run", &MMSim::run,
              py::arg("a"), py::arg("b"),
-             "Runs the mm kernel software simulation with two input numpy arrays (16x16 matrices) and returns the result as a numpy array.");
+             "Runs the mm kernel software simulation with two input numpy arrays (16x16 matrices) and returns the result as a numpy array.")
+        .def("run_batch", &MMSim::run_batch,
+             py::arg("a"), py::arg("b"),
+             "Multiplies batch pairs of 16x16 matrices given as (batch, 16, 16) arrays in one kernel call.")
+        .def("matmul", &MMSim::matmul,
+             py::arg("a"), py::arg("b"),
+             "Multiplies an MxK and a KxN matrix of any shape by tiling them into 16x16 blocks for the mm kernel.")
+        .def("to_device", &MMSim::to_device,
+             py::arg("a"),
+             "Copies a (16, 16) or (batch, 16, 16) numpy array into an int32 DeviceArray backed by host memory.");
 }
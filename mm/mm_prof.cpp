@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "mm_body.h"
+
+// 計測版 (mm_prof)。mmと同じ計算をし、フェーズごとのサイクル数をprof (4ワード、../common/kernel_profile.h) に書く。
+extern "C" void mm_prof(const int* a, const int* b, int* c, int size, int batch, int a_step, unsigned long long* prof) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=b offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=c offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=prof offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=size
+#pragma HLS INTERFACE s_axilite port=batch
+#pragma HLS INTERFACE s_axilite port=a_step
+#pragma HLS INTERFACE s_axilite port=return
+
+    KernelProfileEvents events;
+#pragma HLS STREAM variable=events depth=4
+#pragma HLS DATAFLOW
+    mm_body(a, b, c, size, batch, a_step, events);
+    kernel_profile_counter(events, prof);
+}
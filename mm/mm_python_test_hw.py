@@ -1,9 +1,21 @@
 import numpy as np
+import os
 import time
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+from bench_record import BenchRecorder
 from libmm_module_hw import MMRunner
 
 MEGA = 1024 * 1024
 
+# xclbinのCUの数 (Makefileの NUM_CU と合わせる)
+NUM_CU = int(os.environ.get("NUM_CU", "1"))
+
+# 使うカードの枚数 (Makefileの NUM_DEVICES と合わせる。0は見つかったすべて)
+NUM_DEVICES = int(os.environ.get("NUM_DEVICES", "1"))
+
 def test_mm_hw():
     MATRIX_SIZE = 16
     print(f"Running MM hardware test (via Python) with matrix size: {MATRIX_SIZE}x{MATRIX_SIZE}")
@@ -13,7 +25,7 @@ def test_mm_hw():
     
     XCLBIN_FILE = "mm.xclbin"
     try:
-        runner = MMRunner(XCLBIN_FILE)
+        runner = MMRunner(XCLBIN_FILE, num_cus=NUM_CU, num_devices=NUM_DEVICES)
     except Exception as e:
         print(f"Error initializing MMRunner with {XCLBIN_FILE}: {e}")
         print(f"Please ensure '{XCLBIN_FILE}' exists and XRT is set up correctly.")
@@ -30,6 +42,10 @@ def test_mm_hw():
         print(f"Error during MMRunner.run (initial): {e}")
         return
 
+    # 1回のrun()でwrite (BOへの書き込み) とfrom_numpy (入力のコピー) を1件ずつ記録する
+    runner.reset_phase_stats()
+    # 同じ形のrun()が続く間はBOとスカラー引数が前回と同じなので、set_argを呼ばずに再起動する
+    launches_before = runner.get_launch_stats()
     for i in range(num_iterations):
         print(f"Iteration {i+1}/{num_iterations}")
         
@@ -48,6 +64,14 @@ def test_mm_hw():
         kernel_times.append(kernel_time_ms)
         total_times.append(total_time_ms)
 
+    if runner.backend() == "fpga":
+        counted = runner.get_phase_stats()
+        assert counted["write"]["count"] == num_iterations, "One write sample per run()."
+        assert counted["from_numpy"]["count"] == num_iterations, "One from_numpy sample per run()."
+        launches = runner.get_launch_stats()
+        assert launches["launches"] - launches_before["launches"] == num_iterations, "One launch per run()."
+        assert launches["set_arg_calls"] == launches_before["set_arg_calls"], "Repeated run() reuses its BOs and arguments."
+
     expected_result = np.matmul(a, b)
 
     if np.array_equal(result_hw, expected_result):
@@ -60,6 +84,17 @@ def test_mm_hw():
         print(f"Max difference: {np.max(diff)}")
         print(f"Mean difference: {np.mean(diff)}")
 
+    # ゼロコピー経路: 入力をBOのホストメモリに直接書き込む
+    a_mapped, b_mapped = runner.alloc_inputs()
+    a_mapped[:] = a
+    b_mapped[:] = b
+    mapped_total_times = []
+    for i in range(num_iterations):
+        result_mapped = runner.run_mapped()
+        mapped_total_times.append(runner.get_total_execution_time_ms())
+    if not np.array_equal(result_mapped, expected_result):
+        print("Zero-copy result does not match expected result.")
+
     avg_kernel_time_ms = np.mean(kernel_times)
     avg_total_time_ms = np.mean(total_times)
 
@@ -73,7 +108,30 @@ def test_mm_hw():
     print(f"Average total execution time: {avg_total_time_ms:.4f} ms")
     print(f"Throughput (kernel only): {throughput_kernel_mega_ops_per_sec:.2f} M Ops/sec")
     print(f"Throughput (total): {throughput_total_mega_ops_per_sec:.2f} M Ops/sec")
+    print(f"Average zero-copy total execution time: {np.mean(mapped_total_times):.4f} ms")
     
+    # バッチ実行: CUが複数あればbatchをCUの数に分けて同時に実行する
+    batch = 256
+    a_batch = np.random.randint(0, 10, size=(batch, 16, 16), dtype=np.int32)
+    b_batch = np.random.randint(0, 10, size=(batch, 16, 16), dtype=np.int32)
+    batch_start = time.perf_counter()
+    result_batch = runner.run_batch(a_batch, b_batch)
+    batch_time_ms = (time.perf_counter() - batch_start) * 1000.0
+    assert np.array_equal(result_batch, np.matmul(a_batch, b_batch)), "Batch result does not match expected value."
+    print(f"Batch of {batch} (Python measured): {batch_time_ms:.4f} ms, ranges per compute unit: {runner.get_cu_stats()}")
+    if runner.backend() == "fpga" and NUM_DEVICES > 0:
+        assert runner.num_devices() == NUM_DEVICES, "One runner per device."
+    print(f"Devices: {runner.num_devices()}")
+    phases = runner.get_phase_stats()
+    print(f"Phase latency p50/p99 (us): { {p: (round(s['p50_us'], 1), round(s['p99_us'], 1)) for p, s in phases.items()} }")
+
+    # DeviceArray: 積をカード上に置いたまま次の積の入力にし、(A * B) * Bの結果だけをホストへ戻す
+    a_dev = runner.to_device(a_batch)
+    b_dev = runner.to_device(b_batch)
+    chained = runner.run(runner.run(a_dev, b_dev), b_dev)
+    assert chained.shape == (batch, 16, 16)
+    assert np.array_equal(chained.to_host(), a_batch @ b_batch @ b_batch), "Chained DeviceArray result does not match."
+
     print("\n--- Numpy Performance Comparison ---")
     numpy_times = []
     for i in range(num_iterations):
@@ -90,6 +148,51 @@ def test_mm_hw():
     print(f"Speedup (kernel vs numpy): {avg_numpy_time_ms / avg_kernel_time_ms:.2f}x")
     print(f"Speedup (total vs numpy): {avg_numpy_time_ms / avg_total_time_ms:.2f}x")
     
+    # CPUバックエンド: 同じAPIをSIMD・複数スレッドのCPU実装で実行する
+    cpu_runner = MMRunner(XCLBIN_FILE, backend="cpu")
+    assert cpu_runner.backend() == "cpu"
+    assert np.array_equal(cpu_runner.run(a, b), expected_result), "CPU backend result does not match expected result."
+    cpu_c = cpu_runner.run(cpu_runner.to_device(a), cpu_runner.to_device(b))
+    assert np.array_equal(cpu_c.to_host(), expected_result), "CPU backend DeviceArray result does not match."
+    a_large = np.random.randint(-10, 10, size=(300, 200), dtype=np.int32)
+    b_large = np.random.randint(-10, 10, size=(200, 100), dtype=np.int32)
+    cpu_times = []
+    for i in range(num_iterations):
+        result_cpu = cpu_runner.matmul(a_large, b_large)
+        cpu_times.append(cpu_runner.get_total_execution_time_ms())
+    assert np.array_equal(result_cpu, a_large @ b_large), "CPU backend matmul does not match numpy."
+    print(f"Average CPU backend matmul time (300x200x100): {np.mean(cpu_times):.4f} ms")
+    recorder = BenchRecorder()
+    recorder.add("mm", "mm_python_test_hw", {"size": MATRIX_SIZE, "phase": "kernel"}, kernel_times)
+    recorder.add("mm", "mm_python_test_hw", {"size": MATRIX_SIZE, "phase": "total"}, total_times)
+    recorder.add("mm", "mm_python_test_hw", {"size": MATRIX_SIZE, "phase": "total_mapped"}, mapped_total_times)
+    recorder.add("numpy.matmul", "mm_python_test_hw", {"size": MATRIX_SIZE}, numpy_times)
+    recorder.add("mm", "mm_python_test_hw", {"m": 300, "k": 200, "n": 100, "phase": "total_cpu"}, cpu_times)
+
+    print("\n--- Tiled GEMM ---")
+    for m, k, n in [(100, 37, 70), (256, 256, 256)]:
+        a_big = np.random.randint(-10, 10, size=(m, k), dtype=np.int32)
+        b_big = np.random.randint(-10, 10, size=(k, n), dtype=np.int32)
+        result_tiled = runner.matmul(a_big, b_big)
+        status = "PASSED" if np.array_equal(result_tiled, np.matmul(a_big, b_big)) else "FAILED"
+        recorder.add("mm", "mm_python_test_hw", {"m": m, "k": k, "n": n, "phase": "total_tiled"},
+                     [runner.get_total_execution_time_ms()])
+        print(f"Tiled {m}x{k}x{n}: {status}, kernel {runner.get_kernel_execution_time_ms():.4f} ms, "
+              f"total {runner.get_total_execution_time_ms():.4f} ms")
+
+    print("\n--- Batched 16x16 ---")
+    for batch in [1, 64, 4096, 65536]:
+        a_batch = np.random.randint(-10, 10, size=(batch, MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
+        b_batch = np.random.randint(-10, 10, size=(batch, MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
+        result_batch = runner.run_batch(a_batch, b_batch)
+        status = "PASSED" if np.array_equal(result_batch, np.matmul(a_batch, b_batch)) else "FAILED"
+        per_matrix_us = runner.get_total_execution_time_ms() * 1000.0 / batch
+        recorder.add("mm", "mm_python_test_hw", {"size": MATRIX_SIZE, "batch": batch, "phase": "total_batched"},
+                     [runner.get_total_execution_time_ms()])
+        print(f"Batch {batch}: {status}, kernel {runner.get_kernel_execution_time_ms():.4f} ms, "
+              f"total {runner.get_total_execution_time_ms():.4f} ms, {per_matrix_us:.3f} us/matrix")
+
+    recorder.write()
     print("Python HW test completed.")
 
 if __name__ == "__main__":
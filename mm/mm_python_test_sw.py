@@ -33,5 +33,32 @@ def test_mm_sw():
         print(f"Max difference: {np.max(diff)}")
         print(f"Mean difference: {np.mean(diff)}")
 
+    # 任意サイズの行列積 (16x16タイルに分割)
+    for m, k, n in [(17, 33, 5), (100, 37, 70), (128, 256, 64)]:
+        a = np.random.randint(-10, 10, size=(m, k), dtype=np.int32)
+        b = np.random.randint(-10, 10, size=(k, n), dtype=np.int32)
+        result_tiled = simulator.matmul(a, b)
+        if np.array_equal(result_tiled, np.matmul(a, b)):
+            print(f"Tiled {m}x{k}x{n}: PASSED")
+        else:
+            print(f"Tiled {m}x{k}x{n}: FAILED")
+
+    # バッチ実行 (batch個の16x16行列積を1回で計算)
+    batch = 1000
+    a = np.random.randint(-10, 10, size=(batch, MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
+    b = np.random.randint(-10, 10, size=(batch, MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
+    result_batch = simulator.run_batch(a, b)
+    if np.array_equal(result_batch, np.matmul(a, b)):
+        print(f"Batch {batch}: PASSED")
+    else:
+        print(f"Batch {batch}: FAILED")
+
+    # DeviceArray: 積の結果をホストメモリのDeviceArrayのまま次の積に渡す
+    a_dev = simulator.to_device(a)
+    b_dev = simulator.to_device(b)
+    chained = simulator.run(simulator.run(a_dev, b_dev), b_dev)
+    status = "PASSED" if np.array_equal(chained.to_host(), a @ b @ b) else "FAILED"
+    print(f"DeviceArray chain: {status}")
+
 if __name__ == "__main__":
     test_mm_sw()
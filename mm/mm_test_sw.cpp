@@ -10,7 +10,104 @@
 #include <cstdlib>
 #include <ctime>
 
-extern "C" void mm(const int* a, const int* b, int* c, int size);
+#include "kernel_profile.h"
+#include "mm_tiling.h"
+
+extern "C" void mm(const int* a, const int* b, int* c, int size, int batch, int a_step);
+extern "C" void mm_prof(const int* a, const int* b, int* c, int size, int batch, int a_step, unsigned long long* prof);
+
+// タイル分割エンジンで任意サイズの行列積を計算し、参照実装と比較する
+bool test_tiled(int m, int k, int n) {
+    std::vector<int> a(static_cast<size_t>(m) * k);
+    std::vector<int> b(static_cast<size_t>(k) * n);
+    std::vector<int> c_hw(static_cast<size_t>(m) * n, -1);
+    std::vector<int> c_sw(static_cast<size_t>(m) * n);
+
+    for (auto& v : a) v = rand() % 21 - 10;
+    for (auto& v : b) v = rand() % 21 - 10;
+
+    MMTilePlan plan(m, k, n);
+    std::vector<int> a_panels(plan.a_panels_size());
+    std::vector<int> b_panels(plan.b_panels_size());
+    std::vector<int> c_tiles(plan.c_tiles_size());
+    mm_tiled(plan, a.data(), b.data(), c_hw.data(), a_panels.data(), b_panels.data(), c_tiles.data(), [&] {
+        // 行タイルごとに1回、Aパネルを共有して全列タイルをバッチ実行する
+        for (int rt = 0; rt < plan.row_tiles; ++rt) {
+            mm(a_panels.data() + rt * plan.a_stride, b_panels.data(), c_tiles.data() + plan.c_offset(rt, 0),
+               plan.depth, plan.col_tiles, 0);
+        }
+    });
+    mm_reference(a.data(), b.data(), c_sw.data(), m, k, n);
+
+    for (size_t i = 0; i < c_sw.size(); ++i) {
+        if (c_hw[i] != c_sw[i]) {
+            std::cerr << "Tiled " << m << "x" << k << "x" << n << " mismatch at index " << i
+                      << ": HW=" << c_hw[i] << ", SW=" << c_sw[i] << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Tiled " << m << "x" << k << "x" << n << " matches reference." << std::endl;
+    return true;
+}
+
+// 1回の呼び出しでbatch個の独立した16x16行列積を計算する
+bool test_batch(int batch) {
+    const int TILE_SIZE = MM_TILE * MM_TILE;
+    std::vector<int> a(static_cast<size_t>(batch) * TILE_SIZE);
+    std::vector<int> b(static_cast<size_t>(batch) * TILE_SIZE);
+    std::vector<int> c_hw(static_cast<size_t>(batch) * TILE_SIZE, -1);
+    std::vector<int> c_sw(TILE_SIZE);
+
+    for (auto& v : a) v = rand() % 21 - 10;
+    for (auto& v : b) v = rand() % 21 - 10;
+
+    mm(a.data(), b.data(), c_hw.data(), MM_TILE, batch, TILE_SIZE);
+
+    for (int n = 0; n < batch; ++n) {
+        mm_reference(a.data() + n * TILE_SIZE, b.data() + n * TILE_SIZE, c_sw.data(), MM_TILE, MM_TILE, MM_TILE);
+        for (int i = 0; i < TILE_SIZE; ++i) {
+            if (c_hw[n * TILE_SIZE + i] != c_sw[i]) {
+                std::cerr << "Batch " << batch << " mismatch in matrix " << n << " at index " << i
+                          << ": HW=" << c_hw[n * TILE_SIZE + i] << ", SW=" << c_sw[i] << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "Batch of " << batch << " matches reference." << std::endl;
+    return true;
+}
+
+// 計測版mm_profの結果がmmと一致し、読み込み・積和・書き込みの3つのフェーズがすべて数えられる
+bool test_prof(int size, int batch) {
+    std::vector<int> a(static_cast<size_t>(MM_TILE) * size);
+    std::vector<int> b(static_cast<size_t>(batch) * size * MM_TILE);
+    std::vector<int> c(static_cast<size_t>(batch) * MM_TILE * MM_TILE);
+    std::vector<int> c_prof(c.size());
+    for (auto& v : a) v = rand() % 21 - 10;
+    for (auto& v : b) v = rand() % 21 - 10;
+
+    unsigned long long prof[KERNEL_PROFILE_WORDS] = {};
+    mm(a.data(), b.data(), c.data(), size, batch, 0);
+    mm_prof(a.data(), b.data(), c_prof.data(), size, batch, 0, prof);
+    if (c_prof != c) {
+        std::cerr << "mm_prof result differs from mm" << std::endl;
+        return false;
+    }
+    bool ok = kernel_profile_consistent(prof);
+    for (int i = 0; i < KERNEL_PROFILE_PHASES; ++i) {
+        ok &= prof[i] > 0;
+    }
+    KernelProfile p = kernel_profile_decode(prof);
+    std::cout << "mm_prof (size " << size << ", batch " << batch << "):";
+    for (int i = 0; i < KERNEL_PROFILE_WORDS; ++i) {
+        std::cout << " " << kernel_profile_phase_name(i) << " " << p.us[i] << " us";
+    }
+    std::cout << std::endl;
+    if (!ok) {
+        std::cerr << "Unexpected mm_prof profile" << std::endl;
+    }
+    return ok;
+}
 
 int main() {
     const int MATRIX_SIZE = 16;
@@ -39,7 +136,7 @@ int main() {
         }
     }
 
-    mm(a.data(), b.data(), c_hw.data(), MATRIX_SIZE);
+    mm(a.data(), b.data(), c_hw.data(), MATRIX_SIZE, 1, TOTAL_SIZE);
 
     bool match = true;
     for (int i = 0; i < TOTAL_SIZE; ++i) {
@@ -50,6 +147,17 @@ int main() {
         }
     }
 
+    // 端の0埋め、K方向の累積、1タイル未満の形状を含む
+    match &= test_tiled(1, 1, 1);
+    match &= test_tiled(16, 48, 16);
+    match &= test_tiled(17, 33, 5);
+    match &= test_tiled(64, 64, 64);
+    match &= test_tiled(100, 37, 70);
+    match &= test_tiled(3, 200, 129);
+    match &= test_batch(1);
+    match &= test_batch(1000);
+    match &= test_prof(64, 200);
+
     if (match) {
         std::cout << "Test PASSED!" << std::endl;
         return 0; // Success
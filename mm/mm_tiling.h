@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+// 16x16のmmカーネルで任意サイズの行列積 C(MxN) = A(MxK) * B(KxN) を計算するためのタイル分割。
+// Aは行タイルごとに16 x depthのパネル、Bは列タイルごとにdepth x 16のパネルへ詰め (端は0埋め)、
+// 各Cタイル (16x16) はK方向をカーネル内で累積して求める。Bパネル・Cタイルは連続して並べるため、
+// 1つの行タイルの全Cタイルを、Aパネルを共有した (a_step = 0) 1回のバッチ起動で計算できる。
+
+const int MM_TILE = 16;
+
+struct MMTilePlan {
+    int m, k, n;
+    int row_tiles;  // Mを16で切り上げたタイル数
+    int col_tiles;  // Nを16で切り上げたタイル数
+    int depth;      // Kを16の倍数に切り上げた長さ (カーネルのsize引数)
+    size_t a_stride;      // Aパネル間の間隔 (要素数)
+    size_t b_stride;      // Bパネル間の間隔 (要素数、詰めて並べる)
+    size_t c_stride;      // 同じ行タイル内のCタイル間の間隔 (要素数、詰めて並べる)
+    size_t c_row_stride;  // 行タイル間の間隔 (要素数)
+
+    // alignはAパネルとCの行タイルの先頭を揃える要素数 (サブバッファのアライメント用)
+    MMTilePlan(int m, int k, int n, size_t align = 1) : m(m), k(k), n(n) {
+        if (m <= 0 || k <= 0 || n <= 0) {
+            throw std::runtime_error("Matrix dimensions must be positive.");
+        }
+        row_tiles = (m + MM_TILE - 1) / MM_TILE;
+        col_tiles = (n + MM_TILE - 1) / MM_TILE;
+        depth = (k + MM_TILE - 1) / MM_TILE * MM_TILE;
+        a_stride = round_up(static_cast<size_t>(MM_TILE) * depth, align);
+        b_stride = static_cast<size_t>(depth) * MM_TILE;
+        c_stride = static_cast<size_t>(MM_TILE) * MM_TILE;
+        c_row_stride = round_up(c_stride * col_tiles, align);
+    }
+
+    int num_tiles() const { return row_tiles * col_tiles; }
+    size_t a_panels_size() const { return a_stride * row_tiles; }
+    size_t b_panels_size() const { return b_stride * col_tiles; }
+    size_t c_tiles_size() const { return c_row_stride * row_tiles; }
+    size_t c_offset(int rt, int ct) const { return rt * c_row_stride + ct * c_stride; }
+
+    static size_t round_up(size_t value, size_t align) { return (value + align - 1) / align * align; }
+};
+
+// Aの行タイルrtを16 x depthのパネルへ詰める
+inline void mm_pack_a(const MMTilePlan& plan, const int* a, int rt, int* panel) {
+    std::memset(panel, 0, MM_TILE * plan.depth * sizeof(int));
+    for (int i = 0; i < MM_TILE && rt * MM_TILE + i < plan.m; i++) {
+        std::memcpy(panel + i * plan.depth, a + static_cast<size_t>(rt * MM_TILE + i) * plan.k, plan.k * sizeof(int));
+    }
+}
+
+// Bの列タイルctをdepth x 16のパネルへ詰める
+inline void mm_pack_b(const MMTilePlan& plan, const int* b, int ct, int* panel) {
+    std::memset(panel, 0, plan.depth * MM_TILE * sizeof(int));
+    int cols = plan.n - ct * MM_TILE < MM_TILE ? plan.n - ct * MM_TILE : MM_TILE;
+    for (int kk = 0; kk < plan.k; kk++) {
+        std::memcpy(panel + kk * MM_TILE, b + static_cast<size_t>(kk) * plan.n + ct * MM_TILE, cols * sizeof(int));
+    }
+}
+
+// Cタイル (rt, ct) の有効部分をCへ書き戻す
+inline void mm_unpack_c(const MMTilePlan& plan, const int* tile, int rt, int ct, int* c) {
+    int cols = plan.n - ct * MM_TILE < MM_TILE ? plan.n - ct * MM_TILE : MM_TILE;
+    for (int i = 0; i < MM_TILE && rt * MM_TILE + i < plan.m; i++) {
+        std::memcpy(c + static_cast<size_t>(rt * MM_TILE + i) * plan.n + ct * MM_TILE, tile + i * MM_TILE, cols * sizeof(int));
+    }
+}
+
+// パネルを詰めてrun_tiles()で全タイルを計算し、結果をCへ戻す。
+// run_tiles()はCタイル (rt, ct) をAパネルrt・Bパネルctから計算し、c_tiles + c_offset(rt, ct)へ書く。
+template <typename RunTiles>
+void mm_tiled(const MMTilePlan& plan, const int* a, const int* b, int* c,
+              int* a_panels, int* b_panels, int* c_tiles, RunTiles run_tiles) {
+    for (int rt = 0; rt < plan.row_tiles; rt++) {
+        mm_pack_a(plan, a, rt, a_panels + rt * plan.a_stride);
+    }
+    for (int ct = 0; ct < plan.col_tiles; ct++) {
+        mm_pack_b(plan, b, ct, b_panels + ct * plan.b_stride);
+    }
+
+    run_tiles();
+
+    for (int rt = 0; rt < plan.row_tiles; rt++) {
+        for (int ct = 0; ct < plan.col_tiles; ct++) {
+            mm_unpack_c(plan, c_tiles + plan.c_offset(rt, ct), rt, ct, c);
+        }
+    }
+}
+
+// 検証用の素朴な行列積
+inline void mm_reference(const int* a, const int* b, int* c, int m, int k, int n) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            int sum = 0;
+            for (int kk = 0; kk < k; kk++) {
+                sum += a[static_cast<size_t>(i) * k + kk] * b[static_cast<size_t>(kk) * n + j];
+            }
+            c[static_cast<size_t>(i) * n + j] = sum;
+        }
+    }
+}
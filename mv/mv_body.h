@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "ap_int.h"
+#include "hls_stream.h"
+
+#include "kernel_profile_counter.h"
+#include "mv_pack.h"
+
+// 1サイクルあたりの積和数 (部分和レーン数)。Aは512ビット (MV_WORD_INTS個のint) ずつ読むため、
+// MV_WORD_INTSを割り切る2のべき乗であること。既定ではAのポートを毎サイクル1ワードで使い切る。
+#ifndef MV_UNROLL
+#define MV_UNROLL 16
+#endif
+
+static_assert(MV_UNROLL <= MV_WORD_INTS && MV_WORD_INTS % MV_UNROLL == 0, "MV_UNROLL must divide MV_WORD_INTS");
+
+typedef ap_uint<512> mv_word_t;
+
+// Aを先頭から512ビットずつ連続に読み、ベクトルごとに1回、ストリームへ流す。
+// 各回の最後に0のワードを2つ足す (mv_computeは常に次のワードまで先読みするため)。
+static void mv_read_a(const mv_word_t* a, hls::stream<mv_word_t>& words, int rows, int cols, int batch) {
+    const int num_words = mv_num_words(rows, cols);
+    for (int n = 0; n < batch; n++) {
+        for (int w = 0; w < num_words; w++) {
+#pragma HLS PIPELINE II=1
+            words.write(a[w]);
+        }
+        words.write(0);
+        words.write(0);
+    }
+}
+
+// Aのワード列を行ごとのMV_UNROLL要素に切り直し、xと積和する。
+// 行の先頭はワードの境界に揃っていないため、連続する2ワード (cur, next) の窓からoffの位置の要素を取り出す。
+// 全行の反復を1つのループにまとめ、行の終わりでもパイプラインを止めずにレーンを合計してyに書く。
+template <typename Events>
+static void mv_compute(hls::stream<mv_word_t>& words, const int* x, int* y, int rows, int cols, int batch,
+                       Events& events) {
+    int x_local[MV_MAX_COLS];
+#pragma HLS ARRAY_PARTITION variable=x_local cyclic factor=MV_UNROLL
+
+    const int num_words = mv_num_words(rows, cols);
+    // 1行あたりの反復数。cols == 0 でも各行を1回回してyに0を書く
+    const int chunks = cols > 0 ? (cols + MV_UNROLL - 1) / MV_UNROLL : 1;
+
+    for (int n = 0; n < batch; n++) {
+        const int* x_n = x + (long)n * cols;
+        int* y_n = y + (long)n * rows;
+
+        kernel_profile_mark(events, KERNEL_PROFILE_START);
+        for (int j = 0; j < cols; j++) {
+#pragma HLS PIPELINE II=1
+            x_local[j] = x_n[j];
+        }
+        kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+
+        mv_word_t cur = words.read();
+        mv_word_t next = words.read();
+        int consumed = 2;
+        int off = 0;  // curの中での現在の要素の位置
+        int i = 0;
+        int k = 0;
+        int lanes[MV_UNROLL];
+#pragma HLS ARRAY_PARTITION variable=lanes complete
+        for (int l = 0; l < MV_UNROLL; l++) {
+#pragma HLS UNROLL
+            lanes[l] = 0;
+        }
+
+        const long total = (long)rows * chunks;
+        for (long t = 0; t < total; t++) {
+#pragma HLS PIPELINE II=1
+            // 1回の反復で進むのは高々MV_UNROLL <= MV_WORD_INTS要素なので、ずらすのは高々1ワード
+            if (off >= MV_WORD_INTS) {
+                cur = next;
+                next = words.read();
+                consumed++;
+                off -= MV_WORD_INTS;
+            }
+            for (int l = 0; l < MV_UNROLL; l++) {
+#pragma HLS UNROLL
+                int e = off + l;
+                int value = e < MV_WORD_INTS ? (int)cur.range(e * 32 + 31, e * 32)
+                                             : (int)next.range((e - MV_WORD_INTS) * 32 + 31, (e - MV_WORD_INTS) * 32);
+                int j = k * MV_UNROLL + l;
+                if (j < cols) {
+                    lanes[l] += value * x_local[j];
+                }
+            }
+            if (k == chunks - 1) {
+                int sum = 0;
+                for (int l = 0; l < MV_UNROLL; l++) {
+#pragma HLS UNROLL
+                    sum += lanes[l];
+                    lanes[l] = 0;
+                }
+                y_n[i] = sum;
+                off += cols - k * MV_UNROLL;
+                i++;
+                k = 0;
+            } else {
+                off += MV_UNROLL;
+                k++;
+            }
+        }
+
+        // 先読みの分だけ残ったワードを捨て、次のベクトルの先頭に合わせる
+        for (; consumed < num_words + 2; consumed++) {
+#pragma HLS PIPELINE II=1
+            words.read();
+        }
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+}
+
+// y = A * x。A (rows x cols, 行優先) は512ビットのワードとして先頭から連続に読み出し、xはBRAMに保持する。
+// 各行はMV_UNROLL本の部分和レーンに並列に積和し、行の終わりでレーンを合計する。
+// batch個のベクトルを1回の起動で続けて計算する。n番目は x + n * cols、y + n * rows を使い、Aは共有する
+// (DDRに置いたままのAに、呼び出しごとのxだけを転送して掛ける)。colsはMV_MAX_COLS以下であること。
+// Aの最後のワードはrows * cols以降も読むため、Aのバッファは64バイト単位に切り上げておく (mv_pack.h)。
+// mv (mv.cpp) と計測版 mv_prof (mv_prof.cpp) が共有する本体。計測版では、ベクトルごとにxの読み込みをstart、行ごとの積和とyの書き込みをcomputeとして数える。
+template <typename Events>
+static void mv_body(const mv_word_t* a, const int* x, int* y, int rows, int cols, int batch, Events& events) {
+    hls::stream<mv_word_t> words;
+#pragma HLS STREAM variable=words depth=64
+#pragma HLS DATAFLOW
+    mv_read_a(a, words, rows, cols, batch);
+    mv_compute(words, x, y, rows, cols, batch, events);
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "ap_int.h"
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装
+extern "C" void mv(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch);
+extern "C" void mv_prof(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch, unsigned long long* prof);
+
+static xrt_fake::kernel_registrar register_mv("mv", mv);
+static xrt_fake::kernel_registrar register_mv_prof("mv_prof", mv_prof);
@@ -13,44 +13,82 @@
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
 #include <chrono>
+#include <cstring>
+
+#include "bo_array.h"
+#include "bo_pool.h"
+#include "cpu_backend.h"
+#include "device_array_bo.h"
+#include "device_array_py.h"
+#include "mv_pack.h"
+#include "phase_timer_py.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
 
 namespace py = pybind11;
 
 class MVRunner {
 public:
-    MVRunner(const std::string& xclbin_path, const std::string& kernel_name) {
-        device_ = xrt::device(0); 
-        auto uuid = device_.load_xclbin(xclbin_path);
-        krnl_ = xrt::kernel(device_, uuid, kernel_name);
-    }
+    // DDRに置いたままにする行列A (重み)。upload()で1回だけ転送し、run_resident()で何度でも使う。
+    struct ResidentMatrix {
+        xrt::bo bo;
+        int rows;
+        int cols;
+    };
+
+    // このランナーがsyncで転送したバイト数と回数
+    struct TransferStats {
+        uint64_t bytes_to_device = 0;
+        uint64_t bytes_from_device = 0;
+        uint64_t syncs = 0;
+    };
+
+    MVRunner(const std::string& xclbin_path, const std::string& kernel_name)
+        : context_(XrtContext::get(xclbin_path)), device_(context_->device()), krnl_(context_->kernel(kernel_name)),
+          launch_(krnl_), pool_(device_) {}
 
-    std::vector<int> run(const std::vector<int>& vec_a, const std::vector<int>& vec_x, int matrix_size) {
-        int matrix_total_size = matrix_size * matrix_size;
-        if (vec_a.size() != matrix_total_size || vec_x.size() != matrix_size) {
+    std::vector<int> run(const std::vector<int>& vec_a, const std::vector<int>& vec_x, int rows, int cols) {
+        size_t matrix_total_size = static_cast<size_t>(rows) * cols;
+        if (vec_a.size() != matrix_total_size || vec_x.size() != cols) {
             throw std::runtime_error("Input vector sizes do not match the specified matrix and vector sizes.");
         }
+        check_shape(rows, cols);
 
+        PhaseTimer& timer = *phases_;
         auto start_total = std::chrono::high_resolution_clock::now();
 
-        auto bo_a = xrt::bo(device_, matrix_total_size * sizeof(int), krnl_.group_id(0));
-        auto bo_x = xrt::bo(device_, matrix_size * sizeof(int), krnl_.group_id(1));
-        auto bo_y = xrt::bo(device_, matrix_size * sizeof(int), krnl_.group_id(2));
+        // BOはプールから取る。同じ形の呼び出しが続けば前回と同じBOが返るため、launch_ (ReusableRun) は
+        // BO引数のset_argを省ける。カーネルはAを最後のワードまで読むため、Aは64バイト単位に切り上げて取る (mv_pack.h)。
+        const size_t a_bytes = matrix_total_size * sizeof(int);
+        const size_t x_bytes = cols * sizeof(int);
+        const size_t y_bytes = rows * sizeof(int);
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        auto buf_a = pool_.acquire(mv_padded_size(rows, cols) * sizeof(int), krnl_.group_id(0));
+        auto buf_x = pool_.acquire(x_bytes, krnl_.group_id(1));
+        auto buf_y = pool_.acquire(y_bytes, krnl_.group_id(2));
+        alloc.stop();
+        xrt::bo& bo_a = buf_a.bo();
+        xrt::bo& bo_x = buf_x.bo();
+        xrt::bo& bo_y = buf_y.bo();
 
-        bo_a.write(vec_a.data());
-        bo_x.write(vec_x.data());
-        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_x.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        PhaseTimer::Scope write(timer, Phase::write);
+        bo_a.write(vec_a.data(), a_bytes, 0);
+        bo_x.write(vec_x.data(), x_bytes, 0);
+        write.stop();
+        sync_to_device(bo_a, a_bytes);
+        sync_to_device(bo_x, x_bytes);
 
         auto start_kernel = std::chrono::high_resolution_clock::now();
-        auto kernel_run = krnl_(bo_a, bo_x, bo_y, matrix_size);
-        kernel_run.wait();
+        launch_and_wait(bo_a, bo_x, bo_y, rows, cols, 1);
         auto end_kernel = std::chrono::high_resolution_clock::now();
 
         kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
 
-        bo_y.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        std::vector<int> vec_result(matrix_size);
-        bo_y.read(vec_result.data());
+        sync_from_device(bo_y, y_bytes);
+        PhaseTimer::Scope read(timer, Phase::read);
+        std::vector<int> vec_result(rows);
+        bo_y.read(vec_result.data(), y_bytes, 0);
+        read.stop();
 
         auto end_total = std::chrono::high_resolution_clock::now();
         total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
@@ -58,6 +96,127 @@ public:
         return vec_result;
     }
 
+    // Aを1回だけ転送し、DDRに置いたままにする。ハンドルが破棄されるまでBOを保持する。
+    std::shared_ptr<const ResidentMatrix> upload(const int* a, int rows, int cols) {
+        check_shape(rows, cols);
+        size_t bytes = static_cast<size_t>(rows) * cols * sizeof(int);
+        PhaseTimer::Scope alloc(*phases_, Phase::alloc);
+        auto matrix = std::make_shared<ResidentMatrix>(ResidentMatrix{xrt::bo(device_, bytes, krnl_.group_id(0)), rows, cols});
+        alloc.stop();
+        PhaseTimer::Scope write(*phases_, Phase::write);
+        matrix->bo.write(a, bytes, 0);
+        write.stop();
+        sync_to_device(matrix->bo, bytes);
+        return matrix;
+    }
+
+    // y (batch x rows) = A * x (batch x cols)。Aは常駐のBOを使い、転送はxとyだけ。
+    // batch個のベクトルは1回の起動で計算する。
+    void run_resident(const ResidentMatrix& matrix, const int* x, int* y, int batch) {
+        if (batch <= 0) {
+            throw std::runtime_error("Batch size must be positive.");
+        }
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        size_t x_bytes = static_cast<size_t>(batch) * matrix.cols * sizeof(int);
+        size_t y_bytes = static_cast<size_t>(batch) * matrix.rows * sizeof(int);
+        PhaseTimer& timer = *phases_;
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        auto buf_x = pool_.acquire(x_bytes, krnl_.group_id(1));
+        auto buf_y = pool_.acquire(y_bytes, krnl_.group_id(2));
+        alloc.stop();
+        PhaseTimer::Scope write(timer, Phase::write);
+        buf_x.bo().write(x, x_bytes, 0);
+        write.stop();
+        sync_to_device(buf_x.bo(), x_bytes);
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        launch_and_wait(matrix.bo, buf_x.bo(), buf_y.bo(), matrix.rows, matrix.cols, batch);
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        sync_from_device(buf_y.bo(), y_bytes);
+        PhaseTimer::Scope read(timer, Phase::read);
+        buf_y.bo().read(y, y_bytes, 0);
+        read.stop();
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    // カード上の配列どうしのy = A * x。xが (batch, cols) ならyは (batch, rows) で、1回の起動で計算する。
+    // 転送は行わず、yもカード上に置いたまま返す。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& x) {
+        xrt::bo& bo_a = device_bo(a, device_index());
+        xrt::bo& bo_x = device_bo(x, device_index());
+        int rows = static_cast<int>(a.shape()[0]);
+        int cols = static_cast<int>(a.shape()[1]);
+        int batch = x.ndim() == 2 ? static_cast<int>(x.shape()[0]) : 1;
+        std::vector<size_t> y_shape = x.ndim() == 2 ? std::vector<size_t>{x.shape()[0], a.shape()[0]} : std::vector<size_t>{a.shape()[0]};
+        PhaseTimer::Scope alloc(*phases_, Phase::alloc);
+        DeviceArray y = device_array(device_, device_index(), krnl_.group_id(2), y_shape, DType::int32);
+        alloc.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        launch_and_wait(bo_a, bo_x, device_bo(y, device_index()), rows, cols, batch);
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+        total_execution_time_ms_ = kernel_execution_time_ms_;
+        return y;
+    }
+
+    // srcをカードへ転送してDeviceArrayにする。行列 (rows, cols) もベクトルも引数0のメモリに置く。
+    DeviceArray to_device(const int* src, const std::vector<size_t>& shape) {
+        DeviceArray array = device_array(device_, device_index(), krnl_.group_id(0), shape, DType::int32, src);
+        count(&transfers_.bytes_to_device, array.bytes());
+        return array;
+    }
+
+    unsigned int device_index() const { return context_->device_index(); }
+
+    void allocate_mapped(int rows, int cols) {
+        check_shape(rows, cols);
+        mapped_a_ = std::make_shared<MappedBo<int>>(device_, static_cast<size_t>(rows) * cols, krnl_.group_id(0));
+        mapped_x_ = std::make_shared<MappedBo<int>>(device_, cols, krnl_.group_id(1));
+        mapped_y_ = std::make_shared<MappedBo<int>>(device_, rows, krnl_.group_id(2));
+        mapped_rows_ = rows;
+        mapped_cols_ = cols;
+    }
+
+    void run_mapped() {
+        if (!mapped_a_) {
+            throw std::runtime_error("Mapped buffers are not allocated.");
+        }
+
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope h2d(*phases_, Phase::sync_to_device);
+        mapped_a_->to_device();
+        mapped_x_->to_device();
+        h2d.stop();
+        count(&transfers_.bytes_to_device, mapped_a_->bytes());
+        count(&transfers_.bytes_to_device, mapped_x_->bytes());
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        launch_and_wait(mapped_a_->bo(), mapped_x_->bo(), mapped_y_->bo(), mapped_rows_, mapped_cols_, 1);
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(*phases_, Phase::sync_from_device);
+        mapped_y_->from_device();
+        d2h.stop();
+        count(&transfers_.bytes_from_device, mapped_y_->bytes());
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+    }
+
+    const std::shared_ptr<MappedBo<int>>& mapped_a() const { return mapped_a_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_x() const { return mapped_x_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_y() const { return mapped_y_; }
+
     double get_kernel_execution_time_ms() const {
         return kernel_execution_time_ms_;
     }
@@ -66,17 +225,93 @@ public:
         return total_execution_time_ms_;
     }
 
+    const TransferStats& transfer_stats() const {
+        return transfers_;
+    }
+
+    // 同期実行で使い回すrun (起動回数とset_argの回数を数えている)
+    const ReusableRun& launcher() const {
+        return launch_;
+    }
+
+    void share_phase_timer(std::shared_ptr<PhaseTimer> timer) {
+        phases_ = std::move(timer);
+    }
+
+    // CPUバックエンドも同じ形の制約に従う
+    static void check_shape(int rows, int cols) {
+        if (rows <= 0 || cols <= 0) {
+            throw std::runtime_error("Matrix dimensions must be positive.");
+        }
+        if (cols > MV_MAX_COLS) {
+            throw std::runtime_error("Number of columns exceeds MV_MAX_COLS.");
+        }
+    }
+
 private:
+    void sync_to_device(xrt::bo& bo, size_t bytes) {
+        PhaseTimer::Scope scope(*phases_, Phase::sync_to_device);
+        bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        count(&transfers_.bytes_to_device, bytes);
+    }
+
+    void sync_from_device(xrt::bo& bo, size_t bytes) {
+        PhaseTimer::Scope scope(*phases_, Phase::sync_from_device);
+        bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        count(&transfers_.bytes_from_device, bytes);
+    }
+
+    // 起動 (引数の設定と開始) と完了待ちを別のフェーズとして記録する
+    void launch_and_wait(const xrt::bo& a, const xrt::bo& x, const xrt::bo& y, int rows, int cols, int batch) {
+        PhaseTimer::Scope launch(*phases_, Phase::launch);
+        auto& kernel_run = launch_(a, x, y, rows, cols, batch);
+        launch.stop();
+        PhaseTimer::Scope wait(*phases_, Phase::wait);
+        kernel_run.wait();
+    }
+
+    void count(uint64_t* direction, size_t bytes) {
+        *direction += bytes;
+        transfers_.syncs++;
+    }
+
+    std::shared_ptr<XrtContext> context_;
     xrt::device device_;
     xrt::kernel krnl_;
+    ReusableRun launch_; // 同期実行の経路で使い回すrun
+    BOPool pool_; // run()の入出力とrun_resident()のxとyのBO
+    std::shared_ptr<MappedBo<int>> mapped_a_;
+    std::shared_ptr<MappedBo<int>> mapped_x_;
+    std::shared_ptr<MappedBo<int>> mapped_y_;
+    int mapped_rows_ = 0;
+    int mapped_cols_ = 0;
+    TransferStats transfers_;
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();
     double kernel_execution_time_ms_ = 0.0;
     double total_execution_time_ms_ = 0.0;
 };
 
+// upload()が返す常駐行列のハンドル。FPGAではDDR上のBO、CPUバックエンドではホストのコピーを持つ。
+struct PyResidentMatrix {
+    const void* owner;  // 作ったPyMVRunner
+    std::shared_ptr<const MVRunner::ResidentMatrix> device;
+    py::array_t<int> host;
+    int rows;
+    int cols;
+};
+
+// backendは "auto" (既定、FPGAを開けなければCPU)、"fpga"、"cpu"。CPUバックエンドでもPythonからの使い方は同じ。
 class PyMVRunner {
 public:
-    PyMVRunner(const std::string& xclbin_path) 
-        : runner_(xclbin_path, "mv") {}
+    PyMVRunner(const std::string& xclbin_path, const std::string& backend)
+        : backend_(select_backend(backend, [&] {
+              runner_.reset(new MVRunner(xclbin_path, "mv"));
+              runner_->share_phase_timer(phases_);
+          })) {}
+
+    std::string backend() const {
+        return backend_name(backend_);
+    }
 
     py::array_t<int> run(py::array_t<int, py::array::c_style | py::array::forcecast> a,
                          py::array_t<int, py::array::c_style | py::array::forcecast> x) {
@@ -84,58 +319,254 @@ public:
             throw std::runtime_error("Input matrix must be 2-dimensional and vector must be 1-dimensional.");
         }
         
-        auto a_shape = a.shape();
-        auto x_shape = x.shape();
+        int rows = a.shape(0);
+        int cols = a.shape(1);
         
-        if (a_shape[0] != 32 || a_shape[1] != 32 || x_shape[0] != 32) {
-            throw std::runtime_error("Input matrix must be 32x32 and vector must be of length 32.");
+        if (x.shape(0) != cols) {
+            throw std::runtime_error("Vector length must match the number of matrix columns.");
+        }
+
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            MVRunner::check_shape(rows, cols);
+            py::array_t<int> result_array(rows);
+            timed_cpu([&] { cpu_gemv(a.data(), x.data(), result_array.mutable_data(), rows, cols); });
+            return result_array;
         }
         
-        int matrix_size = 32;
-        int matrix_total_size = matrix_size * matrix_size;
-        
-        std::vector<int> vec_a(matrix_total_size);
-        std::vector<int> vec_x(matrix_size);
+        // BOへの書き込み (write) はランナーが記録するので、ここでのコピーはfrom_numpyとして分ける
+        PhaseTimer::Scope from_numpy(*phases_, Phase::from_numpy);
+        std::vector<int> vec_a(a.data(), a.data() + a.size());
+        std::vector<int> vec_x(x.data(), x.data() + cols);
+        from_numpy.stop();
+
+        std::vector<int> vec_result = runner_->run(vec_a, vec_x, rows, cols);
+
+        PhaseTimer::Scope numpy(*phases_, Phase::to_numpy);
+        py::array_t<int> result_array(rows);
+        std::memcpy(result_array.mutable_data(), vec_result.data(), rows * sizeof(int));
         
-        for (int i = 0; i < matrix_size; i++) {
-            vec_x[i] = *x.data(i);
-            for (int j = 0; j < matrix_size; j++) {
-                vec_a[i * matrix_size + j] = *a.data(i, j);
-            }
-        }
+        return result_array;
+    }
 
-        std::vector<int> vec_result = runner_.run(vec_a, vec_x, matrix_size);
+    PyResidentMatrix upload(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 2) {
+            throw std::runtime_error("Input matrix must be 2-dimensional.");
+        }
+        int rows = a.shape(0);
+        int cols = a.shape(1);
+        MVRunner::check_shape(rows, cols);
+        PyResidentMatrix matrix{this, nullptr, py::array_t<int>(), rows, cols};
+        if (runner_) {
+            matrix.device = runner_->upload(a.data(), rows, cols);
+        } else {
+            matrix.host = py::array_t<int>({rows, cols});
+            std::memcpy(matrix.host.mutable_data(), a.data(), static_cast<size_t>(rows) * cols * sizeof(int));
+        }
+        return matrix;
+    }
 
-        py::array_t<int> result_array(matrix_size);
-        for (int i = 0; i < matrix_size; i++) {
-            *result_array.mutable_data(i) = vec_result[i];
+    // xが1次元 (cols) ならy (rows)、2次元 (batch, cols) ならy (batch, rows) を返す
+    py::array_t<int> run_resident(const PyResidentMatrix& matrix,
+                                  py::array_t<int, py::array::c_style | py::array::forcecast> x) {
+        if (matrix.owner != this) {
+            throw std::runtime_error("The resident matrix was uploaded by a different runner.");
         }
-        
+        if ((x.ndim() != 1 && x.ndim() != 2) || x.shape(x.ndim() - 1) != matrix.cols) {
+            throw std::runtime_error("x must be (cols,) or (batch, cols) with cols matching the resident matrix.");
+        }
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        int batch = x.ndim() == 2 ? x.shape(0) : 1;
+        py::array_t<int> result_array = x.ndim() == 2 ? py::array_t<int>({batch, matrix.rows}) : py::array_t<int>(matrix.rows);
+        if (!runner_) {
+            timed_cpu([&] {
+                for (int n = 0; n < batch; n++) {
+                    cpu_gemv(matrix.host.data(), x.data() + static_cast<size_t>(n) * matrix.cols,
+                             result_array.mutable_data() + static_cast<size_t>(n) * matrix.rows, matrix.rows, matrix.cols);
+                }
+            });
+            return result_array;
+        }
+        runner_->run_resident(*matrix.device, x.data(), result_array.mutable_data(), batch);
         return result_array;
     }
 
+    // A (rows, cols) とx (cols,) または (batch, cols) のDeviceArrayからyをDeviceArrayで返す
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& x) {
+        a.expect(DType::int32, 2, "a");
+        if (x.dtype() != DType::int32 || (x.ndim() != 1 && x.ndim() != 2) || x.shape().back() != a.shape()[1]) {
+            throw std::runtime_error("x must be an int32 DeviceArray of shape (cols,) or (batch, cols) matching the matrix.");
+        }
+        int rows = static_cast<int>(a.shape()[0]);
+        int cols = static_cast<int>(a.shape()[1]);
+        MVRunner::check_shape(rows, cols);
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            size_t batch = x.ndim() == 2 ? x.shape()[0] : 1;
+            std::vector<size_t> y_shape = x.ndim() == 2 ? std::vector<size_t>{batch, a.shape()[0]} : std::vector<size_t>{a.shape()[0]};
+            DeviceArray y = DeviceArray::host(y_shape, DType::int32);
+            timed_cpu([&] {
+                for (size_t n = 0; n < batch; n++) {
+                    cpu_gemv(a.host_data<int>(), x.host_data<int>() + n * cols, y.host_data<int>() + n * rows, rows, cols);
+                }
+            });
+            return y;
+        }
+        py::gil_scoped_release release;
+        return runner_->run_device(a, x);
+    }
+
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1 && a.ndim() != 2) {
+            throw std::runtime_error("Input array must be 1- or 2-dimensional.");
+        }
+        if (!runner_) {
+            return host_device_array(a);
+        }
+        return runner_->to_device(a.data(), array_shape(a));
+    }
+
+    py::tuple alloc_inputs(int rows, int cols) {
+        if (!runner_) {
+            MVRunner::check_shape(rows, cols);
+            cpu_a_ = py::array_t<int>({rows, cols});
+            cpu_x_ = py::array_t<int>(cols);
+            cpu_y_ = py::array_t<int>(rows);
+            cpu_mapped_ = true;
+            return py::make_tuple(cpu_a_, cpu_x_);
+        }
+        runner_->allocate_mapped(rows, cols);
+        return py::make_tuple(bo_array(runner_->mapped_a(), {rows, cols}), bo_array(runner_->mapped_x(), {cols}));
+    }
+
+    py::array_t<int> run_mapped() {
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            if (!cpu_mapped_) {
+                throw std::runtime_error("Mapped buffers are not allocated.");
+            }
+            timed_cpu([&] {
+                cpu_gemv(cpu_a_.data(), cpu_x_.data(), cpu_y_.mutable_data(), cpu_a_.shape(0), cpu_a_.shape(1));
+            });
+            return cpu_y_;
+        }
+        runner_->run_mapped();
+        return bo_array(runner_->mapped_y(), {static_cast<py::ssize_t>(runner_->mapped_y()->size())});
+    }
+
     double get_kernel_execution_time_ms() const {
-        return runner_.get_kernel_execution_time_ms();
+        return runner_ ? runner_->get_kernel_execution_time_ms() : cpu_time_ms_;
     }
 
     double get_total_execution_time_ms() const {
-        return runner_.get_total_execution_time_ms();
+        return runner_ ? runner_->get_total_execution_time_ms() : cpu_time_ms_;
+    }
+
+    // CPUバックエンドでは転送がないため0
+    // 同期実行のrunの起動回数とset_argの回数。同じ形の呼び出しが続けばset_argは増えない (CPUバックエンドでは0)
+    py::dict get_launch_stats() const {
+        py::dict d;
+        d["launches"] = runner_ ? runner_->launcher().launches() : 0;
+        d["set_arg_calls"] = runner_ ? runner_->launcher().set_arg_calls() : 0;
+        return d;
+    }
+
+    py::dict get_transfer_stats() const {
+        MVRunner::TransferStats stats = runner_ ? runner_->transfer_stats() : MVRunner::TransferStats();
+        py::dict d;
+        d["bytes_to_device"] = stats.bytes_to_device;
+        d["bytes_from_device"] = stats.bytes_from_device;
+        d["syncs"] = stats.syncs;
+        return d;
+    }
+
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(*phases_);
+    }
+
+    void reset_phase_stats() {
+        phases_->reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        phases_->set_enabled(enabled);
     }
 
 private:
-    MVRunner runner_;
+    // CPUバックエンドでは転送がないため、カーネル時間と合計時間は同じ値になる
+    template <typename Fn>
+    void timed_cpu(Fn fn) {
+        auto start = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+        fn();
+        cpu.stop();
+        auto end = std::chrono::high_resolution_clock::now();
+        cpu_time_ms_ = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();
+    std::unique_ptr<MVRunner> runner_;  // CPUバックエンドのときはnull
+    Backend backend_;
+    py::array_t<int> cpu_a_, cpu_x_, cpu_y_;  // CPUバックエンドのalloc_inputs()の配列
+    bool cpu_mapped_ = false;
+    double cpu_time_ms_ = 0.0;
 };
 
 PYBIND11_MODULE(libmv_module_hw, m) {
     m.doc() = "pybind11 wrapper for MVRunner (Hardware)";
+    register_device_array(m);
+
+    py::class_<PyResidentMatrix>(m, "ResidentMatrix")
+        .def_readonly("rows", &PyResidentMatrix::rows)
+        .def_readonly("cols", &PyResidentMatrix::cols);
 
     py::class_<PyMVRunner>(m, "MVRunner")
-        .def(py::init<const std::string&>())
+        .def(py::init<const std::string&, const std::string&>(),
+             py::arg("xclbin_path"), py::arg("backend") = "auto",
+             "backend is \"auto\" (FPGA if the device and xclbin open, otherwise the SIMD multithreaded CPU backend), "
+             "\"fpga\" or \"cpu\".")
+        .def("backend", &PyMVRunner::backend,
+             "Returns the backend selected at construction (\"fpga\" or \"cpu\").")
+        .def("run", &PyMVRunner::run_device,
+             py::arg("a"), py::arg("x"),
+             "Multiplies an int32 DeviceArray matrix (rows x cols) by a DeviceArray x of shape (cols,) or (batch, cols) "
+             "and returns y as a DeviceArray without transferring anything to the host.")
         .def("run", &PyMVRunner::run,
              py::arg("a"), py::arg("x"),
-             "Runs the mv kernel with a numpy matrix (32x32) and vector (32) and returns the result as a numpy vector.")
+             "Runs the mv kernel with a numpy matrix (rows x cols) and vector (cols) and returns the result as a numpy vector.")
+        .def("to_device", &PyMVRunner::to_device,
+             py::arg("a"),
+             "Transfers a 1-D or 2-D numpy array to the device and returns it as an int32 DeviceArray (host memory on the CPU backend).")
+        .def("upload", &PyMVRunner::upload,
+             py::arg("a"),
+             "Transfers the matrix (rows x cols) to device memory once and returns a ResidentMatrix handle. "
+             "The matrix stays on the device until the handle is released.")
+        .def("run_resident", &PyMVRunner::run_resident,
+             py::arg("matrix"), py::arg("x"),
+             "Multiplies a ResidentMatrix by x of shape (cols,) or (batch, cols) and returns y of shape (rows,) or (batch, rows). "
+             "Only x and y are transferred; a batch of vectors is computed in a single kernel launch.")
+        .def("alloc_inputs", &PyMVRunner::alloc_inputs,
+             py::arg("rows") = 32, py::arg("cols") = 32,
+             "Allocates the input matrix (rows x cols) and vector (cols) directly in device buffer host memory. Fill them in place and call run_mapped().")
+        .def("run_mapped", &PyMVRunner::run_mapped,
+             "Runs the mv kernel on the arrays from alloc_inputs() and returns the output buffer as a numpy vector without copying. "
+             "The returned array is overwritten by the next run_mapped().")
         .def("get_kernel_execution_time_ms", &PyMVRunner::get_kernel_execution_time_ms,
             "Returns the kernel execution time in milliseconds.")
         .def("get_total_execution_time_ms", &PyMVRunner::get_total_execution_time_ms,
-            "Returns the total execution time including data transfers in milliseconds.");
+            "Returns the total execution time including data transfers in milliseconds.")
+        .def("get_launch_stats", &PyMVRunner::get_launch_stats,
+            "Returns {launches, set_arg_calls} for the reused run of the synchronous path. Repeated calls with the same "
+            "shape reuse the same BOs, so set_arg_calls stays flat (all 0 on the CPU backend).")
+        .def("get_transfer_stats", &PyMVRunner::get_transfer_stats,
+            "Returns the bytes transferred to and from the device and the number of DMA syncs issued by this runner "
+            "(all 0 on the CPU backend).")
+        .def("get_phase_stats", &PyMVRunner::get_phase_stats,
+            "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}} "
+            "for the phases recorded so far (upload() counts as alloc, write and sync_to_device).")
+        .def("reset_phase_stats", &PyMVRunner::reset_phase_stats,
+            "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyMVRunner::set_phase_timing,
+            py::arg("enabled"),
+            "Enables or disables per-phase timing (enabled by default).");
 }
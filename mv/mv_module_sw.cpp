@@ -8,9 +8,14 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <cstring>
 #include <vector>
 
-extern "C" void mv(const int* a, const int* x, int* y, int size);
+#include "ap_int.h"
+#include "device_array_py.h"
+#include "mv_pack.h"
+
+extern "C" void mv(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch);
 
 namespace py = pybind11;
 
@@ -24,44 +29,65 @@ public:
             throw std::runtime_error("Input matrix must be 2-dimensional and vector must be 1-dimensional.");
         }
         
-        auto a_shape = np_a.shape();
-        auto x_shape = np_x.shape();
+        int rows = np_a.shape(0);
+        int cols = np_a.shape(1);
         
-        if (a_shape[0] != 32 || a_shape[1] != 32 || x_shape[0] != 32) {
-            throw std::runtime_error("Input matrix must be 32x32 and vector must be of length 32.");
+        if (np_x.shape(0) != cols) {
+            throw std::runtime_error("Vector length must match the number of matrix columns.");
+        }
+        if (cols > MV_MAX_COLS) {
+            throw std::runtime_error("Number of columns exceeds MV_MAX_COLS.");
         }
         
-        int matrix_size = 32;
-        int matrix_total_size = matrix_size * matrix_size;
-        
-        std::vector<int> vec_a(matrix_total_size);
-        std::vector<int> vec_x(matrix_size);
-        std::vector<int> vec_result(matrix_size);
+        // カーネルはAを64バイト単位で読むため、切り上げたワード列へ写してから渡す
+        std::vector<ap_uint<512>> words(mv_num_words(rows, cols));
+        std::memcpy(words.data(), np_a.data(), static_cast<size_t>(rows) * cols * sizeof(int));
+
+        py::array_t<int> result_array(rows);
+        mv(words.data(), np_x.data(), result_array.mutable_data(), rows, cols, 1);
         
-        for (int i = 0; i < matrix_size; i++) {
-            vec_x[i] = *np_x.data(i);
-            for (int j = 0; j < matrix_size; j++) {
-                vec_a[i * matrix_size + j] = *np_a.data(i, j);
-            }
+        return result_array;
+    }
+
+    // ホストメモリのDeviceArrayどうしのy = A * x。xが (batch, cols) ならbatch個をまとめて計算する。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& x) {
+        a.expect(DType::int32, 2, "a");
+        if (x.dtype() != DType::int32 || (x.ndim() != 1 && x.ndim() != 2) || x.shape().back() != a.shape()[1]) {
+            throw std::runtime_error("x must be an int32 DeviceArray of shape (cols,) or (batch, cols) matching the matrix.");
         }
+        if (a.shape()[1] > MV_MAX_COLS) {
+            throw std::runtime_error("Number of columns exceeds MV_MAX_COLS.");
+        }
+        int batch = x.ndim() == 2 ? x.shape()[0] : 1;
+        std::vector<size_t> y_shape = x.ndim() == 2 ? std::vector<size_t>{x.shape()[0], a.shape()[0]} : std::vector<size_t>{a.shape()[0]};
+        DeviceArray y = DeviceArray::host(y_shape, DType::int32);
+        // ホストのDeviceArrayは64バイト単位で確保されるので、そのままワード列として渡せる
+        mv(reinterpret_cast<const ap_uint<512>*>(a.host_data<int>()), x.host_data<int>(), y.host_data<int>(), a.shape()[0], a.shape()[1], batch);
+        return y;
+    }
 
-        mv(vec_a.data(), vec_x.data(), vec_result.data(), matrix_size);
-        
-        py::array_t<int> result_array(matrix_size);
-        for (int i = 0; i < matrix_size; i++) {
-            *result_array.mutable_data(i) = vec_result[i];
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1 && a.ndim() != 2) {
+            throw std::runtime_error("Input array must be 1- or 2-dimensional.");
         }
-        
-        return result_array;
+        return host_device_array(a);
     }
 };
 
 PYBIND11_MODULE(libmv_module_sw, m) {
     m.doc() = "pybind11 wrapper for MV software simulation"; 
+    register_device_array(m);
 
     py::class_<MVSim>(m, "MVSim")
         .def(py::init<>())
+        .def("run", &MVSim::run_device,
+             py::arg("a"), py::arg("x"),
+             "Multiplies an int32 DeviceArray matrix by a DeviceArray x of shape (cols,) or (batch, cols) in host memory "
+             "and returns y as a DeviceArray.")
         .def("run", &MVSim::run,
              py::arg("a"), py::arg("x"),
-             "Runs the mv kernel software simulation with a numpy matrix (32x32) and vector (32) and returns the result as a numpy vector.");
+             "Runs the mv kernel software simulation with a numpy matrix (rows x cols) and vector (cols) and returns the result as a numpy vector.")
+        .def("to_device", &MVSim::to_device,
+             py::arg("a"),
+             "Copies a 1-D or 2-D numpy array into an int32 DeviceArray backed by host memory.");
 }
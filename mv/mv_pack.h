@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstddef>
+
+// mvカーネルはAを512ビットのワード列として読む。ap_uint<512>の下位ビットから順に要素0, 1, ... が入るため、
+// 行優先のint配列をそのままワード列として渡せる。最後のワードはrows * cols以降も読むので、
+// バッファはmv_num_words() ワード分 (64バイト単位) 確保する。XRTのBOはページ単位で確保されるため切り上げは不要。
+
+const int MV_WORD_INTS = 16; // 512ビット1ワードあたりのint数
+
+// カーネルがBRAMに保持するxの最大長 (列数の上限)。ホストのランナーもこの値で列数を検査する。
+#ifndef MV_MAX_COLS
+#define MV_MAX_COLS 16384
+#endif
+
+inline int mv_num_words(int rows, int cols) {
+    return static_cast<int>((static_cast<long>(rows) * cols + MV_WORD_INTS - 1) / MV_WORD_INTS);
+}
+
+// ワード列のint数 (末尾の切り上げを含む)
+inline size_t mv_padded_size(int rows, int cols) {
+    return static_cast<size_t>(mv_num_words(rows, cols)) * MV_WORD_INTS;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "mv_body.h"
+
+// 計測版 (mv_prof)。mvにprof (カーネル内のサイクル数、../common/kernel_profile.h) の出力を加える
+extern "C" void mv_prof(const mv_word_t* a, const int* x, int* y, int rows, int cols, int batch, unsigned long long* prof) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=x offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=y offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=prof offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=rows
+#pragma HLS INTERFACE s_axilite port=cols
+#pragma HLS INTERFACE s_axilite port=batch
+#pragma HLS INTERFACE s_axilite port=return
+
+    KernelProfileEvents events;
+#pragma HLS STREAM variable=events depth=4
+#pragma HLS DATAFLOW
+    mv_body(a, x, y, rows, cols, batch, events);
+    kernel_profile_counter(events, prof);
+}
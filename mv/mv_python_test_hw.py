@@ -1,11 +1,16 @@
 import numpy as np
 import time
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+from bench_record import BenchRecorder
 from libmv_module_hw import MVRunner
 
 MEGA = 1024 * 1024
 
 def test_mv_hw():
-    MATRIX_SIZE = 32
+    MATRIX_SIZE = 4096
     print(f"Running MV hardware test (via Python) with matrix size: {MATRIX_SIZE}x{MATRIX_SIZE} and vector size: {MATRIX_SIZE}")
 
     a = np.random.randint(0, 10, size=(MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
@@ -30,6 +35,8 @@ def test_mv_hw():
         print(f"Error during MVRunner.run (initial): {e}")
         return
 
+    # 同じ形のrun()が続く間はBOとスカラー引数が前回と同じなので、set_argを呼ばずに再起動する
+    launches_before = runner.get_launch_stats()
     for i in range(num_iterations):
         print(f"Iteration {i+1}/{num_iterations}")
         
@@ -48,6 +55,11 @@ def test_mv_hw():
         kernel_times.append(kernel_time_ms)
         total_times.append(total_time_ms)
 
+    if runner.backend() == "fpga":
+        launches = runner.get_launch_stats()
+        assert launches["launches"] - launches_before["launches"] == num_iterations, "One launch per run()."
+        assert launches["set_arg_calls"] == launches_before["set_arg_calls"], "Repeated run() reuses its BOs and arguments."
+
     expected_result = np.matmul(a, x)
 
     if np.array_equal(result_hw, expected_result):
@@ -60,6 +72,51 @@ def test_mv_hw():
         print(f"Max difference: {np.max(diff)}")
         print(f"Mean difference: {np.mean(diff)}")
 
+    # ゼロコピー経路: 入力をBOのホストメモリに直接書き込む
+    a_mapped, x_mapped = runner.alloc_inputs(MATRIX_SIZE, MATRIX_SIZE)
+    a_mapped[:] = a
+    x_mapped[:] = x
+    mapped_total_times = []
+    for i in range(num_iterations):
+        result_mapped = runner.run_mapped()
+        mapped_total_times.append(runner.get_total_execution_time_ms())
+    if not np.array_equal(result_mapped, expected_result):
+        print("Zero-copy result does not match expected result.")
+
+    # 常駐行列: Aは1回だけ転送し、以降の呼び出しはxとyだけを転送する
+    resident = runner.upload(a)
+    before = runner.get_transfer_stats()
+    resident_total_times = []
+    for i in range(num_iterations):
+        result_resident = runner.run_resident(resident, x)
+        resident_total_times.append(runner.get_total_execution_time_ms())
+    assert np.array_equal(result_resident, expected_result), "Resident matrix result does not match expected result."
+    after = runner.get_transfer_stats()
+    if runner.backend() == "fpga":
+        per_call = (after["bytes_to_device"] - before["bytes_to_device"]) / num_iterations
+        assert per_call == MATRIX_SIZE * 4, "Only x is transferred to the device per resident call."
+        assert after["bytes_from_device"] - before["bytes_from_device"] == num_iterations * MATRIX_SIZE * 4
+    print(f"Resident transfer per call: {(after['bytes_to_device'] - before['bytes_to_device']) // num_iterations} bytes to device")
+
+    # 複数のベクトルを1回の起動で掛ける
+    BATCH = 16
+    x_batch = np.random.randint(0, 10, size=(BATCH, MATRIX_SIZE), dtype=np.int32)
+    result_batch = runner.run_resident(resident, x_batch)
+    assert result_batch.shape == (BATCH, MATRIX_SIZE)
+    assert np.array_equal(result_batch, x_batch @ a.T), "Batched resident result does not match expected result."
+    resident_batch_ms = runner.get_total_execution_time_ms()
+
+    # DeviceArray: y = A * xをカード上に置いたまま次の積の入力にし、A * (A * x) の結果だけをホストへ戻す
+    # (要素を0と1にしてint32に収める)
+    a_chain = a % 2
+    a_dev = runner.to_device(a_chain)
+    y_dev = runner.run(a_dev, runner.to_device(x))
+    before = runner.get_transfer_stats()
+    z_dev = runner.run(a_dev, y_dev)
+    if runner.backend() == "fpga":
+        assert runner.get_transfer_stats() == before, "Chained DeviceArray calls transfer nothing."
+    assert np.array_equal(z_dev.to_host(), a_chain @ (a_chain @ x)), "Chained DeviceArray result does not match."
+
     avg_kernel_time_ms = np.mean(kernel_times)
     avg_total_time_ms = np.mean(total_times)
 
@@ -73,6 +130,11 @@ def test_mv_hw():
     print(f"Average total execution time: {avg_total_time_ms:.4f} ms")
     print(f"Throughput (kernel only): {throughput_kernel_mega_ops_per_sec:.2f} M Ops/sec")
     print(f"Throughput (total): {throughput_total_mega_ops_per_sec:.2f} M Ops/sec")
+    print(f"Average zero-copy total execution time: {np.mean(mapped_total_times):.4f} ms")
+    print(f"Average resident matrix total execution time: {np.mean(resident_total_times):.4f} ms")
+    print(f"Resident matrix batch of {BATCH}: {resident_batch_ms:.4f} ms")
+    phases = runner.get_phase_stats()
+    print(f"Phase latency p50/p99 (us): { {p: (round(s['p50_us'], 1), round(s['p99_us'], 1)) for p, s in phases.items()} }")
     
     print("\n--- Numpy Performance Comparison ---")
     numpy_times = []
@@ -90,6 +152,29 @@ def test_mv_hw():
     print(f"Speedup (kernel vs numpy): {avg_numpy_time_ms / avg_kernel_time_ms:.2f}x")
     print(f"Speedup (total vs numpy): {avg_numpy_time_ms / avg_total_time_ms:.2f}x")
     
+    # CPUバックエンド: 同じAPIをSIMD・複数スレッドのCPU実装で実行する
+    cpu_runner = MVRunner(XCLBIN_FILE, backend="cpu")
+    assert cpu_runner.backend() == "cpu"
+    cpu_times = []
+    for i in range(num_iterations):
+        result_cpu = cpu_runner.run(a, x)
+        cpu_times.append(cpu_runner.get_total_execution_time_ms())
+    assert np.array_equal(result_cpu, expected_result), "CPU backend result does not match expected result."
+    print(f"Average CPU backend execution time: {np.mean(cpu_times):.4f} ms")
+    cpu_resident = cpu_runner.upload(a)
+    assert np.array_equal(cpu_runner.run_resident(cpu_resident, x_batch), x_batch @ a.T), "CPU backend resident result mismatch."
+    cpu_y = cpu_runner.run(cpu_runner.to_device(a), cpu_runner.to_device(x_batch))
+    assert np.array_equal(cpu_y.to_host(), x_batch @ a.T), "CPU backend DeviceArray result mismatch."
+    recorder = BenchRecorder()
+    params = {"rows": MATRIX_SIZE, "cols": MATRIX_SIZE}
+    recorder.add("mv", "mv_python_test_hw", dict(params, phase="kernel"), kernel_times)
+    recorder.add("mv", "mv_python_test_hw", dict(params, phase="total"), total_times)
+    recorder.add("mv", "mv_python_test_hw", dict(params, phase="total_mapped"), mapped_total_times)
+    recorder.add("mv", "mv_python_test_hw", dict(params, phase="total_resident"), resident_total_times)
+    recorder.add("numpy.matmul", "mv_python_test_hw", params, numpy_times)
+    recorder.add("mv", "mv_python_test_hw", dict(params, phase="total_cpu"), cpu_times)
+    recorder.write()
+
     print("Python HW test completed.")
 
 if __name__ == "__main__":
@@ -28,10 +28,25 @@ def test_mv_sw():
     else:
         print("Test FAILED!")
         print(f"First few elements of simulated result:\n{result_sim[:5]}")
+
+    # 任意サイズ (MV_UNROLLで割り切れない列数と大きな行列を含む)
+    for rows, cols in [(100, 37), (4096, 4096)]:
+        a = np.random.randint(0, 10, size=(rows, cols), dtype=np.int32)
+        x = np.random.randint(0, 10, size=cols, dtype=np.int32)
+        status = "PASSED" if np.array_equal(simulator.run(a, x), np.matmul(a, x)) else "FAILED"
+        print(f"{rows}x{cols}: {status}")
         print(f"First few elements of expected result:\n{expected_result[:5]}")
         diff = np.abs(result_sim - expected_result)
         print(f"Max difference: {np.max(diff)}")
         print(f"Mean difference: {np.mean(diff)}")
 
+    # DeviceArray: (batch, cols) のxをまとめて掛け、結果をそのまま次の積の入力にする
+    a = np.random.randint(-3, 4, size=(MATRIX_SIZE, MATRIX_SIZE), dtype=np.int32)
+    xs = np.random.randint(-3, 4, size=(4, MATRIX_SIZE), dtype=np.int32)
+    a_dev = simulator.to_device(a)
+    z_dev = simulator.run(a_dev, simulator.run(a_dev, simulator.to_device(xs)))
+    status = "PASSED" if np.array_equal(z_dev.to_host(), xs @ a.T @ a.T) else "FAILED"
+    print(f"DeviceArray chain: {status} ({z_dev})")
+
 if __name__ == "__main__":
     test_mv_sw()
@@ -9,47 +9,141 @@
 #include <vector>
 #include <cstdlib>
 #include <ctime>
+#include <chrono>
 
-extern "C" void mv(const int* a, const int* x, int* y, int size);
+#include "ap_int.h"
+#include "kernel_profile.h"
+#include "mv_pack.h"
 
-int main() {
-    const int MATRIX_SIZE = 32;
-    const int TOTAL_SIZE = MATRIX_SIZE * MATRIX_SIZE;
-    
-    std::cout << "Running MV software test with matrix size: " << MATRIX_SIZE << "x" << MATRIX_SIZE 
-              << " and vector size: " << MATRIX_SIZE << std::endl;
+extern "C" void mv(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch);
+extern "C" void mv_prof(const ap_uint<512>* a, const int* x, int* y, int rows, int cols, int batch, unsigned long long* prof);
 
-    std::vector<int> a(TOTAL_SIZE);
-    std::vector<int> x(MATRIX_SIZE);
-    std::vector<int> y_hw(MATRIX_SIZE, 0);
-    std::vector<int> y_sw(MATRIX_SIZE, 0);
+// Aをmvカーネルが読むワード列 (64バイト単位に切り上げ) に置き、intの配列として書けるようにする。
+// 切り上げた末尾には乱数を入れ、カーネルがrows * cols以降を無視することも確かめる。
+struct Matrix {
+    Matrix(int rows, int cols) : words(mv_num_words(rows, cols)), size(static_cast<size_t>(rows) * cols) {
+        for (size_t i = size; i < mv_padded_size(rows, cols); ++i) {
+            (*this)[i] = rand();
+        }
+    }
 
-    srand(time(nullptr));
+    int& operator[](size_t i) { return reinterpret_cast<int*>(words.data())[i]; }
+    const ap_uint<512>* data() const { return words.data(); }
 
-    for (int i = 0; i < TOTAL_SIZE; ++i) {
+    std::vector<ap_uint<512>> words;
+    size_t size;
+};
+
+bool test_shape(int rows, int cols) {
+    std::cout << "Running MV software test with matrix size: " << rows << "x" << cols
+              << " and vector size: " << cols << std::endl;
+
+    Matrix a(rows, cols);
+    std::vector<int> x(cols);
+    std::vector<int> y_hw(rows, 0);
+    std::vector<int> y_sw(rows, 0);
+
+    for (size_t i = 0; i < a.size; ++i) {
         a[i] = rand() % 10; // Small values to avoid overflow
     }
-    for (int i = 0; i < MATRIX_SIZE; ++i) {
+    for (int i = 0; i < cols; ++i) {
         x[i] = rand() % 10;
     }
 
-    for (int i = 0; i < MATRIX_SIZE; ++i) {
+    for (int i = 0; i < rows; ++i) {
         y_sw[i] = 0;
-        for (int j = 0; j < MATRIX_SIZE; ++j) {
-            y_sw[i] += a[i * MATRIX_SIZE + j] * x[j];
+        for (int j = 0; j < cols; ++j) {
+            y_sw[i] += a[static_cast<size_t>(i) * cols + j] * x[j];
         }
     }
 
-    mv(a.data(), x.data(), y_hw.data(), MATRIX_SIZE);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    mv(a.data(), x.data(), y_hw.data(), rows, cols, 1);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::cout << "Kernel (C simulation) time: "
+              << std::chrono::duration<double, std::milli>(end_time - start_time).count() << " ms" << std::endl;
 
-    bool match = true;
-    for (int i = 0; i < MATRIX_SIZE; ++i) {
+    for (int i = 0; i < rows; ++i) {
         if (y_hw[i] != y_sw[i]) {
             std::cerr << "Mismatch at index " << i << ": HW=" << y_hw[i] << ", SW=" << y_sw[i] << std::endl;
-            match = false;
-            break;
+            return false;
+        }
+    }
+    return true;
+}
+
+// batch個のベクトルを1回の呼び出しで掛けた結果が、1個ずつ掛けた結果と一致する
+bool test_batch(int rows, int cols, int batch) {
+    std::cout << "Running MV batch test: " << rows << "x" << cols << " with " << batch << " vectors" << std::endl;
+
+    Matrix a(rows, cols);
+    std::vector<int> x(static_cast<size_t>(batch) * cols);
+    std::vector<int> y_batch(static_cast<size_t>(batch) * rows, 0);
+    std::vector<int> y_one(rows, 0);
+    for (size_t i = 0; i < a.size; ++i) {
+        a[i] = rand() % 10;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = rand() % 10;
+    }
+
+    mv(a.data(), x.data(), y_batch.data(), rows, cols, batch);
+    for (int n = 0; n < batch; ++n) {
+        mv(a.data(), x.data() + static_cast<size_t>(n) * cols, y_one.data(), rows, cols, 1);
+        for (int i = 0; i < rows; ++i) {
+            if (y_batch[static_cast<size_t>(n) * rows + i] != y_one[i]) {
+                std::cerr << "Batch mismatch at vector " << n << ", index " << i << std::endl;
+                return false;
+            }
         }
     }
+    return true;
+}
+
+// 計測版mv_profの結果がmvと一致し、xの読み込み (start) と積和 (compute) のサイクル数がバッチ全体で積まれる
+bool test_prof(int rows, int cols, int batch) {
+    Matrix a(rows, cols);
+    std::vector<int> x(static_cast<size_t>(batch) * cols);
+    std::vector<int> y(static_cast<size_t>(batch) * rows, 0);
+    std::vector<int> y_prof(static_cast<size_t>(batch) * rows, 0);
+    for (size_t i = 0; i < a.size; ++i) {
+        a[i] = rand() % 10;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = rand() % 10;
+    }
+    unsigned long long prof[KERNEL_PROFILE_WORDS] = {};
+    mv(a.data(), x.data(), y.data(), rows, cols, batch);
+    mv_prof(a.data(), x.data(), y_prof.data(), rows, cols, batch, prof);
+    if (y_prof != y) {
+        std::cerr << "mv_prof result differs from mv" << std::endl;
+        return false;
+    }
+    if (!kernel_profile_consistent(prof) || prof[KERNEL_PROFILE_COMPUTE] == 0 ||
+        prof[KERNEL_PROFILE_COMPUTE] < prof[KERNEL_PROFILE_START]) {
+        std::cerr << "Unexpected profile: start " << prof[KERNEL_PROFILE_START] << ", compute "
+                  << prof[KERNEL_PROFILE_COMPUTE] << ", total " << prof[KERNEL_PROFILE_TOTAL] << " cycles" << std::endl;
+        return false;
+    }
+    KernelProfile p = kernel_profile_decode(prof);
+    std::cout << "mv_prof (" << rows << "x" << cols << ", batch " << batch << "): start " << p.us[KERNEL_PROFILE_START]
+              << " us, compute " << p.us[KERNEL_PROFILE_COMPUTE] << " us" << std::endl;
+    return true;
+}
+
+int main() {
+    srand(time(nullptr));
+
+    bool match = true;
+    match &= test_shape(32, 32);
+    match &= test_shape(1, 1);
+    match &= test_shape(100, 37);  // MV_UNROLLで割り切れない列数
+    match &= test_shape(50, 3);    // 1ワードに複数の行が入る
+    match &= test_shape(7, 5000);
+    match &= test_shape(4096, 4096);
+    match &= test_batch(100, 37, 5);
+    match &= test_batch(1, 1, 3);
+    match &= test_prof(512, 512, 4);
 
     if (match) {
         std::cout << "Test PASSED!" << std::endl;
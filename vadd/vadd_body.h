@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "kernel_profile_counter.h"
+
+// vadd (vadd.cpp) と計測版 vadd_prof (vadd_prof.cpp) が共有する本体。
+// 読み込み・加算・書き込みが1つのパイプラインに重なるため、計測版ではループ全体をcomputeとして数える。
+template <typename Events>
+static void vadd_body(const int* a, const int* b, int* c, const int size, Events& events) {
+    kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+    for (int i = 0; i < size; i++) {
+#pragma HLS PIPELINE
+        c[i] = a[i] + b[i];
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+}
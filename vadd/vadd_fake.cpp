@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "ap_int.h"
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装
+extern "C" void vadd(const int* a, const int* b, int* c, const int size);
+extern "C" void vadd_prof(const int* a, const int* b, int* c, const int size, unsigned long long* prof);
+extern "C" void vadd_wide(const ap_uint<512>* a, const ap_uint<512>* b, ap_uint<512>* c, const int num_words);
+
+static xrt_fake::kernel_registrar register_vadd("vadd", vadd);
+static xrt_fake::kernel_registrar register_vadd_wide("vadd_wide", vadd_wide);
+static xrt_fake::kernel_registrar register_vadd_prof("vadd_prof", vadd_prof);
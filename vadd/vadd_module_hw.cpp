@@ -1,6 +1,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <algorithm>
 // #include "vadd_host.h" // 削除
 
 // XRT/OpenCL ヘッダー (HWモジュールに必要な場合)
@@ -9,57 +10,38 @@
 #include <xrt/xrt_kernel.h>
 // #include <chrono> // 時間計測用 // 削除
 
-namespace py = pybind11;
-
-class VAddRunner { // PyVAddRunner から VAddRunner にクラス名を変更し、HW実行ロジックを直接持つ
-public:
-    VAddRunner(const std::string& xclbin_path, const std::string& kernel_name) {
-        // XRTデバイスとカーネルの初期化
-        device_ = xrt::device(0); // 0番目のデバイスを使用
-        auto uuid = device_.load_xclbin(xclbin_path);
-        krnl_ = xrt::kernel(device_, uuid, kernel_name);
-    }
-
-    std::vector<int> run(const std::vector<int>& vec_a, const std::vector<int>& vec_b, int size) {
-        if (vec_a.size() != size || vec_b.size() != size) {
-            throw std::runtime_error("Input vector sizes do not match the specified size.");
-        }
-
-        // バッファオブジェクトの作成
-        auto bo_a = xrt::bo(device_, size * sizeof(int), krnl_.group_id(0));
-        auto bo_b = xrt::bo(device_, size * sizeof(int), krnl_.group_id(1));
-        auto bo_c = xrt::bo(device_, size * sizeof(int), krnl_.group_id(2));
-
-        // ホストからデバイスへのデータ転送
-        bo_a.write(vec_a.data());
-        bo_b.write(vec_b.data());
-        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-
-        // カーネル実行
-        auto run = krnl_(bo_a, bo_b, bo_c, size);
-        run.wait();
-
-        // デバイスからホストへのデータ転送
-        bo_c.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        std::vector<int> vec_result(size);
-        bo_c.read(vec_result.data());
+#include "bo_array.h"
+#include "cpu_backend.h"
+#include "device_array_py.h"
+#include "device_group.h"
+#include "phase_timer_py.h"
+#include "vadd_runner.h"
 
-        return vec_result;
-    }
-
-private:
-    xrt::device device_;
-    xrt::kernel krnl_;
-    // double kernel_execution_time_ms_ = 0.0; // 削除
-    // double total_execution_time_ms_ = 0.0; // 削除
-};
+namespace py = pybind11;
 
 // VAddRunnerクラスをPythonに公開するためのラッパークラス
+// backendは "auto" (既定、FPGAを開けなければCPU)、"fpga"、"cpu"。CPUバックエンドでもPythonからの使い方は同じ。
+// num_devices枚 (0はすべて) のカードにxclbinを読み込み、run()はベクトルをカードの数に分けて同時に計算する。
+// それ以外の経路は0番のカードで実行する。
 class PyVAddRunner {
 public:
-    PyVAddRunner(const std::string& xclbin_path)
-        : runner_(xclbin_path, "vadd") {} // カーネル名は"vadd"固定
+    PyVAddRunner(const std::string& xclbin_path, size_t pool_byte_budget, size_t max_in_flight, bool wide,
+                 const std::string& backend, size_t num_cus, const std::string& cu_policy, size_t num_devices)
+        : backend_(select_backend(backend, [&] {
+              CuPolicy policy = parse_cu_policy(cu_policy);
+              devices_.reset(new DeviceGroup<VAddRunner>(num_devices, [&](unsigned int device_index) {
+                  std::unique_ptr<VAddRunner> runner(new VAddRunner(xclbin_path, wide ? "vadd_wide" : "vadd",
+                                                                    pool_byte_budget, max_in_flight, wide, num_cus,
+                                                                    policy, device_index));
+                  runner->share_phase_timer(phases_);
+                  return runner;
+              }));
+              runner_ = &devices_->primary();
+          })) {}
+
+    std::string backend() const {
+        return backend_name(backend_);
+    }
 
     py::array_t<int> run(py::array_t<int, py::array::c_style | py::array::forcecast> a,
                          py::array_t<int, py::array::c_style | py::array::forcecast> b) {
@@ -70,29 +52,260 @@ public:
             throw std::runtime_error("Input arrays must have the same size.");
         }
 
+        PhaseTimer::Scope total(*phases_, Phase::total);
         int size = a.size();
+        if (!runner_) {
+            py::array_t<int> result_array(size);
+            PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+            cpu_vadd(a.data(), b.data(), result_array.mutable_data(), size);
+            return result_array;
+        }
+        if (devices_->size() > 1) {
+            // 各カードは自分の範囲を結果の配列へ直接書く (wide時もワード境界で分けるので詰め替えの0埋めは末尾だけ)
+            py::array_t<int> result_array(size);
+            const int* pa = a.data();
+            const int* pb = b.data();
+            int* pc = result_array.mutable_data();
+            {
+                py::gil_scoped_release release;
+                devices_->shard(size, VADD_LANES, [&](VAddRunner& runner, const Shard& s, size_t) {
+                    runner.run(pa + s.begin, pb + s.begin, pc + s.begin, static_cast<int>(s.count));
+                });
+            }
+            return result_array;
+        }
+
+        // BOへの書き込み (write) はランナーが記録するので、ここでのコピーはfrom_numpyとして分ける
+        PhaseTimer::Scope from_numpy(*phases_, Phase::from_numpy);
         std::vector<int> vec_a(a.data(), a.data() + size);
         std::vector<int> vec_b(b.data(), b.data() + size);
+        from_numpy.stop();
 
-        std::vector<int> vec_result = runner_.run(vec_a, vec_b, size);
+        std::vector<int> vec_result = runner_->run(vec_a, vec_b, size);
 
+        PhaseTimer::Scope numpy(*phases_, Phase::to_numpy);
         py::array_t<int> result_array(vec_result.size());
         std::memcpy(result_array.mutable_data(), vec_result.data(), vec_result.size() * sizeof(int));
         return result_array;
     }
 
+    // DeviceArrayどうしの加算。結果もDeviceArrayで、FPGAでは0番のカード上に置いたまま返す。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        a.expect(DType::int32, 1, "a");
+        b.expect(DType::int32, 1, "b");
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            DeviceArray c = DeviceArray::host(a.shape(), DType::int32);
+            PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+            cpu_vadd(a.host_data<int>(), b.host_data<int>(), c.host_data<int>(), a.size());
+            return c;
+        }
+        py::gil_scoped_release release;
+        return runner_->run_device(a, b);
+    }
+
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1) {
+            throw std::runtime_error("Input array must be 1-dimensional.");
+        }
+        if (!runner_) {
+            return host_device_array(a);
+        }
+        return runner_->to_device(a.data(), a.size());
+    }
+
+    uint64_t submit(py::array_t<int, py::array::c_style | py::array::forcecast> a,
+                    py::array_t<int, py::array::c_style | py::array::forcecast> b) {
+        if (a.ndim() != 1 || b.ndim() != 1) {
+            throw std::runtime_error("Input arrays must be 1-dimensional.");
+        }
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        if (!runner_) {
+            // CPUではsubmitの時点で計算を終え、結果をチケットで預かる
+            std::vector<int> vec_result(a.size());
+            PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+            cpu_vadd(a.data(), b.data(), vec_result.data(), a.size());
+            return cpu_tickets_.submit(std::move(vec_result));
+        }
+        return runner_->submit(a.data(), b.data(), a.size());
+    }
+
+    py::array_t<int> wait(uint64_t ticket) {
+        std::vector<int> vec_result;
+        if (!runner_) {
+            vec_result = cpu_tickets_.wait(ticket);
+        } else {
+            py::gil_scoped_release release;
+            vec_result = runner_->wait(ticket);
+        }
+        return to_array(vec_result);
+    }
+
+    py::tuple wait_any() {
+        std::pair<uint64_t, std::vector<int>> result;
+        if (!runner_) {
+            result = cpu_tickets_.wait_any();
+        } else {
+            py::gil_scoped_release release;
+            result = runner_->wait_any();
+        }
+        return py::make_tuple(result.first, to_array(result.second));
+    }
+
+    size_t in_flight() const {
+        return runner_ ? runner_->in_flight() : cpu_tickets_.pending();
+    }
+
+    py::tuple alloc_inputs(int size) {
+        if (!runner_) {
+            cpu_a_ = py::array_t<int>(size);
+            cpu_b_ = py::array_t<int>(size);
+            cpu_c_ = py::array_t<int>(size);
+            cpu_mapped_ = true;
+            return py::make_tuple(cpu_a_, cpu_b_);
+        }
+        runner_->allocate_mapped(size);
+        return py::make_tuple(bo_array(runner_->mapped_a(), {size}), bo_array(runner_->mapped_b(), {size}));
+    }
+
+    py::array_t<int> run_mapped() {
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            if (!cpu_mapped_) {
+                throw std::runtime_error("Mapped buffers are not allocated.");
+            }
+            PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+            cpu_vadd(cpu_a_.data(), cpu_b_.data(), cpu_c_.mutable_data(), cpu_c_.size());
+            return cpu_c_;
+        }
+        runner_->run_mapped();
+        return bo_array(runner_->mapped_c(), {runner_->mapped_size()});
+    }
+
+    py::dict get_pool_stats() const {
+        BOPool::Stats stats = runner_ ? runner_->get_pool_stats() : BOPool::Stats();
+        py::dict d;
+        d["allocations"] = stats.allocations;
+        d["reuses"] = stats.reuses;
+        d["evictions"] = stats.evictions;
+        d["bytes_allocated"] = stats.bytes_allocated;
+        d["bytes_in_use"] = stats.bytes_in_use;
+        return d;
+    }
+
+    void trim_pool() {
+        if (runner_) {
+            runner_->trim_pool();
+        }
+    }
+
+    // CUごとに割り当てた要求数 (CPUバックエンドでは空)
+    std::vector<uint64_t> get_cu_stats() const {
+        return runner_ ? runner_->cu_dispatched() : std::vector<uint64_t>();
+    }
+
+    // 使っているカードの枚数 (CPUバックエンドでは0)
+    size_t num_devices() const {
+        return devices_ ? devices_->size() : 0;
+    }
+
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(*phases_);
+    }
+
+    void reset_phase_stats() {
+        phases_->reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        phases_->set_enabled(enabled);
+    }
+
 private:
-    VAddRunner runner_;
+    py::array_t<int> to_array(const std::vector<int>& vec) {
+        PhaseTimer::Scope numpy(*phases_, Phase::to_numpy);
+        py::array_t<int> result_array(vec.size());
+        std::memcpy(result_array.mutable_data(), vec.data(), vec.size() * sizeof(int));
+        return result_array;
+    }
+
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();  // 全カードのランナーで共有する
+    std::unique_ptr<DeviceGroup<VAddRunner>> devices_;  // CPUバックエンドのときはnull
+    VAddRunner* runner_ = nullptr;  // 0番のカードのランナー (CPUバックエンドのときはnull)
+    Backend backend_;
+    CpuTickets<std::vector<int>> cpu_tickets_;
+    py::array_t<int> cpu_a_, cpu_b_, cpu_c_;  // CPUバックエンドのalloc_inputs()の配列
+    bool cpu_mapped_ = false;
 };
 
 PYBIND11_MODULE(libvadd_module_hw, m) { // モジュール名を vadd_module_hw に変更
     m.doc() = "pybind11 wrapper for VAddRunner (Hardware)";
+    register_device_array(m);
 
     py::class_<PyVAddRunner>(m, "VAddRunner")
-        .def(py::init<const std::string&>())
+        .def(py::init<const std::string&, size_t, size_t, bool, const std::string&, size_t, const std::string&, size_t>(),
+             py::arg("xclbin_path"), py::arg("pool_byte_budget") = 0, py::arg("max_in_flight") = 3, py::arg("wide") = false,
+             py::arg("backend") = "auto", py::arg("num_cus") = 1, py::arg("cu_policy") = "least_loaded",
+             py::arg("num_devices") = 1,
+             "wide=True uses the vadd_wide kernel (16 ints per 512-bit word) from vadd_wide.xclbin. "
+             "Inputs and outputs stay plain int arrays of any size; packing and tail padding are done by the runner. "
+             "backend is \"auto\" (FPGA if the device and xclbin open, otherwise the SIMD multithreaded CPU backend), "
+             "\"fpga\" or \"cpu\". num_cus > 1 dispatches submit() requests across the compute units vadd_1..vadd_N "
+             "(built with NUM_CU=N) using cu_policy \"round_robin\" or \"least_loaded\"; "
+             "pool_byte_budget and max_in_flight then apply per compute unit. "
+             "num_devices > 1 (0 for every device found) loads the xclbin on that many cards and splits run() across them; "
+             "the other methods use device 0.")
+        .def("backend", &PyVAddRunner::backend,
+             "Returns the backend selected at construction (\"fpga\" or \"cpu\").")
+        .def("run", &PyVAddRunner::run_device,
+             py::arg("a"), py::arg("b"),
+             "Adds two int32 DeviceArrays and returns the result as a DeviceArray without transferring anything to the host. "
+             "On the FPGA backend the arrays must be on device 0.")
         .def("run", &PyVAddRunner::run,
              py::arg("a"), py::arg("b"),
-             "Runs the vadd kernel with two input numpy arrays and returns the result as a numpy array.");
+             "Runs the vadd kernel with two input numpy arrays and returns the result as a numpy array.")
+        .def("to_device", &PyVAddRunner::to_device,
+             py::arg("a"),
+             "Transfers a 1-D numpy array to device 0 and returns it as an int32 DeviceArray (host memory on the CPU backend).")
+        .def("submit", &PyVAddRunner::submit,
+             py::arg("a"), py::arg("b"),
+             "Transfers the inputs and starts the kernel without waiting. Returns a ticket for wait(). "
+             "Up to max_in_flight requests run concurrently; further submits block until the oldest completes.")
+        .def("wait", &PyVAddRunner::wait,
+             py::arg("ticket"),
+             "Waits for the request identified by ticket and returns its result as a numpy array.")
+        .def("wait_any", &PyVAddRunner::wait_any,
+             "Waits for any outstanding request and returns (ticket, result).")
+        .def("in_flight", &PyVAddRunner::in_flight,
+             "Returns the number of submitted requests whose results have not been returned yet.")
+        .def("alloc_inputs", &PyVAddRunner::alloc_inputs,
+             py::arg("size"),
+             "Allocates the input arrays (a, b) directly in device buffer host memory. Fill them in place and call run_mapped().")
+        .def("run_mapped", &PyVAddRunner::run_mapped,
+             "Runs the kernel on the arrays from alloc_inputs() and returns the output buffer as a numpy array without copying. "
+             "The returned array is overwritten by the next run_mapped().")
+        .def("get_pool_stats", &PyVAddRunner::get_pool_stats,
+             "Returns the buffer pool statistics (allocations, reuses, evictions, bytes).")
+        .def("trim_pool", &PyVAddRunner::trim_pool,
+             "Releases all idle buffers held by the buffer pool.")
+        .def("get_cu_stats", &PyVAddRunner::get_cu_stats,
+             "Returns the number of requests dispatched to each compute unit (empty on the CPU backend).")
+        .def("num_devices", &PyVAddRunner::num_devices,
+             "Returns the number of devices in use (0 on the CPU backend).")
+        .def("get_phase_stats", &PyVAddRunner::get_phase_stats,
+             "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}} "
+             "for the phases recorded so far (from_numpy, alloc, write, sync_to_device, launch, wait, sync_from_device, read, to_numpy, "
+             "cpu, total). Percentiles are accurate to about 6%.")
+        .def("reset_phase_stats", &PyVAddRunner::reset_phase_stats,
+             "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyVAddRunner::set_phase_timing,
+             py::arg("enabled"),
+             "Enables or disables per-phase timing (enabled by default).");
         // .def("get_kernel_execution_time_ms", &PyVAddRunner::get_kernel_execution_time_ms, // 削除
         //     "Returns the kernel execution time in milliseconds.") // 削除
         // .def("get_total_execution_time_ms", &PyVAddRunner::get_total_execution_time_ms, // 削除
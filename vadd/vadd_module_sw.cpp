@@ -3,6 +3,8 @@
 #include <pybind11/numpy.h>
 #include <vector>
 
+#include "device_array_py.h"
+
 // HLS Kernel function declaration (from vadd.cpp)
 extern "C" void vadd(const int* a, const int* b, int* c, const int size);
 
@@ -39,14 +41,40 @@ public:
         
         return result_array;
     }
+
+    // ホストメモリのDeviceArrayどうしの加算 (HWモジュールと同じ呼び出し方で結果もDeviceArrayになる)
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        a.expect(DType::int32, 1, "a");
+        b.expect(DType::int32, 1, "b");
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        DeviceArray c = DeviceArray::host(a.shape(), DType::int32);
+        vadd(a.host_data<int>(), b.host_data<int>(), c.host_data<int>(), a.size());
+        return c;
+    }
+
+    DeviceArray to_device(py::array_t<int, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1) {
+            throw std::runtime_error("Input array must be 1-dimensional.");
+        }
+        return host_device_array(a);
+    }
 };
 
 PYBIND11_MODULE(libvadd_module_sw, m) {
     m.doc() = "pybind11 wrapper for VAdd software simulation"; 
+    register_device_array(m);
 
     py::class_<VAddSim>(m, "VAddSim")
         .def(py::init<>())
+        .def("run", &VAddSim::run_device,
+             py::arg("a"), py::arg("b"),
+             "Adds two int32 DeviceArrays in host memory and returns the result as a DeviceArray.")
         .def("run", &VAddSim::run,
              py::arg("a"), py::arg("b"),
-             "Runs the vadd kernel software simulation with two input numpy arrays and returns the result as a numpy array.");
+             "Runs the vadd kernel software simulation with two input numpy arrays and returns the result as a numpy array.")
+        .def("to_device", &VAddSim::to_device,
+             py::arg("a"),
+             "Copies a 1-D numpy array into an int32 DeviceArray backed by host memory.");
 } 
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <cstring>
+
+// vadd_wideカーネル用の詰め替え。ap_uint<512>の下位ビットから順に要素0, 1, ... が入るため、
+// int配列を16要素単位に切り上げて末尾を0で埋めれば、そのままワード列として渡せる。
+
+const int VADD_LANES = 16; // 512ビット1ワードあたりのint数
+
+inline int vadd_num_words(int size) {
+    return (size + VADD_LANES - 1) / VADD_LANES;
+}
+
+// ワード列の要素数 (末尾の0埋めを含む)
+inline size_t vadd_padded_size(int size) {
+    return static_cast<size_t>(vadd_num_words(size)) * VADD_LANES;
+}
+
+// srcのsize要素をwordsへ詰め、最後のワードの残りを0で埋める
+inline void vadd_pack(const int* src, int size, int* words) {
+    std::memcpy(words, src, static_cast<size_t>(size) * sizeof(int));
+    std::memset(words + size, 0, (vadd_padded_size(size) - size) * sizeof(int));
+}
+
+// ワード列から有効なsize要素だけを取り出す
+inline void vadd_unpack(const int* words, int size, int* dst) {
+    std::memcpy(dst, words, static_cast<size_t>(size) * sizeof(int));
+}
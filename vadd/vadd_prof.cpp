@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "vadd_body.h"
+
+// 計測版 (vadd_prof)。vaddと同じ計算をし、profにカーネル内のサイクル数を書く (../common/kernel_profile.h)。
+extern "C" void vadd_prof(const int* a, const int* b, int* c, const int size, unsigned long long* prof) {
+#pragma HLS INTERFACE m_axi port=a
+#pragma HLS INTERFACE m_axi port=b
+#pragma HLS INTERFACE m_axi port=c
+#pragma HLS INTERFACE m_axi port=prof
+#pragma HLS INTERFACE s_axilite port=size
+#pragma HLS INTERFACE s_axilite port=return
+
+    KernelProfileEvents events;
+#pragma HLS STREAM variable=events depth=4
+#pragma HLS DATAFLOW
+    vadd_body(a, b, c, size, events);
+    kernel_profile_counter(events, prof);
+}
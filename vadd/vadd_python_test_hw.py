@@ -1,9 +1,21 @@
 import numpy as np
+import os
 import time
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+from bench_record import BenchRecorder
 from libvadd_module_hw import VAddRunner # モジュール名を変更
 
 MEGA = 1024 * 1024
 
+# xclbinのCUの数 (Makefileの NUM_CU と合わせる)
+NUM_CU = int(os.environ.get("NUM_CU", "1"))
+
+# 使うカードの枚数 (Makefileの NUM_DEVICES と合わせる。0は見つかったすべて)
+NUM_DEVICES = int(os.environ.get("NUM_DEVICES", "1"))
+
 def test_vadd_hw(): # 関数名を変更
     size = 1 * MEGA 
     print(f"Test data size: {size / MEGA:.2f} M elements")
@@ -12,7 +24,7 @@ def test_vadd_hw(): # 関数名を変更
     b = np.arange(size, 0, -1, dtype=np.int32) # b = size, size-1, ..., 1
     
     try:
-        runner = VAddRunner("vadd.xclbin")
+        runner = VAddRunner("vadd.xclbin", num_cus=NUM_CU, num_devices=NUM_DEVICES)
     except Exception as e:
         print(f"Error initializing VAddRunner: {e}")
         print("Please ensure 'vadd.xclbin' exists and XRT is set up correctly.")
@@ -29,6 +41,8 @@ def test_vadd_hw(): # 関数名を変更
         print(f"Error during VAddRunner.run: {e}")
         return
 
+    # 1回のrun()でwrite (BOへの書き込み) とfrom_numpy (入力のコピー) を1件ずつ記録する
+    runner.reset_phase_stats()
     for i in range(num_iterations):
         print(f"Iteration {i+1}/{num_iterations}")
         
@@ -43,6 +57,11 @@ def test_vadd_hw(): # 関数名を変更
         kernel_times.append(kernel_exec_time_ms)
         total_times.append(total_exec_time_ms)
 
+    if runner.backend() == "fpga" and runner.num_devices() == 1:
+        counted = runner.get_phase_stats()
+        assert counted["write"]["count"] == num_iterations, "One write sample per run()."
+        assert counted["from_numpy"]["count"] == num_iterations, "One from_numpy sample per run()."
+
     expected = a + b
     assert np.array_equal(result[:10], expected[:10]), "Result (first 10) does not match expected value."
     assert np.array_equal(result[-10:], expected[-10:]), "Result (last 10) does not match expected value."
@@ -52,6 +71,32 @@ def test_vadd_hw(): # 関数名を変更
         assert np.array_equal(result, expected), "Result does not match expected value."
         print("Full result validation successful.")
 
+    # ゼロコピー経路: 入力をBOのホストメモリに直接書き込む
+    a_mapped, b_mapped = runner.alloc_inputs(size)
+    a_mapped[:] = a
+    b_mapped[:] = b
+    mapped_times = []
+    for i in range(num_iterations):
+        iter_start_time = time.perf_counter()
+        result_mapped = runner.run_mapped()
+        mapped_times.append((time.perf_counter() - iter_start_time) * 1000.0)
+    assert np.array_equal(result_mapped, expected), "Zero-copy result does not match expected value."
+
+    # 非同期実行: 複数の要求を投入し、転送とカーネル実行を重ねる
+    async_start_time = time.perf_counter()
+    tickets = [runner.submit(a, b) for _ in range(num_iterations)]
+    for ticket in tickets:
+        result_async = runner.wait(ticket)
+        assert np.array_equal(result_async, expected), "Async result does not match expected value."
+    async_time_ms = (time.perf_counter() - async_start_time) * 1000.0 / num_iterations
+
+    # DeviceArray: 結果をカード上に置いたまま次の加算に渡し、最後にだけホストへ戻す
+    a_dev = runner.to_device(a)
+    b_dev = runner.to_device(b)
+    chained = runner.run(runner.run(a_dev, b_dev), b_dev)
+    assert chained.shape == (size,) and chained.dtype == "int32"
+    assert np.array_equal(chained.to_host(), expected + b), "Chained DeviceArray result does not match expected value."
+
     avg_kernel_time_ms = np.mean(kernel_times)
     avg_total_time_ms = np.mean(total_times)
 
@@ -63,6 +108,72 @@ def test_vadd_hw(): # 関数名を変更
     print(f"Average total execution time (Python measured): {avg_total_time_ms:.4f} ms")
     print(f"Throughput (kernel only): {throughput_kernel_mega_ops_per_sec:.2f} M Ops/sec")
     print(f"Throughput (total): {throughput_total_mega_ops_per_sec:.2f} M Ops/sec")
+    print(f"Average zero-copy execution time (Python measured): {np.mean(mapped_times):.4f} ms")
+    print(f"Average async execution time (Python measured): {async_time_ms:.4f} ms")
+    print(f"Buffer pool: {runner.get_pool_stats()}")
+    cu_stats = runner.get_cu_stats()
+    assert len(cu_stats) == NUM_CU, "One dispatch counter per compute unit."
+    print(f"Requests per compute unit: {cu_stats}")
+    if runner.backend() == "fpga" and NUM_DEVICES > 0:
+        assert runner.num_devices() == NUM_DEVICES, "One runner per device."
+    print(f"Devices: {runner.num_devices()}")
+    # フェーズごとのレイテンシ (転送・起動・完了待ちなどの内訳)
+    phases = runner.get_phase_stats()
+    assert phases["total"]["count"] >= num_iterations, "Every run() records its total time."
+    print("Phase latency (us):")
+    for phase, s in phases.items():
+        print(f"  {phase:<17} n={s['count']:<6} mean={s['mean_us']:.1f} p50={s['p50_us']:.1f} "
+              f"p99={s['p99_us']:.1f} max={s['max_us']:.1f}")
+
+    # vadd_wide.xclbinを読み込むとカード上のvadd.xclbinは置き換わるため、先にvadd.xclbinのランナーと、
+    # そのBOを参照している配列 (ゼロコピー経路の入出力、DeviceArray) をすべて手放す
+    del runner, a_mapped, b_mapped, result_mapped, a_dev, b_dev, chained
+
+    # 512ビット幅カーネル: 16要素の倍数でない大きさも含めて確認する
+    try:
+        wide_runner = VAddRunner("vadd_wide.xclbin", wide=True)
+    except Exception as e:
+        print(f"Skipping wide kernel test: {e}")
+        wide_runner = None
+    if wide_runner is not None:
+        for wide_size in [1, 17, 1000, size + 5]:
+            a_wide = np.arange(wide_size, dtype=np.int32)
+            b_wide = np.arange(wide_size, 0, -1, dtype=np.int32)
+            result_wide = wide_runner.run(a_wide, b_wide)
+            assert np.array_equal(result_wide, a_wide + b_wide), f"Wide result does not match (size {wide_size})."
+        wide_times = []
+        for i in range(num_iterations):
+            iter_start_time = time.perf_counter()
+            result_wide = wide_runner.run(a, b)
+            wide_times.append((time.perf_counter() - iter_start_time) * 1000.0)
+        assert np.array_equal(result_wide, expected), "Wide result does not match expected value."
+        print(f"Average wide kernel execution time (Python measured): {np.mean(wide_times):.4f} ms")
+    # CPUバックエンド: 同じAPIをSIMD・複数スレッドのCPU実装で実行する
+    cpu_runner = VAddRunner("vadd.xclbin", backend="cpu")
+    assert cpu_runner.backend() == "cpu"
+    cpu_times = []
+    for i in range(num_iterations):
+        iter_start_time = time.perf_counter()
+        result_cpu = cpu_runner.run(a, b)
+        cpu_times.append((time.perf_counter() - iter_start_time) * 1000.0)
+    assert np.array_equal(result_cpu, expected), "CPU backend result does not match expected value."
+    tickets = [cpu_runner.submit(a, b) for _ in range(3)]
+    assert all(np.array_equal(cpu_runner.wait(t), expected) for t in tickets), "CPU backend async result mismatch."
+    cpu_chained = cpu_runner.run(cpu_runner.to_device(a), cpu_runner.to_device(b))
+    assert cpu_chained.device == -1 and np.array_equal(cpu_chained.to_host(), expected), "CPU backend DeviceArray mismatch."
+    print(f"Average CPU backend execution time (Python measured): {np.mean(cpu_times):.4f} ms")
+    assert cpu_runner.get_phase_stats()["cpu"]["count"] >= num_iterations, "CPU backend records the cpu phase."
+    cpu_runner.reset_phase_stats()
+    cpu_runner.set_phase_timing(False)
+    cpu_runner.run(a, b)
+    assert cpu_runner.get_phase_stats() == {}, "Phase timing can be reset and disabled."
+    recorder = BenchRecorder()
+    recorder.add("vadd", "vadd_python_test_hw", {"size": size, "phase": "total"}, total_times)
+    recorder.add("vadd", "vadd_python_test_hw", {"size": size, "phase": "total_mapped"}, mapped_times)
+    recorder.add("vadd", "vadd_python_test_hw", {"size": size, "phase": "total_cpu"}, cpu_times)
+    if wide_runner is not None:
+        recorder.add("vadd_wide", "vadd_python_test_hw", {"size": size, "phase": "total"}, wide_times)
+    recorder.write()
     print("Python HW test successful!") # メッセージ変更
 
 if __name__ == "__main__":
@@ -40,5 +40,12 @@ def test_vadd_sw():
                     print("...")
                     break
 
+    # DeviceArray: ホストメモリに置いた配列で、HWモジュールと同じように結果を次の呼び出しへ渡す
+    a_dev = simulator.to_device(a)
+    b_dev = simulator.to_device(b)
+    chained = simulator.run(simulator.run(a_dev, b_dev), b_dev)
+    status = "PASSED" if np.array_equal(chained.to_host(), a + 2 * b) else "FAILED"
+    print(f"DeviceArray chain: {status} ({chained})")
+
 if __name__ == "__main__":
     test_vadd_sw() 
\ No newline at end of file
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <xrt/xrt_bo.h>
+#include <xrt/xrt_device.h>
+#include <xrt/xrt_kernel.h>
+
+#include "bo_pool.h"
+#include "cu_lane.h"
+#include "device_array_bo.h"
+#include "inflight_queue.h"
+#include "mapped_bo.h"
+#include "phase_timer.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
+#include "vadd_pack.h"
+
+// vadd/vadd_wideカーネルをXRTで実行するランナー。Python (vadd_module_hw.cpp) とC++のテストから使う。
+class VAddRunner { // PyVAddRunner から VAddRunner にクラス名を変更し、HW実行ロジックを直接持つ
+public:
+    // wide = trueのときはvadd_wideカーネル (512ビットに16要素を詰める) を使う。
+    // 呼び出し側の入出力はintの配列のままで、詰め替えと末尾の0埋めはこのクラスで行う。
+    // num_cus > 1のときはxclbinのCU (vadd_1, vadd_2, ...) ごとにBOのプールを持ち、submit()の要求を
+    // policyに従ってCUへ振り分ける。同時に実行中にできる要求はCUあたりmax_in_flight件。
+    // 同期実行 (run()・run_device()・run_mapped()) は1件ずつ完了を待つので、CUを分けても重ならない。先頭のCUで実行する。
+    // device_indexのカードを開く。複数枚のカードはカードごとのランナーをDeviceGroupにまとめて使う。
+    VAddRunner(const std::string& xclbin_path, const std::string& kernel_name, size_t pool_byte_budget, size_t max_in_flight,
+               bool wide, size_t num_cus, CuPolicy policy, unsigned int device_index = 0)
+        : context_(XrtContext::get(xclbin_path, device_index)), device_(context_->device()), // デバイスを共有コンテキストから取得
+          lanes_(open_cu_lanes(*context_, kernel_name, num_cus, pool_byte_budget)), scheduler_(lanes_.size(), policy),
+          krnl_(lanes_[0]->krnl), inflight_(max_in_flight * lanes_.size()), wide_(wide) {}
+
+    std::vector<int> run(const std::vector<int>& vec_a, const std::vector<int>& vec_b, int size) {
+        if (vec_a.size() != size || vec_b.size() != size) {
+            throw std::runtime_error("Input vector sizes do not match the specified size.");
+        }
+        std::vector<int> vec_result(size);
+        run(vec_a.data(), vec_b.data(), vec_result.data(), size);
+        return vec_result;
+    }
+
+    // c[0, size) = a + b。複数枚のカードに分けるときは各カードがこれで自分の範囲を計算する。
+    void run(const int* a, const int* b, int* c, int size) {
+        PhaseTimer& timer = *phases_;
+        const size_t bytes = transfer_bytes(size);
+        CuLane& lane = *lanes_[0];
+
+        // バッファオブジェクトをCUのプールから取得 (BOはバケットサイズなので転送はbytes分だけ行う)
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        auto buf_a = lane.pool.acquire(bytes, lane.krnl.group_id(0));
+        auto buf_b = lane.pool.acquire(bytes, lane.krnl.group_id(1));
+        auto buf_c = lane.pool.acquire(bytes, lane.krnl.group_id(2));
+        alloc.stop();
+
+        // ホストからデバイスへのデータ転送
+        PhaseTimer::Scope write(timer, Phase::write);
+        write_input(buf_a.bo(), a, size);
+        write_input(buf_b.bo(), b, size);
+        write.stop();
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        buf_a.bo().sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        buf_b.bo().sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+        h2d.stop();
+
+        // カーネル実行
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& run = lane.launch(buf_a.bo(), buf_b.bo(), buf_c.bo(), kernel_size(size));
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        run.wait();
+        wait.stop();
+
+        // デバイスからホストへのデータ転送
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        buf_c.bo().sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        d2h.stop();
+        PhaseTimer::Scope read(timer, Phase::read);
+        buf_c.bo().read(c, size * sizeof(int), 0);
+    }
+
+    // カード上の配列どうしの加算。転送は行わず、結果もカード上に置いたまま返す。
+    DeviceArray run_device(const DeviceArray& a, const DeviceArray& b) {
+        xrt::bo& bo_a = device_bo(a, device_index());
+        xrt::bo& bo_b = device_bo(b, device_index());
+        PhaseTimer::Scope alloc(*phases_, Phase::alloc);
+        DeviceArray c = device_array(device_, device_index(), krnl_.group_id(2), a.shape(), DType::int32);
+        alloc.stop();
+        int size = static_cast<int>(a.size());
+        PhaseTimer::Scope launch(*phases_, Phase::launch);
+        auto& run = lanes_[0]->launch(bo_a, bo_b, device_bo(c, device_index()), kernel_size(size));
+        launch.stop();
+        PhaseTimer::Scope wait(*phases_, Phase::wait);
+        run.wait();
+        return c;
+    }
+
+    // srcのsize要素をカードへ転送してDeviceArrayにする
+    DeviceArray to_device(const int* src, int size) {
+        return device_array(device_, device_index(), krnl_.group_id(0), {static_cast<size_t>(size)}, DType::int32, src);
+    }
+
+    unsigned int device_index() const { return context_->device_index(); }
+
+    // 非同期実行: 入力を転送してカーネルを起動し、完了を待たずにチケットを返す。
+    // 最大max_in_flight件が同時に実行中となり、次の要求の転送が前の要求のカーネル実行と重なる。
+    uint64_t submit(const int* a, const int* b, int size) {
+        return inflight_.submit([&] {
+            PhaseTimer& timer = *phases_;
+            const size_t bytes = transfer_bytes(size);
+            auto lease = std::make_shared<CuScheduler::Lease>(scheduler_.acquire());
+            CuLane& lane = *lanes_[lease->cu()];
+            PhaseTimer::Scope alloc(timer, Phase::alloc);
+            auto buffers = std::make_shared<std::vector<BOPool::Buffer>>();
+            buffers->push_back(lane.pool.acquire(bytes, lane.krnl.group_id(0)));
+            buffers->push_back(lane.pool.acquire(bytes, lane.krnl.group_id(1)));
+            buffers->push_back(lane.pool.acquire(bytes, lane.krnl.group_id(2)));
+            alloc.stop();
+
+            xrt::bo& bo_a = (*buffers)[0].bo();
+            xrt::bo& bo_b = (*buffers)[1].bo();
+            PhaseTimer::Scope write(timer, Phase::write);
+            write_input(bo_a, a, size);
+            write_input(bo_b, b, size);
+            write.stop();
+            PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+            bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            h2d.stop();
+            PhaseTimer::Scope launch(timer, Phase::launch);
+            auto run = lane.krnl(bo_a, bo_b, (*buffers)[2].bo(), kernel_size(size));
+            launch.stop();
+
+            // 結果を回収した時点でbuffersとleaseが破棄され、BOはプールへ、CUの負荷は元に戻る。
+            // 完了待ちは他の要求と重なるため、waitのフェーズには含めない。
+            auto phases = phases_;
+            return InflightQueue<std::vector<int>>::Launch{run, [lease, buffers, bytes, size, phases] {
+                xrt::bo& bo_c = (*buffers)[2].bo();
+                PhaseTimer::Scope d2h(*phases, Phase::sync_from_device);
+                bo_c.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+                d2h.stop();
+                PhaseTimer::Scope read(*phases, Phase::read);
+                std::vector<int> vec_result(size);
+                bo_c.read(vec_result.data(), size * sizeof(int), 0);
+                return vec_result;
+            }};
+        });
+    }
+
+    std::vector<int> wait(uint64_t ticket) {
+        return inflight_.wait(ticket);
+    }
+
+    std::pair<uint64_t, std::vector<int>> wait_any() {
+        return inflight_.wait_any();
+    }
+
+    size_t in_flight() const {
+        return inflight_.pending();
+    }
+
+    // ゼロコピー経路: 入出力をBOのホストメモリに直接割り当て、転送はDMA同期のみとする
+    // wide時はBOを16要素単位に切り上げて末尾を0で埋め、先頭size要素だけを呼び出し側に見せる
+    void allocate_mapped(int size) {
+        const size_t count = wide_ ? vadd_padded_size(size) : size;
+        mapped_a_ = std::make_shared<MappedBo<int>>(device_, count, krnl_.group_id(0));
+        mapped_b_ = std::make_shared<MappedBo<int>>(device_, count, krnl_.group_id(1));
+        mapped_c_ = std::make_shared<MappedBo<int>>(device_, count, krnl_.group_id(2));
+        std::fill(mapped_a_->data() + size, mapped_a_->data() + count, 0);
+        std::fill(mapped_b_->data() + size, mapped_b_->data() + count, 0);
+        mapped_size_ = size;
+    }
+
+    void run_mapped() {
+        if (!mapped_a_) {
+            throw std::runtime_error("Mapped buffers are not allocated.");
+        }
+        PhaseTimer& timer = *phases_;
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        mapped_a_->to_device();
+        mapped_b_->to_device();
+        h2d.stop();
+
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& run = lanes_[0]->launch(mapped_a_->bo(), mapped_b_->bo(), mapped_c_->bo(), kernel_size(mapped_size_));
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        run.wait();
+        wait.stop();
+
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        mapped_c_->from_device();
+    }
+
+    const std::shared_ptr<MappedBo<int>>& mapped_a() const { return mapped_a_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_b() const { return mapped_b_; }
+    const std::shared_ptr<MappedBo<int>>& mapped_c() const { return mapped_c_; }
+    int mapped_size() const { return mapped_size_; }
+
+    BOPool::Stats get_pool_stats() const {
+        return total_pool_stats(lanes_);
+    }
+
+    void trim_pool() {
+        for (auto& lane : lanes_) {
+            lane->pool.trim();
+        }
+    }
+
+    const std::vector<uint64_t>& cu_dispatched() const {
+        return scheduler_.dispatched();
+    }
+
+    // フェーズごとの時間の記録先。複数枚のカードのランナーは1つを共有する。
+    void share_phase_timer(std::shared_ptr<PhaseTimer> timer) {
+        phases_ = std::move(timer);
+    }
+
+private:
+    // BOへの転送量 (wide時は16要素単位に切り上げる)
+    size_t transfer_bytes(int size) const {
+        return (wide_ ? vadd_padded_size(size) : size) * sizeof(int);
+    }
+
+    // カーネルの要素数引数 (wide時はワード数)
+    int kernel_size(int size) const {
+        return wide_ ? vadd_num_words(size) : size;
+    }
+
+    void write_input(xrt::bo& bo, const int* src, int size) {
+        if (wide_) {
+            vadd_pack(src, size, bo.map<int*>());
+        } else {
+            bo.write(src, size * sizeof(int), 0);
+        }
+    }
+
+    std::shared_ptr<XrtContext> context_;
+    xrt::device device_;
+    std::vector<std::unique_ptr<CuLane>> lanes_; // CUごとのカーネル・run・プール
+    CuScheduler scheduler_;
+    xrt::kernel krnl_; // 同期実行とDeviceArrayのBOで使う先頭のCU
+    InflightQueue<std::vector<int>> inflight_; // 実行中の要求はリースとプールのBOを持つため、lanes_とscheduler_より後に宣言して先に破棄する
+    std::shared_ptr<MappedBo<int>> mapped_a_;
+    std::shared_ptr<MappedBo<int>> mapped_b_;
+    std::shared_ptr<MappedBo<int>> mapped_c_;
+    int mapped_size_ = 0;
+    bool wide_;
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();
+    // double kernel_execution_time_ms_ = 0.0; // 削除
+    // double total_execution_time_ms_ = 0.0; // 削除
+};
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "vadd_runner.h"
+#include "test_check.h"
+
+// VAddRunnerをXRTフェイクに対して実行するテスト。カーネルは vadd_fake.cpp で登録したHLSカーネルのC++実装。
+
+// run()のwrite/sync/readの経路: 1回の実行でホスト側のフルサイズコピーが3回
+bool test_copy_path(int size, int iterations) {
+    VAddRunner runner("vadd.xclbin", "vadd", 0, 2, false, 1, CuPolicy::least_loaded);
+    std::vector<int> a(size, 1), b(size, 2);
+    xrt_fake::reset_counters();
+
+    std::vector<int> c;
+    for (int it = 0; it < iterations; ++it) {
+        c = runner.run(a, b, size);
+    }
+
+    const xrt_fake::counters_t& cnt = xrt_fake::counters();
+    bool ok = true;
+    ok &= check(cnt.bo_writes + cnt.bo_reads == 3u * iterations, "copy path: three host copies per run");
+    ok &= check(c[0] == 3 && c[size - 1] == 3, "copy path: result");
+    return ok;
+}
+
+// allocate_mapped()/run_mapped()の経路: 入力はBOのホストメモリへ直接書き、転送はDMA同期のみ
+bool test_mapped_path(int size, int iterations, bool wide) {
+    VAddRunner runner("vadd.xclbin", wide ? "vadd_wide" : "vadd", 0, 2, wide, 1, CuPolicy::least_loaded);
+    xrt_fake::reset_counters();
+    runner.allocate_mapped(size);
+
+    bool ok = true;
+    const size_t count = wide ? vadd_padded_size(size) : size;
+    ok &= check(runner.mapped_a()->size() == count, "mapped path: buffers are padded to whole words when wide");
+    for (int it = 0; it < iterations; ++it) {
+        int* a = runner.mapped_a()->data();
+        int* b = runner.mapped_b()->data();
+        for (int i = 0; i < size; ++i) {
+            a[i] = i;
+            b[i] = it;
+        }
+        runner.run_mapped();
+        const int* c = runner.mapped_c()->data();
+        ok &= check(c[0] == it && c[size - 1] == size - 1 + it, "mapped path: result visible through the mapping");
+        if (count > static_cast<size_t>(size)) {
+            ok &= check(c[count - 1] == 0, "mapped path: padding stays zero");
+        }
+    }
+
+    const xrt_fake::counters_t& cnt = xrt_fake::counters();
+    ok &= check(cnt.bo_writes == 0 && cnt.bo_reads == 0, "mapped path: no bo.write/bo.read copies");
+    ok &= check(cnt.bo_maps == 3, "mapped path: each buffer is mapped once");
+    ok &= check(cnt.bo_allocs == 3, "mapped path: buffers allocated once");
+    ok &= check(cnt.syncs_to_device == 2u * iterations, "mapped path: two input syncs per run");
+    ok &= check(cnt.syncs_from_device == 1u * iterations, "mapped path: one output sync per run");
+    ok &= check(cnt.bytes_to_device == 2u * iterations * count * sizeof(int), "mapped path: sync covers the whole buffer");
+    return ok;
+}
+
+// submit()の経路: 投入順とは異なる順でwait()しても、各チケットに正しい結果が返る
+bool test_submit_results(int size) {
+    VAddRunner runner("vadd.xclbin", "vadd", 0, 3, false, 1, CuPolicy::least_loaded);
+    const int NUM_REQUESTS = 10;
+    std::vector<uint64_t> tickets;
+    std::vector<int> b(size, 1000);
+    for (int r = 0; r < NUM_REQUESTS; ++r) {
+        std::vector<int> a(size, r);
+        tickets.push_back(runner.submit(a.data(), b.data(), size));
+    }
+
+    bool ok = true;
+    ok &= check(runner.in_flight() == NUM_REQUESTS, "retired results are kept until wait()");
+    for (int r = NUM_REQUESTS - 1; r >= 0; --r) {
+        std::vector<int> c = runner.wait(tickets[r]);
+        ok &= check(c[0] == r + 1000 && c[size - 1] == r + 1000, "submit: result matches its ticket");
+    }
+    ok &= check(runner.in_flight() == 0, "submit: all results collected");
+    ok &= check(runner.get_pool_stats().bytes_in_use == 0, "submit: all buffers returned after wait");
+    return ok;
+}
+
+// カーネルは投入順に実行されるため、wait_any()は古い要求から返る
+bool test_submit_wait_any(int size) {
+    xrt_fake::latency().kernel = std::chrono::milliseconds(2);
+    VAddRunner runner("vadd.xclbin", "vadd", 0, 3, false, 1, CuPolicy::least_loaded);
+    std::vector<int> b(size, 0);
+    for (int r = 0; r < 3; ++r) {
+        std::vector<int> a(size, r);
+        runner.submit(a.data(), b.data(), size);
+    }
+
+    bool ok = true;
+    for (int r = 0; r < 3; ++r) {
+        auto result = runner.wait_any();
+        ok &= check(result.first == static_cast<uint64_t>(r), "submit: completion order follows submission order");
+        ok &= check(result.second[0] == r, "submit: wait_any result");
+    }
+    xrt_fake::latency() = xrt_fake::latency_model();
+    return ok;
+}
+
+// max_in_flight組のBOセットをプールから使い回し、それ以上は確保しない
+bool test_submit_buffer_reuse(int size, size_t depth) {
+    VAddRunner runner("vadd.xclbin", "vadd", 0, depth, false, 1, CuPolicy::least_loaded);
+    std::vector<int> a(size, 1), b(size, 2);
+    std::vector<uint64_t> tickets;
+    for (int r = 0; r < 20; ++r) {
+        tickets.push_back(runner.submit(a.data(), b.data(), size));
+    }
+    for (uint64_t ticket : tickets) {
+        runner.wait(ticket);
+    }
+
+    BOPool::Stats stats = runner.get_pool_stats();
+    bool ok = true;
+    ok &= check(stats.allocations == 3 * depth, "submit: one BO set per in-flight slot");
+    ok &= check(stats.bytes_in_use == 0, "submit: all buffers returned after wait");
+    return ok;
+}
+
+// 転送とカーネル実行に時間がかかる場合、max_in_flight>1では転送がカーネル実行の裏に隠れる
+static double run_pipeline(int size, size_t depth, int num_requests) {
+    VAddRunner runner("vadd.xclbin", "vadd", 0, depth, false, 1, CuPolicy::least_loaded);
+    std::vector<int> a(size, 1), b(size, 2);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint64_t> tickets;
+    for (int r = 0; r < num_requests; ++r) {
+        tickets.push_back(runner.submit(a.data(), b.data(), size));
+    }
+    for (uint64_t ticket : tickets) {
+        runner.wait(ticket);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+bool test_submit_overlap() {
+    const int SIZE = 256 * 1024;  // 1MiB
+    const int NUM_REQUESTS = 8;
+    xrt_fake::latency().kernel = std::chrono::milliseconds(10);
+    xrt_fake::latency().sync_us_per_mib = 5000.0;
+
+    double serial_ms = run_pipeline(SIZE, 1, NUM_REQUESTS);
+    double overlapped_ms = run_pipeline(SIZE, 2, NUM_REQUESTS);
+    xrt_fake::latency() = xrt_fake::latency_model();
+
+    std::cout << "  max_in_flight 1: " << serial_ms << " ms, max_in_flight 2: " << overlapped_ms << " ms" << std::endl;
+    return check(overlapped_ms < serial_ms * 0.85, "submit: transfers overlap with kernel execution");
+}
+
+// 複数CU (vadd_1 .. vadd_N) のランナーでnum_requests件をsubmit()し、全体の時間 (ms) を返す
+static double run_multi_cu(size_t num_cus, int num_requests, int size, bool* correct) {
+    VAddRunner runner("vadd.xclbin", "vadd", 0, 2, false, num_cus, CuPolicy::least_loaded);
+    std::vector<int> a(size, 1), b(size, 2);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint64_t> tickets;
+    for (int r = 0; r < num_requests; ++r) {
+        tickets.push_back(runner.submit(a.data(), b.data(), size));
+    }
+    for (uint64_t ticket : tickets) {
+        std::vector<int> c = runner.wait(ticket);
+        *correct &= c[0] == 3 && c[size - 1] == 3;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < num_cus; ++i) {
+        *correct &= runner.cu_dispatched()[i] == static_cast<uint64_t>(num_requests / num_cus);
+    }
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// カーネル時間が支配的なとき、CUの数に比例してスループットが上がる
+bool test_multi_cu_scaling(int size) {
+    xrt_fake::latency().kernel = std::chrono::milliseconds(10);
+    const int NUM_REQUESTS = 16;
+    bool correct = true;
+    double one_cu_ms = run_multi_cu(1, NUM_REQUESTS, size, &correct);
+    double four_cu_ms = run_multi_cu(4, NUM_REQUESTS, size, &correct);
+    xrt_fake::latency() = xrt_fake::latency_model();
+
+    std::cout << "  1 CU: " << one_cu_ms << " ms, 4 CUs: " << four_cu_ms << " ms" << std::endl;
+    bool ok = true;
+    ok &= check(correct, "every CU computes correct results and gets an equal share");
+    ok &= check(four_cu_ms < one_cu_ms / 3.0, "throughput scales with the number of CUs");
+    return ok;
+}
+
+int main() {
+    const int DATA_SIZE = 4099;  // 16の倍数でない (wide時は末尾を0で埋める)
+    const int NUM_ITERATIONS = 10;
+    std::cout << "Running VAddRunner software test with data size: " << DATA_SIZE << std::endl;
+
+    bool ok = true;
+    ok &= test_copy_path(DATA_SIZE, NUM_ITERATIONS);
+    ok &= test_mapped_path(DATA_SIZE, NUM_ITERATIONS, false);
+    ok &= test_mapped_path(DATA_SIZE, NUM_ITERATIONS, true);
+    ok &= test_submit_results(DATA_SIZE);
+    ok &= test_submit_wait_any(DATA_SIZE);
+    ok &= test_submit_buffer_reuse(DATA_SIZE, 2);
+    ok &= test_submit_buffer_reuse(DATA_SIZE, 3);
+    ok &= test_submit_overlap();
+    ok &= test_multi_cu_scaling(DATA_SIZE);
+
+    if (ok) {
+        std::cout << "Test PASSED!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Test FAILED!" << std::endl;
+        return 1;
+    }
+}
@@ -9,15 +9,22 @@
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
 
+#include "bench_record.h"
+#include "kernel_profile.h"
+
 // HLS Kernel function name (as defined in vadd.cpp and compiled into xclbin)
 const char* KERNEL_NAME = "vadd";
+const int NUM_ITERATIONS = 20;
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cout << "Usage: " << argv[0] << " <xclbin_file>" << std::endl;
+    // --profile を付けると計測版カーネル (vadd_prof.xclbin の vadd_prof) でカーネル内のサイクル数も読む
+    const bool profile = argc == 3 && std::string(argv[2]) == "--profile";
+    if (argc != 2 && !profile) {
+        std::cout << "Usage: " << argv[0] << " <xclbin_file> [--profile]" << std::endl;
         return EXIT_FAILURE;
     }
     std::string xclbin_file = argv[1];
+    const std::string kernel_name = profile ? std::string(KERNEL_NAME) + "_prof" : KERNEL_NAME;
 
     const int DATA_SIZE = 256;
     std::cout << "Running VADD hardware test with data size: " << DATA_SIZE << std::endl;
@@ -37,11 +44,14 @@ int main(int argc, char** argv) {
         result_sw[i] = source_a[i] + source_b[i]; // Calculate software reference
     }
 
+    BenchRecorder recorder;
+    recorder.env().set("xclbin", xclbin_file);
+
     try {
         // Initialize XRT
         auto device = xrt::device(0); // Use the first available device
         auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME);
+        auto kernel = xrt::kernel(device, uuid, kernel_name);
 
         std::cout << "Allocating buffers..." << std::endl;
         // Allocate buffers on the device
@@ -59,13 +69,33 @@ int main(int argc, char** argv) {
         bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
 
         std::cout << "Executing kernel..." << std::endl;
-        auto run_start_time = std::chrono::high_resolution_clock::now();
-        // Execute the kernel
-        auto run = kernel(bo_a, bo_b, bo_c, DATA_SIZE);
+        xrt::bo bo_prof;
+        unsigned long long prof_words[KERNEL_PROFILE_WORDS] = {};
+        KernelProfileLog profile_log;
+        if (profile) {
+            bo_prof = xrt::bo(device, sizeof(prof_words), kernel.group_id(4));
+        }
+        auto run = profile ? kernel(bo_a, bo_b, bo_c, DATA_SIZE, bo_prof) : kernel(bo_a, bo_b, bo_c, DATA_SIZE);  // ウォームアップ
         run.wait();
-        auto run_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> run_duration_ms = run_end_time - run_start_time;
-        std::cout << "Kernel execution time: " << run_duration_ms.count() << " ms" << std::endl;
+        BenchRecord& record = recorder.add(kernel_name, "vadd_test_hw").param("size", DATA_SIZE);
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            auto run_start_time = std::chrono::high_resolution_clock::now();
+            run.start();
+            run.wait();
+            auto run_end_time = std::chrono::high_resolution_clock::now();
+            record.add_sample(std::chrono::duration<double, std::milli>(run_end_time - run_start_time).count());
+            if (profile) {
+                bo_prof.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+                bo_prof.read(prof_words);
+                profile_log.add(prof_words, std::chrono::duration<double, std::micro>(run_end_time - run_start_time).count());
+            }
+        }
+        BenchStats stats = bench_summarize(record.samples());
+        std::cout << "Kernel execution time: median " << stats.median << " ms, min " << stats.min
+                  << " ms, p99 " << stats.p99 << " ms (" << NUM_ITERATIONS << " runs)" << std::endl;
+        if (profile) {
+            profile_log.print(std::cout);
+        }
 
         std::cout << "Reading data from device..." << std::endl;
         // Synchronize buffer to ensure data is read from device
@@ -89,6 +119,9 @@ int main(int argc, char** argv) {
     }
 
     if (match) {
+        if (!recorder.write()) {
+            std::cerr << "Failed to write benchmark records to " << recorder.path() << std::endl;
+        }
         std::cout << "Test PASSED!" << std::endl;
         return EXIT_SUCCESS;
     } else {
@@ -3,18 +3,22 @@
 #include <cstdlib> // For rand() and srand()
 #include <ctime>   // For time()
 
-// HLS Kernel function declaration (from vadd.cpp)
+#include "ap_int.h"
+#include "kernel_profile.h"
+#include "vadd_pack.h"
+
+// HLS Kernel function declaration (from vadd.cpp, vadd_wide.cpp)
 extern "C" void vadd(const int* a, const int* b, int* c, const int size);
+extern "C" void vadd_wide(const ap_uint<512>* a, const ap_uint<512>* b, ap_uint<512>* c, const int num_words);
+extern "C" void vadd_prof(const int* a, const int* b, int* c, const int size, unsigned long long* prof);
 
-bool run_test(int data_size) {
+// wide = trueのときは16要素ずつ512ビットに詰めてvadd_wideで計算する
+bool run_test(int data_size, bool wide) {
     std::vector<int> a(data_size);
     std::vector<int> b(data_size);
     std::vector<int> c_hw(data_size); // Result from hardware (simulated)
     std::vector<int> c_sw(data_size); // Result from software
 
-    // Initialize random seed
-    srand(time(nullptr));
-
     // Populate input vectors with random data
     for (int i = 0; i < data_size; ++i) {
         a[i] = rand() % 100; // Random numbers between 0 and 99
@@ -22,7 +26,17 @@ bool run_test(int data_size) {
     }
 
     // Call the HLS kernel (simulated)
-    vadd(a.data(), b.data(), c_hw.data(), data_size);
+    if (wide) {
+        std::vector<ap_uint<512>> words_a(vadd_num_words(data_size));
+        std::vector<ap_uint<512>> words_b(vadd_num_words(data_size));
+        std::vector<ap_uint<512>> words_c(vadd_num_words(data_size));
+        vadd_pack(a.data(), data_size, reinterpret_cast<int*>(words_a.data()));
+        vadd_pack(b.data(), data_size, reinterpret_cast<int*>(words_b.data()));
+        vadd_wide(words_a.data(), words_b.data(), words_c.data(), vadd_num_words(data_size));
+        vadd_unpack(reinterpret_cast<const int*>(words_c.data()), data_size, c_hw.data());
+    } else {
+        vadd(a.data(), b.data(), c_hw.data(), data_size);
+    }
 
     // Calculate expected results (software model)
     for (int i = 0; i < data_size; ++i) {
@@ -32,22 +46,59 @@ bool run_test(int data_size) {
     // Compare results
     for (int i = 0; i < data_size; ++i) {
         if (c_hw[i] != c_sw[i]) {
-            std::cerr << "Mismatch at index " << i << ": HW=" << c_hw[i] << ", SW=" << c_sw[i] << std::endl;
+            std::cerr << (wide ? "[wide] " : "") << "Mismatch at index " << i << " (size " << data_size
+                      << "): HW=" << c_hw[i] << ", SW=" << c_sw[i] << std::endl;
             return false;
         }
     }
     return true;
 }
 
+// 計測版は同じ結果を返し、カウンタの模擬でフェーズごとのサイクル数を書く
+bool test_prof(int data_size) {
+    std::vector<int> a(data_size), b(data_size), c(data_size);
+    for (int i = 0; i < data_size; ++i) {
+        a[i] = rand() % 100;
+        b[i] = rand() % 100;
+    }
+    unsigned long long prof[KERNEL_PROFILE_WORDS] = {};
+    vadd_prof(a.data(), b.data(), c.data(), data_size, prof);
+    for (int i = 0; i < data_size; ++i) {
+        if (c[i] != a[i] + b[i]) {
+            std::cerr << "[prof] Mismatch at index " << i << std::endl;
+            return false;
+        }
+    }
+    if (!kernel_profile_consistent(prof) || prof[KERNEL_PROFILE_COMPUTE] == 0) {
+        std::cerr << "[prof] Unexpected profile: compute " << prof[KERNEL_PROFILE_COMPUTE] << ", total "
+                  << prof[KERNEL_PROFILE_TOTAL] << " cycles" << std::endl;
+        return false;
+    }
+    std::cout << "vadd_prof (" << data_size << "): compute " << kernel_profile_decode(prof).us[KERNEL_PROFILE_COMPUTE]
+              << " us at " << KERNEL_PROFILE_CLOCK_MHZ << " MHz" << std::endl;
+    return true;
+}
+
 int main() {
-    const int DATA_SIZE = 256;
-    std::cout << "Running VADD software test with data size: " << DATA_SIZE << std::endl;
+    // 16の倍数とその前後 (末尾の0埋めが必要な大きさ) を含める
+    const int DATA_SIZES[] = {1, 15, 16, 17, 31, 256, 1000, 4099};
 
-    if (run_test(DATA_SIZE)) {
+    // Initialize random seed
+    srand(time(nullptr));
+
+    bool ok = true;
+    for (int data_size : DATA_SIZES) {
+        std::cout << "Running VADD software test with data size: " << data_size << std::endl;
+        ok &= run_test(data_size, false);
+        ok &= run_test(data_size, true);
+    }
+    ok &= test_prof(1 << 20);
+
+    if (ok) {
         std::cout << "Test PASSED!" << std::endl;
         return 0; // Success
     } else {
         std::cout << "Test FAILED!" << std::endl;
         return 1; // Failure
     }
-} 
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "ap_int.h"
+
+// 1ワード (512ビット) に16個のintを詰めたvadd。1サイクルで16要素を読み書きする。
+// num_wordsはワード数。要素数が16の倍数でない場合はホスト側で末尾を0埋めする (vadd_pack.h)。
+extern "C" void vadd_wide(const ap_uint<512>* a, const ap_uint<512>* b, ap_uint<512>* c, const int num_words) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=b offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=c offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=num_words
+#pragma HLS INTERFACE s_axilite port=return
+
+    const int LANES = 16; // vadd_pack.hのVADD_LANESと合わせる
+
+    for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=1
+        ap_uint<512> word_a = a[i];
+        ap_uint<512> word_b = b[i];
+        ap_uint<512> word_c;
+        for (int lane = 0; lane < LANES; lane++) {
+#pragma HLS UNROLL
+            ap_int<32> x = word_a.range(lane * 32 + 31, lane * 32);
+            ap_int<32> y = word_b.range(lane * 32 + 31, lane * 32);
+            ap_int<32> sum = x + y;
+            word_c.range(lane * 32 + 31, lane * 32) = sum;
+        }
+        c[i] = word_c;
+    }
+}
@@ -5,21 +5,21 @@
  * Unauthorized commercial use of this software is prohibited.
  * Use of this software in life-critical applications or systems is strictly prohibited.
  */
+
+#include "vdot_body.h"
+
 extern "C" {
 
-void vdot(const char* a, const char* b, int* result, int size) {
-#pragma HLS INTERFACE m_axi port=a
-#pragma HLS INTERFACE m_axi port=b
-#pragma HLS INTERFACE s_axilite port=result
+// resultは64ビット1要素のBO (m_axi)
+void vdot(const char* a, const char* b, long long* result, int size) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=b offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=result offset=slave bundle=gmem2
 #pragma HLS INTERFACE s_axilite port=size
 #pragma HLS INTERFACE s_axilite port=return
 
-    int local_result = 0;
-    for (int i = 0; i < size; ++i) {
-#pragma HLS PIPELINE II=1
-        local_result += static_cast<int>(a[i]) * static_cast<int>(b[i]);
-    }
-    *result = local_result;
+    KernelProfileNone none;
+    vdot_body(a, b, result, size, none);
 }
 
-}  
\ No newline at end of file
+}
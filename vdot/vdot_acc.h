@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+// vdot・vdot_prof (vdot_body.h) とvdot_wide (vdot_wide.cpp) が共有する累積の型。
+// 累積のビット幅 (64または32)。64ビットならint8の内積は実用上溢れない。
+// 32ビットにすると加算器が小さくなるが、127*127*Nが2^31を超える約13万要素以上で溢れる。
+// 結果はどちらの場合も64ビットでBOへ書き込む (32ビット時は符号拡張)。
+#ifndef VDOT_ACC_BITS
+#define VDOT_ACC_BITS 64
+#endif
+
+#if VDOT_ACC_BITS == 32
+typedef int vdot_acc_t;
+#else
+typedef long long vdot_acc_t;
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include "kernel_profile_counter.h"
+#include "vdot_acc.h"
+
+// vdot (vdot.cpp) と計測版 vdot_prof (vdot_prof.cpp) が共有する本体。
+// 計測版では積和のループをcompute、結果の書き込みをendとして数える (../common/kernel_profile.h)。
+template <typename Events>
+static void vdot_body(const char* a, const char* b, long long* result, int size, Events& events) {
+    kernel_profile_mark(events, KERNEL_PROFILE_COMPUTE);
+    vdot_acc_t local_result = 0;
+    for (int i = 0; i < size; ++i) {
+#pragma HLS PIPELINE II=1
+        local_result += static_cast<int>(a[i]) * static_cast<int>(b[i]);
+    }
+    kernel_profile_mark(events, KERNEL_PROFILE_END);
+    *result = local_result;
+    kernel_profile_mark(events, KERNEL_PROFILE_DONE);
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include "ap_int.h"
+#include "xrt_fake.h"
+
+// XRTフェイク (make fake) でカーネルとして実行するHLSカーネルのC++実装
+extern "C" {
+void vdot(const char* a, const char* b, long long* result, int size);
+void vdot_wide(const ap_uint<512>* a, const ap_uint<512>* b, long long* result, int size);
+void vdot_prof(const char* a, const char* b, long long* result, int size, unsigned long long* prof);
+}
+
+static xrt_fake::kernel_registrar register_vdot("vdot", vdot);
+static xrt_fake::kernel_registrar register_vdot_wide("vdot_wide", vdot_wide);
+static xrt_fake::kernel_registrar register_vdot_prof("vdot_prof", vdot_prof);
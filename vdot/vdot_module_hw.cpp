@@ -12,110 +12,289 @@
 #include "experimental/xrt_bo.h"
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
+#include <algorithm>
 #include <chrono>
 
+#include "bo_array.h"
+#include "cpu_backend.h"
+#include "device_array_py.h"
+#include "device_group.h"
+#include "phase_timer_py.h"
+#include "vdot_runner.h"
+
 namespace py = pybind11;
 
-class VDotRunner {
+// backendは "auto" (既定、FPGAを開けなければCPU)、"fpga"、"cpu"。CPUバックエンドでもPythonからの使い方は同じ。
+// num_devices > 1のとき、run()は入力をカードの数に分けて各カードで部分和を求め、ホストで足し合わせる。
+class PyVDotRunner {
 public:
-    VDotRunner(const std::string& xclbin_path, const std::string& kernel_name) {
-        device_ = xrt::device(0); 
-        auto uuid = device_.load_xclbin(xclbin_path);
-        krnl_ = xrt::kernel(device_, uuid, kernel_name);
+    PyVDotRunner(const std::string& xclbin_path, size_t max_in_flight, bool wide, const std::string& backend, size_t num_cus,
+                 const std::string& cu_policy, size_t num_devices)
+        : backend_(select_backend(backend, [&] {
+              CuPolicy policy = parse_cu_policy(cu_policy);
+              devices_.reset(new DeviceGroup<VDotRunner>(num_devices, [&](unsigned int device_index) {
+                  std::unique_ptr<VDotRunner> runner(new VDotRunner(xclbin_path, wide ? "vdot_wide" : "vdot", max_in_flight,
+                                                                    wide, num_cus, policy, device_index));
+                  runner->share_phase_timer(phases_);
+                  return runner;
+              }));
+              runner_ = &devices_->primary();
+          })) {}
+
+    std::string backend() const {
+        return backend_name(backend_);
     }
 
-    int run(const std::vector<char>& vec_a, const std::vector<char>& vec_b, int size) {
-        if (vec_a.size() != size || vec_b.size() != size) {
-            throw std::runtime_error("Input vector sizes do not match the specified size.");
+    long long run(py::array_t<char, py::array::c_style | py::array::forcecast> a,
+            py::array_t<char, py::array::c_style | py::array::forcecast> b) {
+        if (a.ndim() != 1 || b.ndim() != 1) {
+            throw std::runtime_error("Input arrays must be 1-dimensional.");
+        }
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
         }
 
-        auto start_total = std::chrono::high_resolution_clock::now();
-
-        auto bo_a = xrt::bo(device_, size * sizeof(char), krnl_.group_id(0));
-        auto bo_b = xrt::bo(device_, size * sizeof(char), krnl_.group_id(1));
-        auto bo_result = xrt::bo(device_, sizeof(int), krnl_.group_id(2));
-
-        bo_a.write(vec_a.data());
-        bo_b.write(vec_b.data());
-        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-
-        auto start_kernel = std::chrono::high_resolution_clock::now();
-        auto kernel_run = krnl_(bo_a, bo_b, bo_result, size);
-        kernel_run.wait();
-        auto end_kernel = std::chrono::high_resolution_clock::now();
-
-        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
-
-        bo_result.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        int result_hw;
-        bo_result.read(&result_hw);
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        int size = a.size();
+        if (!runner_) {
+            return run_cpu(a.data(), b.data(), size);
+        }
+        if (devices_->size() > 1) {
+            return run_sharded(a.data(), b.data(), size);
+        }
 
-        auto end_total = std::chrono::high_resolution_clock::now();
-        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+        // BOへの書き込み (write) はランナーが記録するので、ここでのコピーはfrom_numpyとして分ける
+        PhaseTimer::Scope from_numpy(*phases_, Phase::from_numpy);
+        std::vector<char> vec_a(a.data(), a.data() + size);
+        std::vector<char> vec_b(b.data(), b.data() + size);
+        from_numpy.stop();
 
-        return result_hw;
+        long long result = runner_->run(vec_a, vec_b, size);
+        return result;
     }
 
-    double get_kernel_execution_time_ms() const {
-        return kernel_execution_time_ms_;
+    // DeviceArray (int8) の内積。FPGAでは0番のカード上の配列をそのまま使う。
+    long long run_device(const DeviceArray& a, const DeviceArray& b) {
+        a.expect(DType::int8, 1, "a");
+        b.expect(DType::int8, 1, "b");
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            return run_cpu(a.host_data<char>(), b.host_data<char>(), a.size());
+        }
+        sharded_last_ = false;
+        py::gil_scoped_release release;
+        return runner_->run_device(a, b);
     }
 
-    double get_total_execution_time_ms() const {
-        return total_execution_time_ms_;
+    DeviceArray to_device(py::array_t<char, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1) {
+            throw std::runtime_error("Input array must be 1-dimensional.");
+        }
+        if (!runner_) {
+            return host_device_array(a);
+        }
+        return runner_->to_device(a.data(), a.size());
     }
 
-private:
-    xrt::device device_;
-    xrt::kernel krnl_;
-    double kernel_execution_time_ms_ = 0.0;
-    double total_execution_time_ms_ = 0.0;
-};
-
-class PyVDotRunner {
-public:
-    PyVDotRunner(const std::string& xclbin_path) 
-        : runner_(xclbin_path, "vdot") {}
-
-    int run(py::array_t<char, py::array::c_style | py::array::forcecast> a,
-            py::array_t<char, py::array::c_style | py::array::forcecast> b) {
+    uint64_t submit(py::array_t<char, py::array::c_style | py::array::forcecast> a,
+                    py::array_t<char, py::array::c_style | py::array::forcecast> b) {
         if (a.ndim() != 1 || b.ndim() != 1) {
             throw std::runtime_error("Input arrays must be 1-dimensional.");
         }
         if (a.size() != b.size()) {
             throw std::runtime_error("Input arrays must have the same size.");
         }
+        if (!runner_) {
+            // CPUではsubmitの時点で計算を終え、結果をチケットで預かる
+            return cpu_tickets_.submit(run_cpu(a.data(), b.data(), a.size()));
+        }
+        return runner_->submit(a.data(), b.data(), a.size());
+    }
 
-        int size = a.size();
-        std::vector<char> vec_a(a.data(), a.data() + size);
-        std::vector<char> vec_b(b.data(), b.data() + size);
+    long long wait(uint64_t ticket) {
+        if (!runner_) {
+            return cpu_tickets_.wait(ticket);
+        }
+        py::gil_scoped_release release;
+        return runner_->wait(ticket);
+    }
 
-        int result = runner_.run(vec_a, vec_b, size);
-        return result;
+    std::pair<uint64_t, long long> wait_any() {
+        if (!runner_) {
+            return cpu_tickets_.wait_any();
+        }
+        py::gil_scoped_release release;
+        return runner_->wait_any();
+    }
+
+    size_t in_flight() const {
+        return runner_ ? runner_->in_flight() : cpu_tickets_.pending();
+    }
+
+    py::tuple alloc_inputs(int size) {
+        if (!runner_) {
+            cpu_a_ = py::array_t<char>(size);
+            cpu_b_ = py::array_t<char>(size);
+            cpu_mapped_ = true;
+            return py::make_tuple(cpu_a_, cpu_b_);
+        }
+        runner_->allocate_mapped(size);
+        return py::make_tuple(bo_array(runner_->mapped_a(), {size}), bo_array(runner_->mapped_b(), {size}));
+    }
+
+    long long run_mapped() {
+        PhaseTimer::Scope total(*phases_, Phase::total);
+        if (!runner_) {
+            if (!cpu_mapped_) {
+                throw std::runtime_error("Mapped buffers are not allocated.");
+            }
+            return run_cpu(cpu_a_.data(), cpu_b_.data(), cpu_a_.size());
+        }
+        sharded_last_ = false;
+        return runner_->run_mapped();
     }
 
     double get_kernel_execution_time_ms() const {
-        return runner_.get_kernel_execution_time_ms();
+        if (sharded_last_) {
+            return sharded_kernel_time_ms_;
+        }
+        return runner_ ? runner_->get_kernel_execution_time_ms() : cpu_time_ms_;
     }
 
     double get_total_execution_time_ms() const {
-        return runner_.get_total_execution_time_ms();
+        if (sharded_last_) {
+            return sharded_total_time_ms_;
+        }
+        return runner_ ? runner_->get_total_execution_time_ms() : cpu_time_ms_;
+    }
+
+    // CUごとに割り当てた要求数 (CPUバックエンドでは空)
+    std::vector<uint64_t> get_cu_stats() const {
+        return runner_ ? runner_->cu_dispatched() : std::vector<uint64_t>();
+    }
+
+    // 使っているカードの枚数 (CPUバックエンドでは0)
+    size_t num_devices() const {
+        return devices_ ? devices_->size() : 0;
+    }
+
+    py::dict get_phase_stats() const {
+        return phase_stats_dict(*phases_);
+    }
+
+    void reset_phase_stats() {
+        phases_->reset();
+    }
+
+    void set_phase_timing(bool enabled) {
+        phases_->set_enabled(enabled);
     }
 
 private:
-    VDotRunner runner_;
+    // シャードの境界は64バイト (vdot_wideの1ワード) 単位にそろえ、wide時も各カードの0埋めは末尾だけにする。
+    // カーネル時間は最も遅いカードの値、合計時間はホストでの足し合わせまでを含む。
+    long long run_sharded(const char* a, const char* b, int size) {
+        py::gil_scoped_release release;
+        auto start_total = std::chrono::high_resolution_clock::now();
+        std::vector<long long> partial(devices_->size(), 0);
+        std::vector<Shard> shards = devices_->shard(size, VDOT_WORD_BYTES, [&](VDotRunner& runner, const Shard& s, size_t i) {
+            partial[i] = runner.run(a + s.begin, b + s.begin, static_cast<int>(s.count));
+        });
+        long long result = 0;
+        sharded_kernel_time_ms_ = 0.0;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            result += partial[i];
+            sharded_kernel_time_ms_ = std::max(sharded_kernel_time_ms_, devices_->runner(i).get_kernel_execution_time_ms());
+        }
+        auto end_total = std::chrono::high_resolution_clock::now();
+        sharded_total_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+        sharded_last_ = true;
+        return result;
+    }
+
+    // CPUバックエンドでは転送がないため、カーネル時間と合計時間は同じ値になる
+    long long run_cpu(const char* a, const char* b, size_t size) {
+        auto start = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope cpu(*phases_, Phase::cpu);
+        long long result = cpu_vdot(a, b, size);
+        cpu.stop();
+        auto end = std::chrono::high_resolution_clock::now();
+        cpu_time_ms_ = std::chrono::duration<double, std::milli>(end - start).count();
+        return result;
+    }
+
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();  // 全カードのランナーで共有する
+    std::unique_ptr<DeviceGroup<VDotRunner>> devices_;  // CPUバックエンドのときはnull
+    VDotRunner* runner_ = nullptr;  // 0番のカードのランナー (CPUバックエンドのときはnull)
+    Backend backend_;
+    CpuTickets<long long> cpu_tickets_;
+    py::array_t<char> cpu_a_, cpu_b_;  // CPUバックエンドのalloc_inputs()の配列
+    bool cpu_mapped_ = false;
+    double cpu_time_ms_ = 0.0;
+    bool sharded_last_ = false;  // 直前の計測が複数カードのrun()か
+    double sharded_kernel_time_ms_ = 0.0;
+    double sharded_total_time_ms_ = 0.0;
 };
 
 PYBIND11_MODULE(libvdot_module_hw, m) {
-    m.doc() = "pybind11 wrapper for VDotRunner (Hardware, char input, int output)";
+    m.doc() = "pybind11 wrapper for VDotRunner (Hardware, char input, int64 output)";
+    register_device_array(m);
 
     py::class_<PyVDotRunner>(m, "VDotRunner")
-        .def(py::init<const std::string&>())
+        .def(py::init<const std::string&, size_t, bool, const std::string&, size_t, const std::string&, size_t>(),
+             py::arg("xclbin_path"), py::arg("max_in_flight") = 3, py::arg("wide") = false, py::arg("backend") = "auto",
+             py::arg("num_cus") = 1, py::arg("cu_policy") = "least_loaded", py::arg("num_devices") = 1,
+             "wide=True uses the vdot_wide kernel (64 bytes per 512-bit word) from vdot_wide.xclbin. Inputs may have any size. "
+             "backend is \"auto\" (FPGA if the device and xclbin open, otherwise the SIMD multithreaded CPU backend), "
+             "\"fpga\" or \"cpu\". num_cus > 1 dispatches submit() requests across the compute units vdot_1..vdot_N "
+             "(built with NUM_CU=N) using cu_policy \"round_robin\" or \"least_loaded\"; max_in_flight applies per compute unit. "
+             "num_devices > 1 (0 for every device found) splits run() across that many cards and adds the partial sums on the host; "
+             "the other methods use device 0.")
+        .def("backend", &PyVDotRunner::backend,
+             "Returns the backend selected at construction (\"fpga\" or \"cpu\").")
+        .def("run", &PyVDotRunner::run_device,
+             py::arg("a"), py::arg("b"),
+             "Computes the dot product of two int8 DeviceArrays without transferring the inputs and returns it as a 64-bit int. "
+             "On the FPGA backend the arrays must be on device 0.")
         .def("run", &PyVDotRunner::run,
              py::arg("a").noconvert(), py::arg("b").noconvert(),
-             "Runs the vdot kernel with two input numpy char arrays and returns the result as an int.")
+             "Runs the vdot kernel with two input numpy char arrays and returns the result as a 64-bit int.")
+        .def("to_device", &PyVDotRunner::to_device,
+             py::arg("a"),
+             "Transfers a 1-D numpy array to device 0 and returns it as an int8 DeviceArray (host memory on the CPU backend).")
+        .def("submit", &PyVDotRunner::submit,
+             py::arg("a").noconvert(), py::arg("b").noconvert(),
+             "Transfers the inputs and starts the kernel without waiting. Returns a ticket for wait(). "
+             "Up to max_in_flight requests run concurrently; further submits block until the oldest completes.")
+        .def("wait", &PyVDotRunner::wait,
+             py::arg("ticket"),
+             "Waits for the request identified by ticket and returns its result as a 64-bit int.")
+        .def("wait_any", &PyVDotRunner::wait_any,
+             "Waits for any outstanding request and returns (ticket, result).")
+        .def("in_flight", &PyVDotRunner::in_flight,
+             "Returns the number of submitted requests whose results have not been returned yet.")
+        .def("alloc_inputs", &PyVDotRunner::alloc_inputs,
+             py::arg("size"),
+             "Allocates the input arrays (a, b) directly in device buffer host memory. Fill them in place and call run_mapped().")
+        .def("run_mapped", &PyVDotRunner::run_mapped,
+             "Runs the vdot kernel on the arrays from alloc_inputs() without host copies and returns the result as a 64-bit int.")
         .def("get_kernel_execution_time_ms", &PyVDotRunner::get_kernel_execution_time_ms,
             "Returns the kernel execution time in milliseconds.")
         .def("get_total_execution_time_ms", &PyVDotRunner::get_total_execution_time_ms,
-            "Returns the total execution time including data transfers in milliseconds.");
+            "Returns the total execution time including data transfers in milliseconds.")
+        .def("get_cu_stats", &PyVDotRunner::get_cu_stats,
+            "Returns the number of requests dispatched to each compute unit (empty on the CPU backend).")
+        .def("num_devices", &PyVDotRunner::num_devices,
+            "Returns the number of devices in use (0 on the CPU backend).")
+        .def("get_phase_stats", &PyVDotRunner::get_phase_stats,
+            "Returns per-phase latency histograms as {phase: {count, mean_us, p50_us, p90_us, p99_us, max_us}} "
+            "for the phases recorded so far. With num_devices > 1 each card's phases are counted once per shard.")
+        .def("reset_phase_stats", &PyVDotRunner::reset_phase_stats,
+            "Clears the per-phase latency histograms.")
+        .def("set_phase_timing", &PyVDotRunner::set_phase_timing,
+            py::arg("enabled"),
+            "Enables or disables per-phase timing (enabled by default).");
 }  
\ No newline at end of file
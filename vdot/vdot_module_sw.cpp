@@ -11,8 +11,10 @@
 #include <vector>
 // #include <numeric> // Not strictly needed here
 
+#include "device_array_py.h"
+
 // HLS Kernel function declaration (from vdot.cpp)
-extern "C" void vdot(const char* a, const char* b, int* result, int size);
+extern "C" void vdot(const char* a, const char* b, long long* result, int size);
 
 namespace py = pybind11;
 
@@ -21,8 +23,8 @@ class VDotSim {
 public:
     VDotSim() = default;
 
-    // numpy配列を受け取り、結果をintで返すrunメソッド
-    int run(py::array_t<char, py::array::c_style | py::array::forcecast> np_a,
+    // numpy配列を受け取り、結果を64ビット整数で返すrunメソッド
+    long long run(py::array_t<char, py::array::c_style | py::array::forcecast> np_a,
             py::array_t<char, py::array::c_style | py::array::forcecast> np_b) {
         if (np_a.ndim() != 1 || np_b.ndim() != 1) {
             throw std::runtime_error("Input arrays must be 1-dimensional.");
@@ -36,21 +38,47 @@ public:
         // py::array_t から std::vector<char> へ変換
         std::vector<char> vec_a(np_a.data(), np_a.data() + size);
         std::vector<char> vec_b(np_b.data(), np_b.data() + size);
-        int result_kernel; // Renamed from result_hw to avoid confusion
+        long long result_kernel; // Renamed from result_hw to avoid confusion
 
         // HLSカーネルを直接呼び出し (ソフトウェアシミュレーション)
         vdot(vec_a.data(), vec_b.data(), &result_kernel, size);
         
         return result_kernel;
     }
+
+    // ホストメモリのDeviceArray (int8) の内積
+    long long run_device(const DeviceArray& a, const DeviceArray& b) {
+        a.expect(DType::int8, 1, "a");
+        b.expect(DType::int8, 1, "b");
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        long long result_kernel;
+        vdot(a.host_data<char>(), b.host_data<char>(), &result_kernel, a.size());
+        return result_kernel;
+    }
+
+    DeviceArray to_device(py::array_t<char, py::array::c_style | py::array::forcecast> a) {
+        if (a.ndim() != 1) {
+            throw std::runtime_error("Input array must be 1-dimensional.");
+        }
+        return host_device_array(a);
+    }
 };
 
 PYBIND11_MODULE(libvdot_module_sw, m) {
-    m.doc() = "pybind11 wrapper for VDot software simulation (char input, int output)"; 
+    m.doc() = "pybind11 wrapper for VDot software simulation (char input, int64 output)"; 
+    register_device_array(m);
 
     py::class_<VDotSim>(m, "VDotSim")
         .def(py::init<>())
+        .def("run", &VDotSim::run_device,
+             py::arg("a"), py::arg("b"),
+             "Computes the dot product of two int8 DeviceArrays in host memory and returns it as a 64-bit int.")
         .def("run", &VDotSim::run,
              py::arg("a").noconvert(), py::arg("b").noconvert(), // Ensure numpy arrays are char
-             "Runs the vdot kernel software simulation with two input numpy char arrays and returns the result as an int.");
+             "Runs the vdot kernel software simulation with two input numpy char arrays and returns the result as a 64-bit int.")
+        .def("to_device", &VDotSim::to_device,
+             py::arg("a"),
+             "Copies a 1-D numpy array into an int8 DeviceArray backed by host memory.");
 }  
\ No newline at end of file
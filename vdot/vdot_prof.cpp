@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "vdot_body.h"
+
+// 計測版 (vdot_prof)。vdotと同じ計算をし、profにカーネル内のサイクル数を書く (../common/kernel_profile.h)。
+extern "C" void vdot_prof(const char* a, const char* b, long long* result, int size, unsigned long long* prof) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=b offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=result offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=prof offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=size
+#pragma HLS INTERFACE s_axilite port=return
+
+    KernelProfileEvents events;
+#pragma HLS STREAM variable=events depth=4
+#pragma HLS DATAFLOW
+    vdot_body(a, b, result, size, events);
+    kernel_profile_counter(events, prof);
+}
@@ -3,11 +3,23 @@
 #
 #
 import numpy as np
+import os
 import time
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+from bench_record import BenchRecorder
 from libvdot_module_hw import VDotRunner # HWモジュールをインポート
 
 MEGA = 1024 * 1024
 
+# xclbinのCUの数 (Makefileの NUM_CU と合わせる)
+NUM_CU = int(os.environ.get("NUM_CU", "1"))
+
+# 使うカードの枚数 (Makefileの NUM_DEVICES と合わせる。0は見つかったすべて)
+NUM_DEVICES = int(os.environ.get("NUM_DEVICES", "1"))
+
 def test_vdot_hw():
     DATA_SIZE = 1 * MEGA
     # DATA_SIZE = 256 # For quick testing
@@ -19,7 +31,7 @@ def test_vdot_hw():
     
     XCLBIN_FILE = "vdot.xclbin"
     try:
-        runner = VDotRunner(XCLBIN_FILE)
+        runner = VDotRunner(XCLBIN_FILE, num_cus=NUM_CU, num_devices=NUM_DEVICES)
     except Exception as e:
         print(f"Error initializing VDotRunner with {XCLBIN_FILE}: {e}")
         print(f"Please ensure '{XCLBIN_FILE}' exists and XRT is set up correctly.")
@@ -44,8 +56,8 @@ def test_vdot_hw():
         kernel_times.append(runner.get_kernel_execution_time_ms())
         total_times.append(runner.get_total_execution_time_ms())
 
-    # 期待値の計算 (Python側, int32で計算してオーバーフローを防ぐ)
-    expected_result = np.dot(a.astype(np.int32), b.astype(np.int32))
+    # 期待値の計算 (Python側, int64で計算してオーバーフローを防ぐ)
+    expected_result = int(np.dot(a.astype(np.int64), b.astype(np.int64)))
 
     # 結果の検証
     if hw_result == expected_result:
@@ -58,6 +70,33 @@ def test_vdot_hw():
         print(f"Expected result: {expected_result}")
         print(f"Difference: {hw_result - expected_result}")
 
+    # ゼロコピー経路: 入力をBOのホストメモリに直接書き込む
+    a_mapped, b_mapped = runner.alloc_inputs(DATA_SIZE)
+    a_mapped[:] = a
+    b_mapped[:] = b
+    mapped_total_times = []
+    for i in range(num_iterations):
+        mapped_result = runner.run_mapped()
+        mapped_total_times.append(runner.get_total_execution_time_ms())
+    if mapped_result != expected_result:
+        print(f"Zero-copy result mismatch: {mapped_result} != {expected_result}")
+
+    # 非同期実行: 複数の要求を投入し、転送とカーネル実行を重ねる
+    async_start_time = time.perf_counter()
+    tickets = [runner.submit(a, b) for _ in range(num_iterations)]
+    for ticket in tickets:
+        async_result = runner.wait(ticket)
+        if async_result != expected_result:
+            print(f"Async result mismatch: {async_result} != {expected_result}")
+    async_time_ms = (time.perf_counter() - async_start_time) * 1000.0 / num_iterations
+
+    # DeviceArray: カード上に置いたint8の配列をそのまま使い、入力を転送しない
+    a_dev = runner.to_device(a)
+    b_dev = runner.to_device(b)
+    device_result = runner.run(a_dev, b_dev)
+    assert device_result == expected_result, f"DeviceArray result mismatch: {device_result} != {expected_result}"
+    print(f"DeviceArray total execution time: {runner.get_total_execution_time_ms():.4f} ms")
+
     avg_kernel_time_ms = np.mean(kernel_times)
     avg_total_time_ms = np.mean(total_times)
 
@@ -75,6 +114,61 @@ def test_vdot_hw():
     print(f"Average total execution time (C++ measured): {avg_total_time_ms:.4f} ms")
     print(f"Throughput (kernel only): {throughput_kernel_mega_ops_per_sec:.2f} M Ops/sec")
     print(f"Throughput (total, C++ measured): {throughput_total_mega_ops_per_sec:.2f} M Ops/sec")
+    print(f"Average zero-copy total execution time: {np.mean(mapped_total_times):.4f} ms")
+    print(f"Average async execution time (Python measured): {async_time_ms:.4f} ms")
+    cu_stats = runner.get_cu_stats()
+    assert len(cu_stats) == NUM_CU, "One dispatch counter per compute unit."
+    print(f"Requests per compute unit: {cu_stats}")
+    if runner.backend() == "fpga" and NUM_DEVICES > 0:
+        assert runner.num_devices() == NUM_DEVICES, "One runner per device."
+    print(f"Devices: {runner.num_devices()}")
+    phases = runner.get_phase_stats()
+    assert phases["launch"]["count"] >= num_iterations, "Every kernel launch is recorded."
+    print(f"Phase latency p50/p99 (us): { {p: (round(s['p50_us'], 1), round(s['p99_us'], 1)) for p, s in phases.items()} }")
+
+    # vdot_wide.xclbinを読み込むとカード上のvdot.xclbinは置き換わるため、先にvdot.xclbinのランナーと、
+    # そのBOを参照している配列 (ゼロコピー経路の入力、DeviceArray) をすべて手放す
+    del runner, a_mapped, b_mapped, a_dev, b_dev
+
+    # 512ビット幅カーネル: 端数のある長さも含めてスカラー版と一致するか確認する
+    try:
+        wide_runner = VDotRunner("vdot_wide.xclbin", wide=True)
+    except Exception as e:
+        print(f"Skipping wide kernel test: {e}")
+        wide_runner = None
+    if wide_runner is not None:
+        for wide_size in [1, 63, 65, 1000, DATA_SIZE]:
+            wide_result = wide_runner.run(a[:wide_size], b[:wide_size])
+            expected_wide = int(np.dot(a[:wide_size].astype(np.int64), b[:wide_size].astype(np.int64)))
+            if wide_result != expected_wide:
+                print(f"Wide result mismatch (size {wide_size}): {wide_result} != {expected_wide}")
+        wide_kernel_times = []
+        for i in range(num_iterations):
+            wide_runner.run(a, b)
+            wide_kernel_times.append(wide_runner.get_kernel_execution_time_ms())
+        avg_wide_kernel_time_ms = np.mean(wide_kernel_times)
+        print(f"Average wide kernel execution time: {avg_wide_kernel_time_ms:.4f} ms "
+              f"({(ops_per_run / (avg_wide_kernel_time_ms / 1000.0)) / MEGA:.2f} M Ops/sec)")
+    # CPUバックエンド: 同じAPIをSIMD・複数スレッドのCPU実装で実行する
+    cpu_runner = VDotRunner(XCLBIN_FILE, backend="cpu")
+    assert cpu_runner.backend() == "cpu"
+    cpu_times = []
+    for i in range(num_iterations):
+        cpu_result = cpu_runner.run(a, b)
+        cpu_times.append(cpu_runner.get_total_execution_time_ms())
+    if cpu_result != expected_result:
+        print(f"CPU backend result mismatch: {cpu_result} != {expected_result}")
+        return
+    assert cpu_runner.run(cpu_runner.to_device(a), cpu_runner.to_device(b)) == expected_result, "CPU backend DeviceArray mismatch."
+    print(f"Average CPU backend execution time: {np.mean(cpu_times):.4f} ms")
+    recorder = BenchRecorder()
+    recorder.add("vdot", "vdot_python_test_hw", {"size": DATA_SIZE, "phase": "kernel"}, kernel_times)
+    recorder.add("vdot", "vdot_python_test_hw", {"size": DATA_SIZE, "phase": "total"}, total_times)
+    recorder.add("vdot", "vdot_python_test_hw", {"size": DATA_SIZE, "phase": "total_cpu"}, cpu_times)
+    recorder.add("vdot", "vdot_python_test_hw", {"size": DATA_SIZE, "phase": "total_mapped"}, mapped_total_times)
+    if wide_runner is not None:
+        recorder.add("vdot_wide", "vdot_python_test_hw", {"size": DATA_SIZE, "phase": "kernel"}, wide_kernel_times)
+    recorder.write()
     print("Python HW test completed.")
 
 if __name__ == "__main__":
@@ -29,8 +29,8 @@ def test_vdot_sw():
         print(f"Error during VDotSim.run: {e}")
         return
 
-    # 期待値の計算 (Python側, int32で計算してオーバーフローを防ぐ)
-    expected_result = np.dot(a.astype(np.int32), b.astype(np.int32))
+    # 期待値の計算 (Python側, int64で計算してオーバーフローを防ぐ)
+    expected_result = np.dot(a.astype(np.int64), b.astype(np.int64))
 
     # 結果の検証
     if result_sim == expected_result:
@@ -43,5 +43,19 @@ def test_vdot_sw():
         print(f"Expected result: {expected_result}")
         print(f"Difference: {result_sim - expected_result}")
 
+    # 32ビットの累積が溢れる長さ (127*127*N > 2^31) でも正しい値が返ることを確認する
+    for size in [131072, 1 << 20]:
+        a = np.full(size, -128, dtype=np.int8)
+        b = np.full(size, -128, dtype=np.int8)
+        result_large = simulator.run(a, b)
+        expected_large = 128 * 128 * size
+        status = "PASSED" if result_large == expected_large else "FAILED"
+        print(f"Large vector {size}: {status} ({result_large} / {expected_large})")
+
+    # DeviceArray: ホストメモリに置いたint8の配列を渡す (HWモジュールと同じ呼び出し方)
+    result_device = simulator.run(simulator.to_device(a), simulator.to_device(b))
+    status = "PASSED" if result_device == expected_large else "FAILED"
+    print(f"DeviceArray: {status}")
+
 if __name__ == "__main__":
     test_vdot_sw()  
\ No newline at end of file
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "experimental/xrt_bo.h"
+#include "experimental/xrt_device.h"
+#include "experimental/xrt_kernel.h"
+
+#include "bo_pool.h"
+#include "cu_lane.h"
+#include "device_array_bo.h"
+#include "inflight_queue.h"
+#include "mapped_bo.h"
+#include "phase_timer.h"
+#include "reusable_run.h"
+#include "xrt_context.h"
+
+// vdot/vdot_wideカーネルをXRTで実行するランナー。Python (vdot_module_hw.cpp) とC++のテストから使う。
+const int VDOT_WORD_BYTES = 64; // vdot_wideの1ワード (512ビット) のバイト数
+
+class VDotRunner {
+public:
+    // wide = trueのときはvdot_wideカーネル (64バイト/ワード) を使う。カーネルは最後のワードの
+    // size以降を無視するため、入力BOを64バイト単位に切り上げるだけで呼び出し側の契約は変わらない。
+    // num_cus > 1のときはsubmit()の要求をpolicyに従ってCU (vdot_1, vdot_2, ...) へ振り分ける。
+    // 常駐の結果BOを使うrun()とrun_mapped()は先頭のCUで実行する。device_indexは開くカードの番号。
+    VDotRunner(const std::string& xclbin_path, const std::string& kernel_name, size_t max_in_flight, bool wide,
+               size_t num_cus, CuPolicy policy, unsigned int device_index = 0)
+        : context_(XrtContext::get(xclbin_path, device_index)), device_(context_->device()),
+          lanes_(open_cu_lanes(*context_, kernel_name, num_cus)), scheduler_(lanes_.size(), policy),
+          krnl_(lanes_[0]->krnl), inflight_(max_in_flight * lanes_.size()),
+          result_(std::make_shared<MappedBo<long long>>(device_, 1, krnl_.group_id(2))), wide_(wide) {}
+
+    // 結果 (64ビット) は常駐のマップ済みBOに書かれるため、呼び出しごとのBO確保とコピーは不要
+    long long run(const std::vector<char>& vec_a, const std::vector<char>& vec_b, int size) {
+        if (vec_a.size() != size || vec_b.size() != size) {
+            throw std::runtime_error("Input vector sizes do not match the specified size.");
+        }
+        return run(vec_a.data(), vec_b.data(), size);
+    }
+
+    // 複数枚のカードに分けるときは、各カードがこれで自分の範囲の部分和を求める
+    long long run(const char* a, const char* b, int size) {
+        PhaseTimer& timer = *phases_;
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope alloc(timer, Phase::alloc);
+        auto bo_a = xrt::bo(device_, buffer_bytes(size), krnl_.group_id(0));
+        auto bo_b = xrt::bo(device_, buffer_bytes(size), krnl_.group_id(1));
+        alloc.stop();
+
+        PhaseTimer::Scope write(timer, Phase::write);
+        bo_a.write(a, size * sizeof(char), 0);
+        bo_b.write(b, size * sizeof(char), 0);
+        write.stop();
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE, size * sizeof(char), 0);
+        bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE, size * sizeof(char), 0);
+        h2d.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& kernel_run = lanes_[0]->launch(bo_a, bo_b, result_->bo(), size);
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        result_->from_device();
+        d2h.stop();
+        long long result_hw = result_->data()[0];
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+
+        return result_hw;
+    }
+
+    // カード上の配列の内積。入力の転送はなく、ホストへ戻すのは結果の8バイトだけ。
+    long long run_device(const DeviceArray& a, const DeviceArray& b) {
+        xrt::bo& bo_a = device_bo(a, device_index());
+        xrt::bo& bo_b = device_bo(b, device_index());
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope launch(*phases_, Phase::launch);
+        auto& kernel_run = lanes_[0]->launch(bo_a, bo_b, result_->bo(), static_cast<int>(a.size()));
+        launch.stop();
+        PhaseTimer::Scope wait(*phases_, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_total).count();
+
+        PhaseTimer::Scope d2h(*phases_, Phase::sync_from_device);
+        result_->from_device();
+        d2h.stop();
+        long long result_hw = result_->data()[0];
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+        return result_hw;
+    }
+
+    // srcのsizeバイトをカードへ転送してDeviceArrayにする
+    DeviceArray to_device(const char* src, int size) {
+        return device_array(device_, device_index(), krnl_.group_id(0), {static_cast<size_t>(size)}, DType::int8, src);
+    }
+
+    unsigned int device_index() const { return context_->device_index(); }
+
+    // 非同期実行: 入力を転送してカーネルを起動し、完了を待たずにチケットを返す
+    uint64_t submit(const char* a, const char* b, int size) {
+        return inflight_.submit([&] {
+            PhaseTimer& timer = *phases_;
+            auto lease = std::make_shared<CuScheduler::Lease>(scheduler_.acquire());
+            CuLane& lane = *lanes_[lease->cu()];
+            PhaseTimer::Scope alloc(timer, Phase::alloc);
+            auto buffers = std::make_shared<std::vector<BOPool::Buffer>>();
+            buffers->push_back(lane.pool.acquire(buffer_bytes(size), lane.krnl.group_id(0)));
+            buffers->push_back(lane.pool.acquire(buffer_bytes(size), lane.krnl.group_id(1)));
+            buffers->push_back(lane.pool.acquire(sizeof(long long), lane.krnl.group_id(2)));
+            alloc.stop();
+
+            xrt::bo& bo_a = (*buffers)[0].bo();
+            xrt::bo& bo_b = (*buffers)[1].bo();
+            PhaseTimer::Scope write(timer, Phase::write);
+            bo_a.write(a, size * sizeof(char), 0);
+            bo_b.write(b, size * sizeof(char), 0);
+            write.stop();
+            PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+            bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE, size * sizeof(char), 0);
+            bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE, size * sizeof(char), 0);
+            h2d.stop();
+            PhaseTimer::Scope launch(timer, Phase::launch);
+            auto kernel_run = lane.krnl(bo_a, bo_b, (*buffers)[2].bo(), size);
+            launch.stop();
+
+            // 完了待ちは他の要求と重なるため、waitのフェーズには含めない
+            auto phases = phases_;
+            return InflightQueue<long long>::Launch{kernel_run, [lease, buffers, phases] {
+                xrt::bo& bo_result = (*buffers)[2].bo();
+                PhaseTimer::Scope d2h(*phases, Phase::sync_from_device);
+                bo_result.sync(XCL_BO_SYNC_BO_FROM_DEVICE, sizeof(long long), 0);
+                d2h.stop();
+                PhaseTimer::Scope read(*phases, Phase::read);
+                long long result_hw;
+                bo_result.read(&result_hw, sizeof(long long), 0);
+                return result_hw;
+            }};
+        });
+    }
+
+    long long wait(uint64_t ticket) {
+        return inflight_.wait(ticket);
+    }
+
+    std::pair<uint64_t, long long> wait_any() {
+        return inflight_.wait_any();
+    }
+
+    size_t in_flight() const {
+        return inflight_.pending();
+    }
+
+    void allocate_mapped(int size) {
+        mapped_a_ = std::make_shared<MappedBo<char>>(device_, buffer_bytes(size), krnl_.group_id(0));
+        mapped_b_ = std::make_shared<MappedBo<char>>(device_, buffer_bytes(size), krnl_.group_id(1));
+        mapped_size_ = size;
+    }
+
+    long long run_mapped() {
+        if (!mapped_a_) {
+            throw std::runtime_error("Mapped buffers are not allocated.");
+        }
+
+        PhaseTimer& timer = *phases_;
+        auto start_total = std::chrono::high_resolution_clock::now();
+
+        PhaseTimer::Scope h2d(timer, Phase::sync_to_device);
+        mapped_a_->to_device();
+        mapped_b_->to_device();
+        h2d.stop();
+
+        auto start_kernel = std::chrono::high_resolution_clock::now();
+        PhaseTimer::Scope launch(timer, Phase::launch);
+        auto& kernel_run = lanes_[0]->launch(mapped_a_->bo(), mapped_b_->bo(), result_->bo(), mapped_size_);
+        launch.stop();
+        PhaseTimer::Scope wait(timer, Phase::wait);
+        kernel_run.wait();
+        wait.stop();
+        auto end_kernel = std::chrono::high_resolution_clock::now();
+
+        kernel_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_kernel - start_kernel).count();
+
+        PhaseTimer::Scope d2h(timer, Phase::sync_from_device);
+        result_->from_device();
+        d2h.stop();
+        long long result_hw = result_->data()[0];
+
+        auto end_total = std::chrono::high_resolution_clock::now();
+        total_execution_time_ms_ = std::chrono::duration<double, std::milli>(end_total - start_total).count();
+
+        return result_hw;
+    }
+
+    const std::shared_ptr<MappedBo<char>>& mapped_a() const { return mapped_a_; }
+    const std::shared_ptr<MappedBo<char>>& mapped_b() const { return mapped_b_; }
+
+    double get_kernel_execution_time_ms() const {
+        return kernel_execution_time_ms_;
+    }
+
+    double get_total_execution_time_ms() const {
+        return total_execution_time_ms_;
+    }
+
+    const std::vector<uint64_t>& cu_dispatched() const {
+        return scheduler_.dispatched();
+    }
+
+    // フェーズごとの時間の記録先 (複数枚のカードのランナーで共有する)
+    void share_phase_timer(std::shared_ptr<PhaseTimer> timer) {
+        phases_ = std::move(timer);
+    }
+
+private:
+    // 入力BOのバイト数 (wide時は64バイト単位に切り上げる)
+    size_t buffer_bytes(int size) const {
+        return wide_ ? static_cast<size_t>(size + VDOT_WORD_BYTES - 1) / VDOT_WORD_BYTES * VDOT_WORD_BYTES : size;
+    }
+
+    std::shared_ptr<XrtContext> context_;
+    xrt::device device_;
+    std::vector<std::unique_ptr<CuLane>> lanes_; // CUごとのカーネル・run・プール
+    CuScheduler scheduler_;
+    xrt::kernel krnl_; // run()とゼロコピー経路で使う先頭のCU
+    InflightQueue<long long> inflight_; // 実行中の要求はリースとプールのBOを持つため、lanes_とscheduler_より後に宣言して先に破棄する
+    std::shared_ptr<MappedBo<char>> mapped_a_;
+    std::shared_ptr<MappedBo<char>> mapped_b_;
+    std::shared_ptr<MappedBo<long long>> result_;
+    int mapped_size_ = 0;
+    bool wide_;
+    std::shared_ptr<PhaseTimer> phases_ = std::make_shared<PhaseTimer>();
+    double kernel_execution_time_ms_ = 0.0;
+    double total_execution_time_ms_ = 0.0;
+};
@@ -17,14 +17,21 @@
 #include "experimental/xrt_device.h"
 #include "experimental/xrt_kernel.h"
 
+#include "bench_record.h"
+#include "kernel_profile.h"
+
 const char* KERNEL_NAME = "vdot";
+const int NUM_ITERATIONS = 20;
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cout << "Usage: " << argv[0] << " <xclbin_file>" << std::endl;
+    // --profile を付けると計測版カーネル (vdot_prof.xclbin の vdot_prof) でカーネル内のサイクル数も読む
+    const bool profile = argc == 3 && std::string(argv[2]) == "--profile";
+    if (argc != 2 && !profile) {
+        std::cout << "Usage: " << argv[0] << " <xclbin_file> [--profile]" << std::endl;
         return EXIT_FAILURE;
     }
     std::string xclbin_file = argv[1];
+    const std::string kernel_name = profile ? std::string(KERNEL_NAME) + "_prof" : KERNEL_NAME;
 
     const int DATA_SIZE = 256;
     std::cout << "Running VDOT hardware test with data size: " << DATA_SIZE << std::endl;
@@ -33,8 +40,8 @@ int main(int argc, char** argv) {
 
     std::vector<char> source_a(DATA_SIZE);
     std::vector<char> source_b(DATA_SIZE);
-    int result_hw;
-    int result_sw;
+    long long result_hw;
+    long long result_sw;
 
     for (int i = 0; i < DATA_SIZE; ++i) {
         source_a[i] = static_cast<char>((rand() % 256) - 128); // char range: -128 to 127
@@ -43,19 +50,22 @@ int main(int argc, char** argv) {
     
     result_sw = 0;
     for (int i = 0; i < DATA_SIZE; ++i) {
-        result_sw += static_cast<int>(source_a[i]) * static_cast<int>(source_b[i]);
+        result_sw += static_cast<long long>(source_a[i]) * static_cast<long long>(source_b[i]);
     }
 
+    BenchRecorder recorder;
+    recorder.env().set("xclbin", xclbin_file);
+
     try {
         auto device = xrt::device(0); 
         auto uuid = device.load_xclbin(xclbin_file);
-        auto kernel = xrt::kernel(device, uuid, KERNEL_NAME);
+        auto kernel = xrt::kernel(device, uuid, kernel_name);
 
         std::cout << "Allocating buffers..." << std::endl;
         
         auto bo_a = xrt::bo(device, source_a.data(), DATA_SIZE * sizeof(char), XCL_BO_FLAGS_HOST_ONLY);
         auto bo_b = xrt::bo(device, source_b.data(), DATA_SIZE * sizeof(char), XCL_BO_FLAGS_HOST_ONLY);
-        auto bo_result = xrt::bo(device, &result_hw, sizeof(int), XCL_BO_FLAGS_HOST_ONLY);
+        auto bo_result = xrt::bo(device, sizeof(long long), kernel.group_id(2)); // 結果は64ビット (m_axi)
 
         std::cout << "Writing data to device..." << std::endl;
         bo_a.write(source_a.data());
@@ -65,16 +75,37 @@ int main(int argc, char** argv) {
         bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
 
         std::cout << "Executing kernel..." << std::endl;
-        auto run_start_time = std::chrono::high_resolution_clock::now();
-        auto run = kernel(bo_a, bo_b, bo_result, DATA_SIZE);
+        xrt::bo bo_prof;
+        unsigned long long prof_words[KERNEL_PROFILE_WORDS] = {};
+        KernelProfileLog profile_log;
+        if (profile) {
+            bo_prof = xrt::bo(device, sizeof(prof_words), kernel.group_id(4));
+        }
+        auto run = profile ? kernel(bo_a, bo_b, bo_result, DATA_SIZE, bo_prof) : kernel(bo_a, bo_b, bo_result, DATA_SIZE);  // ウォームアップ
         run.wait();
-        auto run_end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> run_duration_ms = run_end_time - run_start_time;
-        std::cout << "Kernel execution time: " << run_duration_ms.count() << " ms" << std::endl;
+        BenchRecord& record = recorder.add(kernel_name, "vdot_test_hw").param("size", DATA_SIZE);
+        for (int i = 0; i < NUM_ITERATIONS; ++i) {
+            auto run_start_time = std::chrono::high_resolution_clock::now();
+            run.start();
+            run.wait();
+            auto run_end_time = std::chrono::high_resolution_clock::now();
+            record.add_sample(std::chrono::duration<double, std::milli>(run_end_time - run_start_time).count());
+            if (profile) {
+                bo_prof.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+                bo_prof.read(prof_words);
+                profile_log.add(prof_words, std::chrono::duration<double, std::micro>(run_end_time - run_start_time).count());
+            }
+        }
+        BenchStats stats = bench_summarize(record.samples());
+        std::cout << "Kernel execution time: median " << stats.median << " ms, min " << stats.min
+                  << " ms, p99 " << stats.p99 << " ms (" << NUM_ITERATIONS << " runs)" << std::endl;
+        if (profile) {
+            profile_log.print(std::cout);
+        }
 
         std::cout << "Reading data from device..." << std::endl;
         bo_result.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_result.read(&result_hw); // Read into a single int variable
+        bo_result.read(&result_hw); // Read into a single 64-bit variable
 
     } catch (const std::exception& ex) {
         std::cerr << "Exception caught: " << ex.what() << std::endl;
@@ -84,6 +115,9 @@ int main(int argc, char** argv) {
     bool match = (result_hw == result_sw);
 
     if (match) {
+        if (!recorder.write()) {
+            std::cerr << "Failed to write benchmark records to " << recorder.path() << std::endl;
+        }
         std::cout << "Test PASSED!" << std::endl;
         std::cout << "Software result: " << result_sw << std::endl;
         std::cout << "Hardware result: " << result_hw << std::endl;
@@ -7,19 +7,106 @@
  */
 #include <iostream>
 #include <vector>
-#include <numeric> // For std::inner_product
+#include <cstdlib>
+#include <ctime>
+
+#include "ap_int.h"
+#include "kernel_profile.h"
 
 // Kernel function declaration (for software simulation)
 extern "C" {
-void vdot(const char* a, const char* b, int* result, int size);
+void vdot(const char* a, const char* b, long long* result, int size);
+void vdot_wide(const ap_uint<512>* a, const ap_uint<512>* b, long long* result, int size);
+void vdot_prof(const char* a, const char* b, long long* result, int size, unsigned long long* prof);
+}
+
+const int WORD_BYTES = 64; // vdot_wideの1ワードあたりのバイト数
+
+// vdot_wideの結果がスカラー版vdotとビット単位で一致するか確認する。
+// 入力は64バイト単位に切り上げたバッファに置き、末尾の余りにはsize以降を無視することを確かめるため乱数を入れておく。
+bool test_wide(int size) {
+    const int num_words = (size + WORD_BYTES - 1) / WORD_BYTES;
+    std::vector<ap_uint<512>> words_a(num_words > 0 ? num_words : 1);
+    std::vector<ap_uint<512>> words_b(num_words > 0 ? num_words : 1);
+    char* a = reinterpret_cast<char*>(words_a.data());
+    char* b = reinterpret_cast<char*>(words_b.data());
+    for (int i = 0; i < num_words * WORD_BYTES; ++i) {
+        a[i] = static_cast<char>(rand() % 256 - 128);
+        b[i] = static_cast<char>(rand() % 256 - 128);
+    }
+
+    long long result_scalar;
+    long long result_wide;
+    vdot(a, b, &result_scalar, size);
+    vdot_wide(words_a.data(), words_b.data(), &result_wide, size);
+
+    if (result_scalar != result_wide) {
+        std::cout << "Wide mismatch at size " << size << ": scalar=" << result_scalar << ", wide=" << result_wide << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 32ビットの累積が溢れる境界 (-128 * -128 * 131072 = 2^31) の前後で、両カーネルが64ビットの正しい値を返すか確認する
+bool test_overflow(int size) {
+    const int num_words = (size + WORD_BYTES - 1) / WORD_BYTES;
+    std::vector<ap_uint<512>> words_a(num_words);
+    std::vector<ap_uint<512>> words_b(num_words);
+    char* a = reinterpret_cast<char*>(words_a.data());
+    char* b = reinterpret_cast<char*>(words_b.data());
+    for (int i = 0; i < num_words * WORD_BYTES; ++i) {
+        a[i] = static_cast<char>(-128);
+        b[i] = static_cast<char>(-128);
+    }
+
+    long long expected = 0;
+    for (int i = 0; i < size; ++i) {
+        expected += static_cast<long long>(a[i]) * static_cast<long long>(b[i]);
+    }
+
+    long long result_scalar;
+    long long result_wide;
+    vdot(a, b, &result_scalar, size);
+    vdot_wide(words_a.data(), words_b.data(), &result_wide, size);
+
+    if (result_scalar != expected || result_wide != expected) {
+        std::cout << "Overflow check failed at size " << size << ": expected=" << expected
+                  << ", scalar=" << result_scalar << ", wide=" << result_wide << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 計測版vdot_profがvdotと同じ結果を返し、積和のループの時間をcomputeとして書くか確認する
+bool test_prof(int size) {
+    std::vector<char> a(size), b(size);
+    for (int i = 0; i < size; ++i) {
+        a[i] = static_cast<char>(rand() % 256 - 128);
+        b[i] = static_cast<char>(rand() % 256 - 128);
+    }
+    long long expected;
+    long long result;
+    unsigned long long prof[KERNEL_PROFILE_WORDS] = {};
+    vdot(a.data(), b.data(), &expected, size);
+    vdot_prof(a.data(), b.data(), &result, size, prof);
+    if (result != expected) {
+        std::cout << "Prof mismatch at size " << size << ": vdot=" << expected << ", vdot_prof=" << result << std::endl;
+        return false;
+    }
+    if (!kernel_profile_consistent(prof) || prof[KERNEL_PROFILE_COMPUTE] == 0) {
+        std::cout << "Unexpected profile at size " << size << ": compute " << prof[KERNEL_PROFILE_COMPUTE]
+                  << ", total " << prof[KERNEL_PROFILE_TOTAL] << " cycles" << std::endl;
+        return false;
+    }
+    return true;
 }
 
 int main() {
     const int DATA_SIZE = 256;
     std::vector<char> a(DATA_SIZE);
     std::vector<char> b(DATA_SIZE);
-    int result_sw;
-    int result_hw;
+    long long result_sw;
+    long long result_hw;
 
     // Initialize input vectors
     for (int i = 0; i < DATA_SIZE; ++i) {
@@ -38,15 +125,32 @@ int main() {
 
     // Compare results
     bool match = (result_sw == result_hw);
+    std::cout << "Software result: " << result_sw << std::endl;
+    std::cout << "Hardware result: " << result_hw << std::endl;
+
+    // 64バイト幅カーネル: ワード境界前後と乱数の大きさ (端数を含む)
+    srand(time(nullptr));
+    const int EDGE_SIZES[] = {0, 1, 63, 64, 65, 127, 128, 129, 511, 512, 513};
+    for (int size : EDGE_SIZES) {
+        match &= test_wide(size);
+    }
+    for (int i = 0; i < 100; ++i) {
+        match &= test_wide(rand() % 100000);
+    }
+
+    // 32ビットの累積が溢れる境界の前後と100万要素
+    const int OVERFLOW_SIZES[] = {131071, 131072, 131073, 262144, 262145, 1 << 20, (1 << 20) + 1, 1 << 24};
+    for (int size : OVERFLOW_SIZES) {
+        match &= test_overflow(size);
+    }
+
+    match &= test_prof(1 << 20);
+
     if (match) {
         std::cout << "TEST PASSED." << std::endl;
-        std::cout << "Software result: " << result_sw << std::endl;
-        std::cout << "Hardware result: " << result_hw << std::endl;
     } else {
         std::cout << "TEST FAILED." << std::endl;
-        std::cout << "Software result: " << result_sw << std::endl;
-        std::cout << "Hardware result: " << result_hw << std::endl;
     }
 
     return match ? 0 : 1;
-}  
\ No newline at end of file
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+
+#include "ap_int.h"
+#include "vdot_acc.h"
+
+// 部分和の数 (2のべき乗)。同じ部分和への加算はこのワード数おきになるため、加算のレイテンシが
+// VDOT_WIDE_PARTIALSサイクル以内ならII=1を保てる。DEPENDENCEのdistanceもこの値を使う。
+#ifndef VDOT_WIDE_PARTIALS
+#define VDOT_WIDE_PARTIALS 8
+#endif
+
+static_assert((VDOT_WIDE_PARTIALS & (VDOT_WIDE_PARTIALS - 1)) == 0, "VDOT_WIDE_PARTIALS must be a power of two");
+
+extern "C" {
+
+// 1ワード (512ビット) に64個のcharを詰めたvdot。1サイクルで64要素の積を加算木でまとめ、
+// ワードごとに別の部分和へ振り分けて累積の依存を断ち、最後に部分和を木で足し合わせる。
+// sizeは要素数 (バイト数)。最後のワードのsize以降の要素は0として扱うため、BOは64バイト単位に切り上げておけばよい。
+// 1ワード内の64個の積の和は高々64*128*128なので32ビットで足り、部分和だけをvdot_acc_tで累積する。
+void vdot_wide(const ap_uint<512>* a, const ap_uint<512>* b, long long* result, int size) {
+#pragma HLS INTERFACE m_axi port=a offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=b offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=result offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=size
+#pragma HLS INTERFACE s_axilite port=return
+
+    const int LANES = 64;    // 1ワードあたりの要素数
+    const int PARTIALS = VDOT_WIDE_PARTIALS;
+
+    vdot_acc_t partial[PARTIALS];
+#pragma HLS ARRAY_PARTITION variable=partial complete
+    for (int p = 0; p < PARTIALS; p++) {
+#pragma HLS UNROLL
+        partial[p] = 0;
+    }
+
+    const int num_words = (size + LANES - 1) / LANES;
+    for (int w = 0; w < num_words; w++) {
+#pragma HLS PIPELINE II=1
+        // 同じ部分和への加算はPARTIALSワードおき
+#pragma HLS DEPENDENCE variable=partial inter distance=VDOT_WIDE_PARTIALS true
+        ap_uint<512> word_a = a[w];
+        ap_uint<512> word_b = b[w];
+
+        int products[LANES];
+#pragma HLS ARRAY_PARTITION variable=products complete
+        for (int lane = 0; lane < LANES; lane++) {
+#pragma HLS UNROLL
+            ap_int<8> x = word_a.range(lane * 8 + 7, lane * 8);
+            ap_int<8> y = word_b.range(lane * 8 + 7, lane * 8);
+            products[lane] = (w * LANES + lane < size) ? static_cast<int>(x) * static_cast<int>(y) : 0;
+        }
+
+        // 64個の積を加算木でまとめる
+        for (int stride = LANES / 2; stride > 0; stride /= 2) {
+#pragma HLS UNROLL
+            for (int lane = 0; lane < stride; lane++) {
+#pragma HLS UNROLL
+                products[lane] += products[lane + stride];
+            }
+        }
+
+        partial[w % PARTIALS] += products[0];
+    }
+
+    // 部分和を加算木でまとめる
+    for (int stride = PARTIALS / 2; stride > 0; stride /= 2) {
+#pragma HLS UNROLL
+        for (int p = 0; p < stride; p++) {
+#pragma HLS UNROLL
+            partial[p] += partial[p + stride];
+        }
+    }
+    *result = partial[0];
+}
+
+}
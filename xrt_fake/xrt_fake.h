@@ -0,0 +1,659 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// XRTのxrt::device/xrt::bo/xrt::kernel/xrt::runのうち、このリポジトリで使う部分だけをホストメモリ上で再現する。
+// BOはホスト側とデバイス側の2つのバッファを持ち、syncで明示的にコピーする。
+// カーネルはregister_kernel()で登録したホスト関数を、xrt::kernelのハンドルごと (CUごと) のワーカースレッドで順に実行する。
+// カードの枚数はdevice_count()で決まり、xrt::device(i)ごとにPCIeとDDRのリンクを別々に模擬する。
+
+enum xclBOSyncDirection {
+    XCL_BO_SYNC_BO_TO_DEVICE = 0,
+    XCL_BO_SYNC_BO_FROM_DEVICE = 1,
+};
+
+#define XCL_BO_FLAGS_HOST_ONLY (1U << 29)
+
+enum ert_cmd_state {
+    ERT_CMD_STATE_NEW = 1,
+    ERT_CMD_STATE_QUEUED = 2,
+    ERT_CMD_STATE_RUNNING = 3,
+    ERT_CMD_STATE_COMPLETED = 4,
+    ERT_CMD_STATE_ERROR = 5,
+    ERT_CMD_STATE_ABORT = 6,
+    ERT_CMD_STATE_TIMEOUT = 8,
+};
+
+namespace xrt_fake {
+
+struct counters_t {
+    std::atomic<uint64_t> device_opens{0};
+    std::atomic<uint64_t> xclbin_loads{0};
+    std::atomic<uint64_t> bo_allocs{0};
+    std::atomic<uint64_t> bo_frees{0};
+    std::atomic<uint64_t> bo_bytes_allocated{0};
+    std::atomic<uint64_t> bo_writes{0};
+    std::atomic<uint64_t> bo_reads{0};
+    std::atomic<uint64_t> bo_maps{0};
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint64_t> bytes_read{0};
+    std::atomic<uint64_t> syncs_to_device{0};
+    std::atomic<uint64_t> syncs_from_device{0};
+    std::atomic<uint64_t> bytes_to_device{0};
+    std::atomic<uint64_t> bytes_from_device{0};
+    std::atomic<uint64_t> kernel_launches{0};
+    std::atomic<uint64_t> set_args{0};
+};
+
+inline counters_t& counters() {
+    static counters_t c;
+    return c;
+}
+
+inline void reset_counters() {
+    counters_t& c = counters();
+    c.device_opens = 0;
+    c.xclbin_loads = 0;
+    c.bo_allocs = 0;
+    c.bo_frees = 0;
+    c.bo_bytes_allocated = 0;
+    c.bo_writes = 0;
+    c.bo_reads = 0;
+    c.bo_maps = 0;
+    c.bytes_written = 0;
+    c.bytes_read = 0;
+    c.syncs_to_device = 0;
+    c.syncs_from_device = 0;
+    c.bytes_to_device = 0;
+    c.bytes_from_device = 0;
+    c.kernel_launches = 0;
+    c.set_args = 0;
+}
+
+// 転送とカーネル実行にかかる時間の模擬。既定ではすべて0 (即時)。
+// PCIeとDDRの帯域はカードごとに1本のリンクとして共有され、同時に発行した転送は帯域を分け合う。
+// sync_us_per_mibはリンクを共有しない (スレッドを増やすほど速くなる) 単純なモデルとして残している。
+struct latency_model {
+    std::chrono::microseconds kernel{0};  // カーネル1回の実行時間
+    double sync_us_per_mib = 0.0;          // syncで1MiB転送するのにかかる時間
+    double pcie_latency_us = 0.0;          // sync 1回ごとの固定の遅延 (DMAの設定など)
+    double pcie_mb_s = 0.0;                // PCIeの帯域 (MB/s、方向ごと)。0は無制限
+    double ddr_mb_s = 0.0;                 // カーネルから見たDDRの帯域 (MB/s)。0は無制限
+};
+
+// 環境変数からモデルを読む。テストのバイナリを作り直さずにCIで条件を変えられる。
+inline latency_model latency_from_env() {
+    auto number = [](const char* name) {
+        const char* value = std::getenv(name);
+        return value ? std::atof(value) : 0.0;
+    };
+    latency_model m;
+    m.kernel = std::chrono::microseconds(static_cast<int64_t>(number("XRT_FAKE_KERNEL_US")));
+    m.sync_us_per_mib = number("XRT_FAKE_SYNC_US_PER_MIB");
+    m.pcie_latency_us = number("XRT_FAKE_PCIE_LATENCY_US");
+    m.pcie_mb_s = number("XRT_FAKE_PCIE_MB_S");
+    m.ddr_mb_s = number("XRT_FAKE_DDR_MB_S");
+    return m;
+}
+
+inline latency_model& latency() {
+    static latency_model m = latency_from_env();
+    return m;
+}
+
+// 帯域を共有する1本のリンク。転送はリンクが空くのを待ち、帯域に応じた時間だけ占有する。
+class shared_link {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // readyの時点から送れるbytesバイトの転送を予約し、終わる時刻を返す
+    clock::time_point reserve(size_t bytes, double mb_s, clock::time_point ready) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clock::time_point start = ready > free_at_ ? ready : free_at_;
+        free_at_ = start + std::chrono::duration_cast<clock::duration>(
+                               std::chrono::duration<double, std::micro>(bytes / mb_s));
+        return free_at_;
+    }
+
+private:
+    std::mutex mutex_;
+    clock::time_point free_at_{};
+};
+
+// カード1枚分のリンク。カードが違えばPCIeもDDRも別々なので、複数カードへの転送は互いに待たない。
+struct device_links {
+    shared_link pcie[2];
+    shared_link ddr;
+};
+
+inline device_links& links(unsigned int device) {
+    static std::mutex mutex;
+    static std::map<unsigned int, std::unique_ptr<device_links>> all;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<device_links>& entry = all[device];
+    if (!entry) {
+        entry.reset(new device_links);
+    }
+    return *entry;
+}
+
+inline shared_link& pcie_link(unsigned int device, xclBOSyncDirection dir) {
+    return links(device).pcie[dir == XCL_BO_SYNC_BO_TO_DEVICE ? 0 : 1];
+}
+
+inline shared_link& ddr_link(unsigned int device) { return links(device).ddr; }
+
+// xrt::system::enumerate_devices()が返すカードの枚数。既定は環境変数XRT_FAKE_DEVICES (なければ1)。
+inline unsigned int& device_count() {
+    static unsigned int count = [] {
+        const char* value = std::getenv("XRT_FAKE_DEVICES");
+        int n = value ? std::atoi(value) : 1;
+        return static_cast<unsigned int>(n > 0 ? n : 1);
+    }();
+    return count;
+}
+
+inline std::chrono::steady_clock::duration us_to_duration(double us) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::micro>(us));
+}
+
+inline void simulate_sync(unsigned int device, size_t bytes, xclBOSyncDirection dir) {
+    const latency_model& m = latency();
+    auto now = std::chrono::steady_clock::now();
+    auto ready = now + us_to_duration(m.pcie_latency_us);
+    auto end = ready + us_to_duration(m.sync_us_per_mib * bytes / (1024.0 * 1024.0));
+    if (m.pcie_mb_s > 0) {
+        auto link_end = pcie_link(device, dir).reserve(bytes, m.pcie_mb_s, ready);
+        end = link_end > end ? link_end : end;
+    }
+    if (end > now) {
+        std::this_thread::sleep_until(end);
+    }
+}
+
+struct bo_storage {
+    std::vector<char> host;
+    std::vector<char> device;
+    char* user_ptr = nullptr;
+    size_t size = 0;
+    unsigned int group = 0;
+    unsigned int device_index = 0;  // 確保したカード
+
+    char* host_ptr() { return user_ptr ? user_ptr : host.data(); }
+
+    ~bo_storage() { counters().bo_frees++; }
+};
+
+}  // namespace xrt_fake
+
+namespace xrt {
+
+class uuid {
+public:
+    uuid() = default;
+    explicit uuid(const std::string& str) : str_(str) {}
+
+    std::string to_string() const { return str_; }
+    explicit operator bool() const { return !str_.empty(); }
+    bool operator==(const uuid& other) const { return str_ == other.str_; }
+    bool operator!=(const uuid& other) const { return str_ != other.str_; }
+    bool operator<(const uuid& other) const { return str_ < other.str_; }
+
+private:
+    std::string str_;
+};
+
+// 実機のxclbinはヘッダにUUIDを持つ。フェイクではパスからUUIDを決める。
+class xclbin {
+public:
+    xclbin() = default;
+    explicit xclbin(const std::string& path)
+        : uuid_("fake-" + std::to_string(std::hash<std::string>{}(path))) {}
+
+    uuid get_uuid() const { return uuid_; }
+
+private:
+    uuid uuid_;
+};
+
+class device {
+public:
+    device() = default;
+    explicit device(unsigned int index) : index_(std::make_shared<unsigned int>(index)) {
+        xrt_fake::counters().device_opens++;
+    }
+
+    uuid load_xclbin(const std::string& path) { return load_xclbin(xclbin(path)); }
+    uuid load_xclbin(const xclbin& image) {
+        xrt_fake::counters().xclbin_loads++;
+        return image.get_uuid();
+    }
+
+    unsigned int index() const { return index_ ? *index_ : 0; }
+    explicit operator bool() const { return static_cast<bool>(index_); }
+
+private:
+    std::shared_ptr<unsigned int> index_;
+};
+
+namespace system {
+
+inline unsigned int enumerate_devices() { return xrt_fake::device_count(); }
+
+}  // namespace system
+
+using memory_group = unsigned int;
+
+class bo {
+public:
+    static const size_t DEVICE_PAGE_BYTES = 4096;
+
+    bo() = default;
+    bo(const device& dev, size_t size, memory_group group) : s_(std::make_shared<xrt_fake::bo_storage>()) {
+        s_->host.resize(size);
+        init(dev, size, group);
+    }
+    bo(const device& dev, void* user_ptr, size_t size, memory_group group)
+        : s_(std::make_shared<xrt_fake::bo_storage>()) {
+        s_->user_ptr = static_cast<char*>(user_ptr);
+        init(dev, size, group);
+    }
+    // サブバッファ: 親BOの[offset, offset + size)を共有する
+    bo(const bo& parent, size_t size, size_t offset)
+        : s_(parent.s_), offset_(parent.offset_ + offset), size_(size) {
+        parent.check_range(size, offset);
+    }
+
+    size_t size() const { return size_; }
+    uint64_t address() const { return reinterpret_cast<uint64_t>(s_->device.data() + offset_); }
+    explicit operator bool() const { return static_cast<bool>(s_); }
+    bool operator==(const bo& other) const { return s_ == other.s_ && offset_ == other.offset_; }
+    bool operator!=(const bo& other) const { return !(*this == other); }
+
+    void write(const void* src) { write(src, size(), 0); }
+    void write(const void* src, size_t size, size_t seek) {
+        check_range(size, seek);
+        std::memcpy(host_data() + seek, src, size);
+        xrt_fake::counters().bo_writes++;
+        xrt_fake::counters().bytes_written += size;
+    }
+
+    void read(void* dst) { read(dst, size(), 0); }
+    void read(void* dst, size_t size, size_t skip) {
+        check_range(size, skip);
+        std::memcpy(dst, host_data() + skip, size);
+        xrt_fake::counters().bo_reads++;
+        xrt_fake::counters().bytes_read += size;
+    }
+
+    void sync(xclBOSyncDirection dir) { sync(dir, size(), 0); }
+    void sync(xclBOSyncDirection dir, size_t size, size_t offset) {
+        check_range(size, offset);
+        xrt_fake::simulate_sync(s_->device_index, size, dir);
+        if (dir == XCL_BO_SYNC_BO_TO_DEVICE) {
+            std::memcpy(device_data() + offset, host_data() + offset, size);
+            xrt_fake::counters().syncs_to_device++;
+            xrt_fake::counters().bytes_to_device += size;
+        } else {
+            std::memcpy(host_data() + offset, device_data() + offset, size);
+            xrt_fake::counters().syncs_from_device++;
+            xrt_fake::counters().bytes_from_device += size;
+        }
+    }
+
+    void* map() {
+        xrt_fake::counters().bo_maps++;
+        return host_data();
+    }
+    template <typename MapType>
+    MapType map() {
+        return reinterpret_cast<MapType>(map());
+    }
+
+    // フェイク専用: カーネルから見えるデバイス側メモリ
+    char* device_data() const { return s_->device.data() + offset_; }
+
+private:
+    void init(const device& dev, size_t size, memory_group group) {
+        // XRTと同じくデバイス側はページ単位に切り上げて確保する (ワード単位で読むカーネルが末尾を読み越してもよい)
+        s_->device.resize((size + DEVICE_PAGE_BYTES - 1) / DEVICE_PAGE_BYTES * DEVICE_PAGE_BYTES);
+        s_->device_index = dev.index();
+        s_->size = size;
+        s_->group = group;
+        size_ = size;
+        xrt_fake::counters().bo_allocs++;
+        xrt_fake::counters().bo_bytes_allocated += size;
+    }
+
+    char* host_data() const { return s_->host_ptr() + offset_; }
+
+    void check_range(size_t size, size_t offset) const {
+        if (offset + size > size_) {
+            throw std::runtime_error("xrt_fake: bo access out of range");
+        }
+    }
+
+    std::shared_ptr<xrt_fake::bo_storage> s_;
+    size_t offset_ = 0;
+    size_t size_ = 0;
+};
+
+}  // namespace xrt
+
+namespace xrt_fake {
+
+struct kernel_arg {
+    bool is_bo = false;
+    xrt::bo buffer;
+    int64_t scalar = 0;
+
+    // BO引数のデバイス側メモリ
+    template <typename T>
+    T* ptr() const { return reinterpret_cast<T*>(buffer.device_data()); }
+};
+
+using kernel_fn = std::function<void(const std::vector<kernel_arg>&)>;
+// カーネルのホスト実装がこれを投げると、runはERT_CMD_STATE_ABORTで終わる (それ以外の例外はERROR)
+struct kernel_abort {};
+// カーネル1回がDDRとやり取りするバイト数。latency().ddr_mb_sと合わせて実行時間を決める。
+using traffic_fn = std::function<size_t(const std::vector<kernel_arg>&)>;
+
+struct kernel_entry {
+    kernel_fn fn;
+    traffic_fn traffic;
+};
+
+inline std::map<std::string, kernel_entry>& kernel_registry() {
+    static std::map<std::string, kernel_entry> registry;
+    return registry;
+}
+
+// カーネル名に対応するホスト実装を登録する。未登録のカーネルは何もせずに完了する。
+// trafficを省略すると、BO引数の大きさの合計を読み書きしたものとみなす。
+inline void register_kernel(const std::string& name, kernel_fn fn, traffic_fn traffic = traffic_fn()) {
+    kernel_registry()[name] = kernel_entry{std::move(fn), std::move(traffic)};
+}
+
+// "vadd:{vadd_2}" のようにCUを指定した名前は、カーネル名 (":" より前) の実装で実行する
+inline std::string kernel_base_name(const std::string& name) { return name.substr(0, name.find(':')); }
+
+inline kernel_fn find_kernel(const std::string& name) {
+    auto it = kernel_registry().find(kernel_base_name(name));
+    return it == kernel_registry().end() ? kernel_fn() : it->second.fn;
+}
+
+inline size_t kernel_traffic(const std::string& name, const std::vector<kernel_arg>& args) {
+    auto it = kernel_registry().find(kernel_base_name(name));
+    if (it != kernel_registry().end() && it->second.traffic) {
+        return it->second.traffic(args);
+    }
+    size_t bytes = 0;
+    for (const kernel_arg& a : args) {
+        bytes += a.is_bo ? a.buffer.size() : 0;
+    }
+    return bytes;
+}
+
+template <typename T>
+T unpack_arg(const kernel_arg& a) {
+    if constexpr (std::is_pointer_v<T>) {
+        if (!a.is_bo) {
+            throw std::runtime_error("xrt_fake: pointer argument is not a bo");
+        }
+        return a.ptr<std::remove_const_t<std::remove_pointer_t<T>>>();
+    } else {
+        return static_cast<T>(a.scalar);
+    }
+}
+
+template <typename... Params, size_t... I>
+void call_kernel(void (*fn)(Params...), const std::vector<kernel_arg>& args, std::index_sequence<I...>) {
+    fn(unpack_arg<Params>(args[I])...);
+}
+
+// HLSカーネルのC++関数をそのままカーネル実装にする。ポインタ引数にはBOのデバイス側メモリを、
+// スカラー引数には設定した値を渡す。
+template <typename... Params>
+kernel_fn bind_kernel(void (*fn)(Params...)) {
+    return [fn](const std::vector<kernel_arg>& args) {
+        if (args.size() < sizeof...(Params)) {
+            throw std::runtime_error("xrt_fake: missing kernel arguments");
+        }
+        call_kernel(fn, args, std::index_sequence_for<Params...>{});
+    };
+}
+
+// 静的初期化でカーネルを登録する。サンプルごとの *_fake.cpp で使う。
+struct kernel_registrar {
+    template <typename... Params>
+    kernel_registrar(const std::string& name, void (*fn)(Params...)) {
+        register_kernel(name, bind_kernel(fn));
+    }
+};
+
+// 計算ユニット1つ分の実行キュー。投入順に1件ずつワーカースレッドで実行する。
+// 最後の参照がワーカー上で外れることがあるため、スレッドはjoinせずキュー本体を共有して終了させる。
+class cu_queue {
+public:
+    cu_queue() : core_(std::make_shared<core>()) {
+        std::thread([c = core_] { c->loop(); }).detach();
+    }
+    ~cu_queue() {
+        {
+            std::lock_guard<std::mutex> lock(core_->mutex);
+            core_->stop = true;
+        }
+        core_->cv.notify_all();
+    }
+
+    cu_queue(const cu_queue&) = delete;
+    cu_queue& operator=(const cu_queue&) = delete;
+
+    void push(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(core_->mutex);
+            core_->tasks.push_back(std::move(task));
+        }
+        core_->cv.notify_all();
+    }
+
+private:
+    struct core {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::function<void()>> tasks;
+        bool stop = false;
+
+        void loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                cv.wait(lock, [this] { return stop || !tasks.empty(); });
+                if (tasks.empty()) {
+                    return;
+                }
+                std::function<void()> task = std::move(tasks.front());
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                task = nullptr;
+                lock.lock();
+            }
+        }
+    };
+
+    std::shared_ptr<core> core_;
+};
+
+}  // namespace xrt_fake
+
+namespace xrt {
+
+class run;
+
+class kernel {
+public:
+    kernel() = default;
+    kernel(const device& dev, const uuid& xclbin_id, const std::string& name)
+        : device_(dev), uuid_(xclbin_id), name_(std::make_shared<std::string>(name)),
+          queue_(std::make_shared<xrt_fake::cu_queue>()) {}
+
+    // フェイクでは引数番号をそのままメモリグループとして返す
+    memory_group group_id(int argno) const { return static_cast<memory_group>(argno); }
+
+    const std::string& name() const { return *name_; }
+    explicit operator bool() const { return static_cast<bool>(name_); }
+
+    template <typename... Args>
+    run operator()(Args&&... args);
+
+    // フェイク専用: このカーネルの実行キュー
+    xrt_fake::cu_queue& queue() const { return *queue_; }
+    // フェイク専用: カーネルを開いたカード
+    unsigned int device_index() const { return device_.index(); }
+
+private:
+    device device_;
+    uuid uuid_;
+    std::shared_ptr<std::string> name_;
+    std::shared_ptr<xrt_fake::cu_queue> queue_;
+};
+
+class run {
+public:
+    using arg = xrt_fake::kernel_arg;
+
+    run() = default;
+    explicit run(const kernel& krnl) : s_(std::make_shared<state_t>()) { s_->krnl = krnl; }
+
+    void set_arg(int index, const xrt::bo& value) {
+        arg& a = slot(index);
+        a.is_bo = true;
+        a.buffer = value;
+    }
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    void set_arg(int index, T value) {
+        arg& a = slot(index);
+        a.is_bo = false;
+        a.scalar = static_cast<int64_t>(value);
+    }
+
+    // 引数をその時点の値で確定し、カーネルの実行キューへ積む。完了はwait()/state()で確認する。
+    void start() {
+        xrt_fake::counters().kernel_launches++;
+        std::shared_ptr<state_t> s = s_;
+        {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->state = ERT_CMD_STATE_QUEUED;
+        }
+        std::vector<arg> args = s->args;
+        xrt_fake::kernel_fn fn = xrt_fake::find_kernel(s->krnl.name());
+        std::chrono::microseconds delay = xrt_fake::latency().kernel;
+        double ddr_mb_s = xrt_fake::latency().ddr_mb_s;
+        size_t traffic = ddr_mb_s > 0 ? xrt_fake::kernel_traffic(s->krnl.name(), args) : 0;
+        s->krnl.queue().push([s, args, fn, delay, ddr_mb_s, traffic] {
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                s->state = ERT_CMD_STATE_RUNNING;
+            }
+            if (delay.count() > 0) {
+                std::this_thread::sleep_for(delay);
+            }
+            // DDRの転送は計算と並行するとみなし、ホストでの計算が先に終わったら残りを待つ
+            std::chrono::steady_clock::time_point ddr_end;
+            if (traffic > 0) {
+                ddr_end = xrt_fake::ddr_link(s->krnl.device_index())
+                              .reserve(traffic, ddr_mb_s, std::chrono::steady_clock::now());
+            }
+            ert_cmd_state result = ERT_CMD_STATE_COMPLETED;
+            if (fn) {
+                try {
+                    fn(args);
+                } catch (const xrt_fake::kernel_abort&) {
+                    result = ERT_CMD_STATE_ABORT;
+                } catch (...) {
+                    result = ERT_CMD_STATE_ERROR;
+                }
+            }
+            if (traffic > 0) {
+                std::this_thread::sleep_until(ddr_end);
+            }
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                s->state = result;
+            }
+            s->cv.notify_all();
+        });
+    }
+
+    // timeoutが0なら完了まで待つ。時間内に完了しなければERT_CMD_STATE_TIMEOUTを返す。
+    ert_cmd_state wait(const std::chrono::milliseconds& timeout = std::chrono::milliseconds(0)) const {
+        std::unique_lock<std::mutex> lock(s_->mutex);
+        auto done = [this] { return s_->state != ERT_CMD_STATE_QUEUED && s_->state != ERT_CMD_STATE_RUNNING; };
+        if (timeout.count() == 0) {
+            s_->cv.wait(lock, done);
+        } else if (!s_->cv.wait_for(lock, timeout, done)) {
+            return ERT_CMD_STATE_TIMEOUT;
+        }
+        return s_->state;
+    }
+    ert_cmd_state state() const {
+        std::lock_guard<std::mutex> lock(s_->mutex);
+        return s_->state;
+    }
+
+    const std::vector<arg>& args() const { return s_->args; }
+    explicit operator bool() const { return static_cast<bool>(s_); }
+
+private:
+    struct state_t {
+        kernel krnl;
+        std::vector<arg> args;
+        ert_cmd_state state = ERT_CMD_STATE_NEW;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    arg& slot(int index) {
+        xrt_fake::counters().set_args++;
+        if (static_cast<size_t>(index) >= s_->args.size()) {
+            s_->args.resize(index + 1);
+        }
+        return s_->args[index];
+    }
+
+    std::shared_ptr<state_t> s_;
+};
+
+template <typename... Args>
+run kernel::operator()(Args&&... args) {
+    run r(*this);
+    int index = 0;
+    (r.set_arg(index++, std::forward<Args>(args)), ...);
+    r.start();
+    return r;
+}
+
+}  // namespace xrt
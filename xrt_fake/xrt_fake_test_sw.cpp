@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025, Spice Engine Co., Ltd.
+ *
+ * Redistribution and use in any form, with or without modification, are strictly prohibited.
+ * Unauthorized commercial use of this software is prohibited.
+ * Use of this software in life-critical applications or systems is strictly prohibited.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "xrt_fake.h"
+#include "test_check.h"
+
+static const size_t MB = 1000 * 1000;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+extern "C" void scale(const int* in, int* out, int size, int factor) {
+    for (int i = 0; i < size; ++i) {
+        out[i] = in[i] * factor;
+    }
+}
+
+// bind_kernel: ポインタ引数にはBOのデバイス側メモリ、スカラー引数には設定値が渡る
+bool test_bind_kernel() {
+    xrt_fake::register_kernel("scale", xrt_fake::bind_kernel(scale));
+    xrt::device device(0);
+    xrt::kernel kernel(device, device.load_xclbin("scale.xclbin"), "scale");
+    const int size = 1000;
+    xrt::bo in(device, size * sizeof(int), kernel.group_id(0));
+    xrt::bo out(device, size * sizeof(int), kernel.group_id(1));
+    std::vector<int> data(size);
+    for (int i = 0; i < size; ++i) {
+        data[i] = i;
+    }
+    in.write(data.data());
+    in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    bool ok = check(kernel(in, out, size, 3).wait() == ERT_CMD_STATE_COMPLETED, "bound kernel completes");
+    out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    out.read(data.data());
+    for (int i = 0; i < size && ok; ++i) {
+        ok &= check(data[i] == 3 * i, "bound kernel computes on device memory");
+    }
+    // 引数が足りなければエラーで完了する
+    ok &= check(kernel(in, out, size).wait() == ERT_CMD_STATE_ERROR, "missing argument fails the run");
+    return ok;
+}
+
+// PCIeの帯域は同じ方向のsyncで共有されるため、スレッドを増やしても合計時間は縮まない
+bool test_pcie_bandwidth_is_shared() {
+    xrt::device device(0);
+    std::vector<xrt::bo> bos;
+    for (int i = 0; i < 4; ++i) {
+        bos.emplace_back(device, 2 * MB, 0);
+    }
+    xrt_fake::latency().pcie_mb_s = 1000.0;  // 1MBあたり1ms
+
+    auto start = std::chrono::steady_clock::now();
+    bos[0].sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    double single_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (xrt::bo& bo : bos) {
+        threads.emplace_back([&bo] { bo.sync(XCL_BO_SYNC_BO_TO_DEVICE); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double parallel_ms = elapsed_ms(start);
+
+    // 逆方向は別のリンクなので、送信と受信は重なる
+    start = std::chrono::steady_clock::now();
+    std::thread to_device([&] { bos[0].sync(XCL_BO_SYNC_BO_TO_DEVICE); });
+    bos[1].sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    to_device.join();
+    double duplex_ms = elapsed_ms(start);
+    xrt_fake::latency() = xrt_fake::latency_model();
+
+    bool ok = true;
+    ok &= check(single_ms >= 2.0, "one 2MB sync takes 2ms at 1000MB/s");
+    ok &= check(parallel_ms >= 8.0, "four concurrent syncs share the link");
+    ok &= check(duplex_ms < 3.5, "opposite directions overlap");
+    if (!ok) {
+        std::cerr << "single " << single_ms << " ms, parallel " << parallel_ms << " ms, duplex " << duplex_ms << " ms"
+                  << std::endl;
+    }
+    return ok;
+}
+
+// 固定の遅延は帯域と違い、同時に発行したsyncの間で重なる
+bool test_pcie_latency_overlaps() {
+    xrt::device device(0);
+    std::vector<xrt::bo> bos;
+    for (int i = 0; i < 4; ++i) {
+        bos.emplace_back(device, 4096, 0);
+    }
+    xrt_fake::latency().pcie_latency_us = 5000.0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (xrt::bo& bo : bos) {
+        threads.emplace_back([&bo] { bo.sync(XCL_BO_SYNC_BO_TO_DEVICE); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double ms = elapsed_ms(start);
+    xrt_fake::latency() = xrt_fake::latency_model();
+
+    bool ok = check(ms >= 5.0 && ms < 15.0, "latency is paid once per concurrent batch");
+    if (!ok) {
+        std::cerr << "4 syncs with 5ms latency took " << ms << " ms" << std::endl;
+    }
+    return ok;
+}
+
+// DDRの帯域: カーネルの実行時間は転送量 / 帯域より短くならない。転送量は登録時に差し替えられる。
+bool test_ddr_bandwidth() {
+    xrt::device device(0);
+    xrt::kernel kernel(device, device.load_xclbin("scale.xclbin"), "scale");
+    xrt::bo in(device, 4 * MB, 0);
+    xrt::bo out(device, 4 * MB, 1);
+    xrt_fake::latency().ddr_mb_s = 1000.0;
+
+    auto start = std::chrono::steady_clock::now();
+    kernel(in, out, 16, 1).wait();
+    double full_ms = elapsed_ms(start);
+
+    xrt_fake::register_kernel("scale", xrt_fake::bind_kernel(scale), [](const std::vector<xrt_fake::kernel_arg>& args) {
+        return 2 * static_cast<size_t>(args.at(2).scalar) * sizeof(int);
+    });
+    start = std::chrono::steady_clock::now();
+    kernel(in, out, 16, 1).wait();
+    double hooked_ms = elapsed_ms(start);
+    xrt_fake::latency() = xrt_fake::latency_model();
+
+    bool ok = true;
+    ok &= check(full_ms >= 8.0, "default traffic is the size of every bo argument");
+    ok &= check(hooked_ms < 4.0, "traffic hook replaces the default estimate");
+    if (!ok) {
+        std::cerr << "default " << full_ms << " ms, hooked " << hooked_ms << " ms" << std::endl;
+    }
+    return ok;
+}
+
+// カードごとにPCIeのリンクは別なので、別々のカードへのsyncは帯域を分け合わない
+bool test_devices_have_separate_links() {
+    xrt_fake::device_count() = 4;
+    bool ok = check(xrt::system::enumerate_devices() == 4, "enumerate_devices reports the fake cards");
+    std::vector<xrt::bo> bos;
+    for (unsigned int i = 0; i < 4; ++i) {
+        bos.emplace_back(xrt::device(i), 2 * MB, 0);
+    }
+    xrt_fake::latency().pcie_mb_s = 1000.0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (xrt::bo& bo : bos) {
+        threads.emplace_back([&bo] { bo.sync(XCL_BO_SYNC_BO_TO_DEVICE); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double ms = elapsed_ms(start);
+    xrt_fake::latency() = xrt_fake::latency_model();
+    xrt_fake::device_count() = 1;
+
+    ok &= check(ms >= 2.0 && ms < 6.0, "syncs to different cards run in parallel");
+    if (!ok) {
+        std::cerr << "4 cards x 2MB took " << ms << " ms" << std::endl;
+    }
+    return ok;
+}
+
+bool test_latency_from_env() {
+    setenv("XRT_FAKE_PCIE_MB_S", "12000", 1);
+    setenv("XRT_FAKE_DDR_MB_S", "19200.5", 1);
+    setenv("XRT_FAKE_KERNEL_US", "250", 1);
+    xrt_fake::latency_model m = xrt_fake::latency_from_env();
+    unsetenv("XRT_FAKE_PCIE_MB_S");
+    unsetenv("XRT_FAKE_DDR_MB_S");
+    unsetenv("XRT_FAKE_KERNEL_US");
+
+    bool ok = true;
+    ok &= check(m.pcie_mb_s == 12000.0, "XRT_FAKE_PCIE_MB_S");
+    ok &= check(m.ddr_mb_s == 19200.5, "XRT_FAKE_DDR_MB_S");
+    ok &= check(m.kernel == std::chrono::microseconds(250), "XRT_FAKE_KERNEL_US");
+    ok &= check(m.pcie_latency_us == 0.0 && m.sync_us_per_mib == 0.0, "unset variables stay 0");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    ok &= test_bind_kernel();
+    ok &= test_pcie_bandwidth_is_shared();
+    ok &= test_pcie_latency_overlaps();
+    ok &= test_ddr_bandwidth();
+    ok &= test_devices_have_separate_links();
+    ok &= test_latency_from_env();
+    if (!ok) {
+        std::cerr << "XRT fake tests FAILED" << std::endl;
+        return 1;
+    }
+    std::cout << "XRT fake tests PASSED" << std::endl;
+    return 0;
+}